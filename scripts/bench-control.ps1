@@ -0,0 +1,178 @@
+# Load generator for the control pipe (see ControlManager): measures request latency of a running GammaHotkey.
+# Start the app first, in advanced mode. It changes brightness on the selected display for a few seconds,
+# then restores it. Only advanced mode's working profile is changed, which is never saved: in simple mode
+# every "set" would rewrite the config, so the script refuses to run.
+#
+#   .\scripts\bench-control.ps1 -Exe ..\x64\Release\GammaHotkey.exe -Clients 4 -Requests 2000 -Depth 16
+#
+# Reports two latencies, each as p50/p99:
+#   ack    "set" sent pipelined (up to Depth in flight per client) until its "ok", i.e. handed to the
+#          apply workers. Also reports the total request rate.
+#   apply  "set" followed by "sync", one at a time, until the sync "ok": the ramp is on the display.
+
+param(
+    [string]$Exe = (Join-Path $PSScriptRoot "..\x64\Release\GammaHotkey.exe"),
+
+    [ValidateRange(1, 8)]
+    [int]$Clients = 4,
+
+    [ValidateRange(1, 1000000)]
+    [int]$Requests = 2000,
+
+    [ValidateRange(1, 256)]
+    [int]$Depth = 16
+)
+
+Add-Type -TypeDefinition @"
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.IO.Pipes;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+public sealed class ControlClient : IDisposable
+{
+    readonly NamedPipeClientStream pipe;
+    readonly StreamReader reader;
+    readonly StreamWriter writer;
+
+    public ControlClient(string name)
+    {
+        pipe = new NamedPipeClientStream(".", name, PipeDirection.InOut);
+        pipe.Connect(2000);
+        var utf8 = new UTF8Encoding(false);
+        reader = new StreamReader(pipe, utf8);
+        writer = new StreamWriter(pipe, utf8) { NewLine = "\n" };
+    }
+
+    public void Send(string line) { writer.WriteLine(line); }
+
+    public string Receive()
+    {
+        writer.Flush();
+        string reply = reader.ReadLine();
+        if (reply == null)
+            throw new IOException("The control pipe closed the connection.");
+        if (!reply.StartsWith("ok"))
+            throw new InvalidOperationException("Request failed: " + reply);
+        return reply;
+    }
+
+    public void Dispose() { pipe.Dispose(); }
+}
+
+public static class ControlBench
+{
+    static double Ms(long ticks) { return ticks * 1000.0 / Stopwatch.Frequency; }
+
+    // Brightness for request i: sweeps -20..20 so consecutive ramps differ.
+    static string SetRequest(int i) { return "set b=" + (i % 41 - 20); }
+
+    static double[] Pipelined(string name, int requests, int depth, int seed)
+    {
+        using (var client = new ControlClient(name))
+        {
+            var sent = new Queue<long>();
+            var latencies = new double[requests];
+            int next = 0;
+            for (int done = 0; done < requests; ++done)
+            {
+                while (next < requests && sent.Count < depth)
+                {
+                    client.Send(SetRequest(seed + next++));
+                    sent.Enqueue(Stopwatch.GetTimestamp());
+                }
+                client.Receive();
+                latencies[done] = Ms(Stopwatch.GetTimestamp() - sent.Dequeue());
+            }
+            return latencies;
+        }
+    }
+
+    static double[] Applied(string name, int requests, int seed)
+    {
+        using (var client = new ControlClient(name))
+        {
+            var latencies = new double[requests];
+            for (int i = 0; i < requests; ++i)
+            {
+                long start = Stopwatch.GetTimestamp();
+                client.Send(SetRequest(seed + i));
+                client.Send("sync");
+                client.Receive();
+                client.Receive();
+                latencies[i] = Ms(Stopwatch.GetTimestamp() - start);
+            }
+            return latencies;
+        }
+    }
+
+    // Run every client at once. Returns all latencies, sorted; seconds is the wall time.
+    public static double[] Run(string name, int clients, int requests, int depth, bool applied, out double seconds)
+    {
+        long start = Stopwatch.GetTimestamp();
+        var tasks = Enumerable.Range(0, clients).Select(c => Task.Run(() =>
+            applied ? Applied(name, requests, c * 7) : Pipelined(name, requests, depth, c * 7))).ToArray();
+        Task.WaitAll(tasks);
+        seconds = Ms(Stopwatch.GetTimestamp() - start) / 1000.0;
+
+        double[] all = tasks.SelectMany(t => t.Result).ToArray();
+        Array.Sort(all);
+        return all;
+    }
+
+    public static string Query(string name, string line)
+    {
+        using (var client = new ControlClient(name))
+        {
+            client.Send(line);
+            return client.Receive();
+        }
+    }
+}
+"@
+
+# Same name the app derives from its path (CommandLineManager::GetInstanceName), plus "_control".
+$path = (Resolve-Path $Exe).Path
+$pipe = "GammaHotkey_" + ($path -replace '[\\:/]', '_') + "_control"
+
+function Get-Percentile([double[]]$Sorted, [double]$P) {
+    $Sorted[[Math]::Min($Sorted.Length - 1, [int][Math]::Floor($Sorted.Length * $P))]
+}
+
+function Write-Latency([string]$Label, [double[]]$Sorted) {
+    "{0,-6} p50 {1,8:N3} ms   p99 {2,8:N3} ms   max {3,8:N3} ms" -f $Label,
+        (Get-Percentile $Sorted 0.50), (Get-Percentile $Sorted 0.99), $Sorted[-1]
+}
+
+try {
+    $before = [ControlBench]::Query($pipe, "get")
+} catch {
+    Write-Error "Could not reach the control pipe of $path. Is it running? $_"
+    exit 1
+}
+if ($before -notmatch ' mode=advanced ') {
+    Write-Error "The app is in simple mode, where ""set"" saves to the config. Switch it to advanced mode and run again."
+    exit 1
+}
+$enabled = $before -match ' on=1 '
+$restore = "set " + (($before -split ' ' | Where-Object { $_ -match '^[bcg]=' }) -join ' ')
+
+try {
+    $seconds = 0.0
+    $ack = [ControlBench]::Run($pipe, $Clients, $Requests, $Depth, $false, [ref]$seconds)
+    "{0} clients x {1} requests, depth {2}: {3:N0} requests/s" -f $Clients, $Requests, $Depth, ($ack.Length / $seconds)
+    Write-Latency "ack" $ack
+
+    $applyRequests = [Math]::Min($Requests, 500)
+    $apply = [ControlBench]::Run($pipe, $Clients, $applyRequests, 1, $true, [ref]$seconds)
+    Write-Latency "apply" $apply
+} finally {
+    [void][ControlBench]::Query($pipe, $restore)
+    if (-not $enabled) {
+        [void][ControlBench]::Query($pipe, "off")
+    }
+}
@@ -21,16 +21,27 @@ namespace App
     std::vector<Profile> profiles;
     Profile workingProfile;
     int selectedProfileIndex = -1;       
+    ProfileNameIndex profileNames(profiles);
     
     UINT toggleHotkey = 0;
     UINT nextProfileHotkey = 0;
     UINT previousProfileHotkey = 0;
+    UINT brightnessUpHotkey = 0;
+    UINT brightnessDownHotkey = 0;
+    UINT contrastUpHotkey = 0;
+    UINT contrastDownHotkey = 0;
+    UINT gammaUpHotkey = 0;
+    UINT gammaDownHotkey = 0;
     
     bool loopProfiles = false;
     bool startMinimized = false;
     bool minimizeToTray = true; // Default on, the most common use-case.
     bool launchOnStartup = false;
     bool applyProfileOnLaunch = false;
+    int transitionMs = TransitionRange::MS_DEFAULT;
+    bool durableSave = false;
+    bool journalSave = false;
+    int releaseUIAfterSec = UIReleaseRange::SEC_DEFAULT;
 
     Profile simpleProfile;
         
@@ -6,6 +6,7 @@
 
 #include "GammaHotkeyTypes.h"
 #include "AppState.h"
+#include "ProfileNameIndex.h"
 #include <vector>
 
 namespace App
@@ -24,11 +25,18 @@ namespace App
     extern std::vector<Profile> profiles;
     extern Profile workingProfile; // Current working profile, may have unsaved changes, etc.
     extern int selectedProfileIndex; // Which profile is selected (-1 = none selected, persists when gamma toggled).
+    extern ProfileNameIndex profileNames; // Name lookup into profiles; see ProfileManager for keeping it current.
     
     // Global hotkeys.
     extern UINT toggleHotkey;
     extern UINT nextProfileHotkey;
     extern UINT previousProfileHotkey;
+    extern UINT brightnessUpHotkey; // Step hotkeys: nudge the active profile while held.
+    extern UINT brightnessDownHotkey;
+    extern UINT contrastUpHotkey;
+    extern UINT contrastDownHotkey;
+    extern UINT gammaUpHotkey;
+    extern UINT gammaDownHotkey;
     
     // Application Settings.
     extern bool loopProfiles;
@@ -36,6 +44,10 @@ namespace App
     extern bool minimizeToTray;
     extern bool launchOnStartup;
     extern bool applyProfileOnLaunch;
+    extern int transitionMs; // Fade length for profile switches (hotkeys, cycling), 0 = instant.
+    extern bool durableSave; // Flush the config to disk before replacing the old file (slower, survives power loss).
+    extern bool journalSave; // Append changes to a journal beside the config instead of rewriting it (for huge profile lists).
+    extern int releaseUIAfterSec; // Free the renderer once the window has been hidden this long, 0 = never.
 
     // Simple mode profile.
     extern Profile simpleProfile;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "GammaHotkeyTypes.h"
+#include <atomic>
 
 class AppState
 {
@@ -45,8 +46,10 @@ public:
      */
     bool IsAdvancedModeEnabled() const { return m_advancedModeEnabled; }
 
-    bool gammaRampFailed = false;
+    // Written by the gamma apply workers, read by the UI; lastRamp is only ever written on the UI thread.
+    std::atomic<bool> gammaRampFailed = false;
     float lastRamp[GammaConstants::RAMP_SIZE] = {};
+    bool gammaRampClamped = false; // Last profile apply was clamped to what the display accepts; UI thread only.
 
 private:
     bool m_configInitialized = false;
@@ -0,0 +1,37 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ApplyOutcome.h"
+
+bool ApplyOutcome::Reset(const size_t displayCount)
+{
+    m_displayFailed.assign(displayCount, 0);
+    m_displayTargeted.assign(displayCount, 0);
+    return Update();
+}
+
+bool ApplyOutcome::SetTargets(const int first, const int last)
+{
+    for (int index = 0; index < (int)m_displayTargeted.size(); ++index)
+        m_displayTargeted[index] = (index >= first && index <= last);
+    return Update();
+}
+
+bool ApplyOutcome::Report(const int displayIndex, const bool success)
+{
+    if (displayIndex < 0 || displayIndex >= (int)m_displayFailed.size())
+        return false;
+
+    m_displayFailed[displayIndex] = !success;
+    return Update();
+}
+
+bool ApplyOutcome::Update()
+{
+    bool failed = false;
+    for (size_t index = 0; index < m_displayFailed.size(); ++index)
+        failed = failed || (m_displayTargeted[index] && m_displayFailed[index]);
+
+    const bool changed = failed != m_failed;
+    m_failed = failed;
+    return changed;
+}
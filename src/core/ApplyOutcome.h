@@ -0,0 +1,56 @@
+// Copyright (c) 2025 Max Godman
+
+// Whether the latest gamma apply failed on any display it targeted, and when that answer changes.
+
+/**
+ * An apply targets one display or all of them, and each display's worker reports back on its own
+ * thread, whenever the driver answers. The warning the window shows (App::state.gammaRampFailed) is
+ * "any targeted display failed its last write": a failure on a display the latest apply did not
+ * target is stale and does not count.
+ *
+ * Every call returns whether that answer changed, so the caller can tell the window to redraw: a
+ * worker's report arrives after the apply's own redraw, and an idle window draws nothing on its own
+ * (see RedrawPolicy).
+ *
+ * Not thread-safe; GammaManager holds a lock around every call. Portable (no <windows.h>).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class ApplyOutcome
+{
+public:
+    /**
+     * @brief Forget every result and target, for displayCount displays.
+     * @return true if Failed() changed.
+     */
+    bool Reset(const size_t displayCount);
+
+    /**
+     * @brief An apply to displays first..last (inclusive) began; only their results count from now on.
+     * @return true if Failed() changed.
+     */
+    bool SetTargets(const int first, const int last);
+
+    /**
+     * @brief A display's worker wrote (success) or failed to write its ramp.
+     * @return true if Failed() changed.
+     */
+    bool Report(const int displayIndex, const bool success);
+
+    /**
+     * @brief Whether any targeted display failed its last write.
+     */
+    bool Failed() const { return m_failed; }
+
+private:
+    // Recompute m_failed; true if it changed.
+    bool Update();
+
+    std::vector<char> m_displayFailed;
+    std::vector<char> m_displayTargeted;
+    bool m_failed = false;
+};
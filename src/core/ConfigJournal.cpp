@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ConfigJournal.h"
+#include "ConfigWriter.h"
+#include <charconv>
+#include <system_error>
+
+namespace ConfigJournal
+{
+    static constexpr std::string_view HEADER_TAG = "GammaHotkeyJournal 1 ";
+    static constexpr char RECORD_TAG = '#';
+
+    static void AppendNumber(std::string& out, const uint64_t value, const int base)
+    {
+        char digits[24];
+        const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value, base);
+        out.append(digits, result.ptr);
+    }
+
+    // Split off one CRLF-terminated line; false if there is no complete line.
+    static bool TakeLine(std::string_view& text, std::string_view& line)
+    {
+        const size_t end = text.find(ConfigWriter::NEWLINE);
+        if (end == std::string_view::npos)
+            return false;
+        line = text.substr(0, end);
+        text.remove_prefix(end + ConfigWriter::NEWLINE.size());
+        return true;
+    }
+
+    // "<decimal> <hex>", both fields required and nothing else on the line.
+    static bool ParseSizeAndHash(const std::string_view text, uint64_t& size, uint64_t& hash)
+    {
+        const char* const end = text.data() + text.size();
+        const std::from_chars_result sizeResult = std::from_chars(text.data(), end, size);
+        if (sizeResult.ec != std::errc() || sizeResult.ptr == end || *sizeResult.ptr != ' ')
+            return false;
+        const std::from_chars_result hashResult = std::from_chars(sizeResult.ptr + 1, end, hash, 16);
+        return hashResult.ec == std::errc() && hashResult.ptr == end;
+    }
+
+    void WriteHeader(std::string& out, const uint64_t baseHash, const uint64_t baseSize)
+    {
+        out += HEADER_TAG;
+        AppendNumber(out, baseHash, 16);
+        out += ' ';
+        AppendNumber(out, baseSize, 10);
+        out += ConfigWriter::NEWLINE;
+    }
+
+    void WriteRecord(std::string& out, const std::string_view body)
+    {
+        out += RECORD_TAG;
+        AppendNumber(out, body.size(), 10);
+        out += ' ';
+        AppendNumber(out, HashConfigBytes(body), 16);
+        out += ConfigWriter::NEWLINE;
+        out += body;
+    }
+
+    bool ReadHeader(std::string_view& text, uint64_t& baseHash, uint64_t& baseSize)
+    {
+        std::string_view rest = text;
+        std::string_view line;
+        if (!TakeLine(rest, line) || line.substr(0, HEADER_TAG.size()) != HEADER_TAG)
+            return false;
+
+        // Stored as "<hex hash> <decimal size>", the reverse of a record line.
+        const std::string_view fields = line.substr(HEADER_TAG.size());
+        const size_t space = fields.find(' ');
+        if (space == std::string_view::npos)
+            return false;
+
+        const char* const hashEnd = fields.data() + space;
+        const std::from_chars_result hashResult = std::from_chars(fields.data(), hashEnd, baseHash, 16);
+        const char* const sizeEnd = fields.data() + fields.size();
+        const std::from_chars_result sizeResult = std::from_chars(hashEnd + 1, sizeEnd, baseSize);
+        if (hashResult.ec != std::errc() || hashResult.ptr != hashEnd ||
+            sizeResult.ec != std::errc() || sizeResult.ptr != sizeEnd)
+        {
+            return false;
+        }
+
+        text = rest;
+        return true;
+    }
+
+    bool ReadRecord(std::string_view& text, std::string_view& body)
+    {
+        std::string_view rest = text;
+        std::string_view line;
+        if (!TakeLine(rest, line) || line.empty() || line.front() != RECORD_TAG)
+            return false;
+
+        uint64_t size = 0;
+        uint64_t hash = 0;
+        if (!ParseSizeAndHash(line.substr(1), size, hash) || size > rest.size())
+            return false;
+
+        const std::string_view candidate = rest.substr(0, (size_t)size);
+        if (HashConfigBytes(candidate) != hash)
+            return false;
+
+        body = candidate;
+        text = rest.substr((size_t)size);
+        return true;
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2025 Max Godman
+
+// Framing for the append-only config journal that sits beside the ini.
+
+/**
+ * In journal mode a settings change appends a small record to "<config>.journal" instead of rewriting
+ * the whole ini. Load reads the ini, then replays the journal on top of it; once the journal grows past
+ * a threshold (or on exit) a full save folds it back into the ini and deletes it.
+ *
+ * FORMAT:
+ * A header line binds the journal to one exact ini, by the content hash and size of the file it was
+ * started on. A journal whose header does not match the ini next to it is stale (left by a crash
+ * between writing a compacted ini and deleting the journal) and is ignored. Then come records, each a
+ * "#<size> <hash>" line followed by a body of exactly <size> bytes in ini syntax, which ConfigParser
+ * reads like any other config text:
+ *
+ *   GammaHotkeyJournal 1 9c0f3e1d2a7b6c45 2736
+ *   #41 5e2d...
+ *   [GlobalHotkeys]
+ *   TransitionMs=300
+ *
+ * CRASH CONSISTENCY:
+ * One record holds everything one save changed, and counts only if it is complete and its hash
+ * matches. A journal cut off at any byte therefore replays as some prefix of whole records, never as
+ * part of one; reading stops at the first record that fails, and everything after it is reported as
+ * a torn tail for the next save to compact away.
+ *
+ * Portable (no <windows.h>). What a record body says is up to ConfigManager.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ConfigJournal
+{
+    /**
+     * @brief What Read found.
+     */
+    struct ReadResult
+    {
+        bool matched = false; // The header is intact and names this ini; nothing is replayed otherwise.
+        int records = 0;      // Whole records passed to the callback.
+        size_t validSize = 0; // Bytes up to the end of the last whole record (0 if unmatched).
+        bool torn = false;    // Bytes follow the last whole record (a write cut short).
+    };
+
+    /**
+     * @brief Append the header for a journal on top of an ini with this content hash and size.
+     */
+    void WriteHeader(std::string& out, const uint64_t baseHash, const uint64_t baseSize);
+
+    /**
+     * @brief Append one record framing the given body.
+     */
+    void WriteRecord(std::string& out, const std::string_view body);
+
+    /**
+     * @brief Consume the header line from the front of text.
+     * @return false if it is missing, incomplete or malformed.
+     */
+    bool ReadHeader(std::string_view& text, uint64_t& baseHash, uint64_t& baseSize);
+
+    /**
+     * @brief Consume one record from the front of text.
+     * @return false, leaving text untouched, if the next record is incomplete or fails its hash.
+     */
+    bool ReadRecord(std::string_view& text, std::string_view& body);
+
+    /**
+     * @brief Walk a journal, passing the body of each whole record to callback(std::string_view).
+     * @param[in] journal The journal file contents. Bodies are views into it.
+     * @param[in] baseHash, baseSize Content hash (HashConfigBytes) and size of the ini it must apply to.
+     */
+    template <typename Callback>
+    ReadResult Read(std::string_view journal, const uint64_t baseHash, const uint64_t baseSize, Callback&& callback)
+    {
+        ReadResult result;
+        const size_t totalSize = journal.size();
+
+        uint64_t hash = 0;
+        uint64_t size = 0;
+        if (!ReadHeader(journal, hash, size) || hash != baseHash || size != baseSize)
+            return result;
+
+        result.matched = true;
+        std::string_view body;
+        while (ReadRecord(journal, body))
+        {
+            callback(body);
+            ++result.records;
+        }
+
+        result.validSize = totalSize - journal.size();
+        result.torn = !journal.empty();
+        return result;
+    }
+}
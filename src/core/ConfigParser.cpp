@@ -0,0 +1,195 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ConfigParser.h"
+#include <array>
+#include <charconv>
+#include <system_error>
+
+namespace ConfigParser
+{
+    // PERFECT HASH:
+    // Each name table below is laid out at compile time into a power-of-two slot array, indexed by an
+    // ASCII-case-folded FNV-1a hash whose offset basis (the seed) is searched, also at compile time,
+    // until every name lands in its own slot. A lookup hashes the candidate once, reads one slot and
+    // confirms with one case-insensitive compare, so unknown names cost the same as known ones.
+
+    template <typename Id>
+    struct NameEntry
+    {
+        std::string_view name;
+        Id id;
+    };
+
+    static constexpr NameEntry<Section> SECTION_NAMES[] = {
+        { "GlobalHotkeys", Section::GlobalHotkeys },
+        { "SimpleProfile", Section::SimpleProfile },
+        { "Profile", Section::Profile },
+    };
+
+    static constexpr NameEntry<Key> KEY_NAMES[] = {
+        { "Name", Key::Name },
+        { "Brightness", Key::Brightness },
+        { "Contrast", Key::Contrast },
+        { "Gamma", Key::Gamma },
+        { "Hotkey", Key::Hotkey },
+        { "ToggleHotkey", Key::ToggleHotkey },
+        { "NextProfileHotkey", Key::NextProfileHotkey },
+        { "PreviousProfileHotkey", Key::PreviousProfileHotkey },
+        { "BrightnessUpHotkey", Key::BrightnessUpHotkey },
+        { "BrightnessDownHotkey", Key::BrightnessDownHotkey },
+        { "ContrastUpHotkey", Key::ContrastUpHotkey },
+        { "ContrastDownHotkey", Key::ContrastDownHotkey },
+        { "GammaUpHotkey", Key::GammaUpHotkey },
+        { "GammaDownHotkey", Key::GammaDownHotkey },
+        { "LoopProfiles", Key::LoopProfiles },
+        { "StartMinimized", Key::StartMinimized },
+        { "MinimizeToTray", Key::MinimizeToTray },
+        { "LaunchOnStartup", Key::LaunchOnStartup },
+        { "SelectedDisplay", Key::SelectedDisplay },
+        { "ApplyProfileOnLaunch", Key::ApplyProfileOnLaunch },
+        { "SelectedProfileIndex", Key::SelectedProfileIndex },
+        { "AdvancedMode", Key::AdvancedMode },
+        { "TransitionMs", Key::TransitionMs },
+        { "DurableSave", Key::DurableSave },
+        { "JournalSave", Key::JournalSave },
+        { "ReleaseUIAfterSec", Key::ReleaseUIAfterSec },
+        { "Index", Key::Index },
+        { "InsertAt", Key::InsertAt },
+        { "RemoveAt", Key::RemoveAt },
+    };
+
+    static constexpr char FoldCase(const char ch)
+    {
+        return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch;
+    }
+
+    static constexpr uint32_t HashName(const std::string_view name, const uint32_t seed)
+    {
+        uint32_t hash = seed;
+        for (const char ch : name)
+        {
+            hash ^= (uint8_t)FoldCase(ch);
+            hash *= 16777619u;
+        }
+        // FNV's low bits only depend on the seed's low bits; fold the high half down so the slot
+        // index (taken from the low bits) sees all of it.
+        return hash ^ (hash >> 16);
+    }
+
+    static constexpr bool NamesEqual(const std::string_view a, const std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (FoldCase(a[i]) != FoldCase(b[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Slots hold an index into the name table plus one; 0 is an empty slot.
+    template <typename Id, size_t Count, size_t Slots>
+    struct PerfectHashTable
+    {
+        static_assert((Slots & (Slots - 1)) == 0, "Slot count must be a power of two.");
+
+        uint32_t seed = 0;
+        std::array<uint8_t, Slots> slots = {};
+
+        constexpr explicit PerfectHashTable(const NameEntry<Id> (&names)[Count])
+        {
+            for (uint32_t candidate = 2166136261u; ; ++candidate)
+            {
+                std::array<uint8_t, Slots> trial = {};
+                bool collision = false;
+                for (size_t index = 0; index < Count && !collision; ++index)
+                {
+                    uint8_t& slot = trial[HashName(names[index].name, candidate) & (Slots - 1)];
+                    collision = (slot != 0);
+                    slot = (uint8_t)(index + 1);
+                }
+
+                if (!collision)
+                {
+                    seed = candidate;
+                    slots = trial;
+                    return;
+                }
+            }
+        }
+
+        constexpr Id Find(const NameEntry<Id> (&names)[Count], const std::string_view name, const Id notFound) const
+        {
+            const uint8_t slot = slots[HashName(name, seed) & (Slots - 1)];
+            if (slot == 0 || !NamesEqual(names[slot - 1].name, name))
+                return notFound;
+            return names[slot - 1].id;
+        }
+    };
+
+    static constexpr PerfectHashTable<Section, std::size(SECTION_NAMES), 8> SECTION_TABLE(SECTION_NAMES);
+    static constexpr PerfectHashTable<Key, std::size(KEY_NAMES), 128> KEY_TABLE(KEY_NAMES);
+
+    static_assert(SECTION_TABLE.Find(SECTION_NAMES, "profile", Section::None) == Section::Profile);
+    static_assert(KEY_TABLE.Find(KEY_NAMES, "transitionMS", Key::Unknown) == Key::TransitionMs);
+    static_assert(KEY_TABLE.Find(KEY_NAMES, "Transition", Key::Unknown) == Key::Unknown);
+
+    Section LookupSection(const std::string_view name)
+    {
+        return SECTION_TABLE.Find(SECTION_NAMES, name, Section::None);
+    }
+
+    Key LookupKey(const std::string_view name)
+    {
+        return KEY_TABLE.Find(KEY_NAMES, name, Key::Unknown);
+    }
+
+    std::string_view GetSectionName(const Section section)
+    {
+        for (const NameEntry<Section>& entry : SECTION_NAMES)
+        {
+            if (entry.id == section)
+                return entry.name;
+        }
+        return {};
+    }
+
+    std::string_view GetKeyName(const Key key)
+    {
+        for (const NameEntry<Key>& entry : KEY_NAMES)
+        {
+            if (entry.id == key)
+                return entry.name;
+        }
+        return {};
+    }
+
+    // std::from_chars rejects a leading '+', which std::stoi/stof accepted.
+    static std::string_view SkipPlus(const std::string_view text)
+    {
+        return (text.size() >= 2 && text[0] == '+' && text[1] != '-') ? text.substr(1) : text;
+    }
+
+    bool ParseInt(const std::string_view text, int& out)
+    {
+        const std::string_view digits = SkipPlus(text);
+        int value = 0;
+        const std::from_chars_result result = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (result.ec != std::errc())
+            return false;
+        out = value;
+        return true;
+    }
+
+    bool ParseFloat(const std::string_view text, float& out)
+    {
+        const std::string_view digits = SkipPlus(text);
+        float value = 0.0f;
+        const std::from_chars_result result = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (result.ec != std::errc())
+            return false;
+        out = value;
+        return true;
+    }
+}
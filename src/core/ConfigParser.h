@@ -0,0 +1,201 @@
+// Copyright (c) 2025 Max Godman
+
+// Single-pass, zero-copy tokenizer for the GammaHotkey ini format.
+
+/**
+ * ConfigManager::Load used to read line by line, widen every line to UTF-16, and copy it again in Trim
+ * and substr before parsing numbers with the throwing std::stoi/stof. With thousands of profiles that
+ * was most of the startup cost. This tokenizer works on the raw UTF-8 bytes of the whole file instead:
+ * every section, key and value it reports is a std::string_view into the caller's buffer, so nothing is
+ * allocated or converted until the caller decides it needs a value (in practice, profile names only).
+ *
+ * FORMAT:
+ * Exactly what the old line parser accepted. Lines end in LF or CRLF; leading and trailing spaces,
+ * tabs and CRs are trimmed; empty lines and lines starting with ';' or '#' are comments; "[Name]" opens
+ * a section; anything else needs a '=' and becomes a key/value pair. Section and key names match
+ * ASCII case-insensitively. A UTF-8 byte-order mark at the start of the buffer is skipped.
+ *
+ * KEYS:
+ * Names resolve through a perfect hash table built at compile time (see ConfigParser.cpp), so a lookup
+ * is one hash, one table read and one compare. Keys this build does not know resolve to Key::Unknown
+ * and are skipped, as are key/value pairs outside any known section.
+ *
+ * Portable (no <windows.h>), so it can be measured on its own.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ConfigParser
+{
+    /**
+     * @brief Config file sections.
+     */
+    enum class Section : uint8_t
+    {
+        None, // Before the first section, or an unknown one.
+        GlobalHotkeys,
+        SimpleProfile,
+        Profile,
+    };
+
+    /**
+     * @brief Every key the config file knows, across all sections.
+     */
+    enum class Key : uint8_t
+    {
+        Unknown,
+
+        // Profile fields ([Profile] and, except Name and Hotkey, [SimpleProfile]).
+        Name,
+        Brightness,
+        Contrast,
+        Gamma,
+        Hotkey,
+
+        // Global settings ([GlobalHotkeys]).
+        ToggleHotkey,
+        NextProfileHotkey,
+        PreviousProfileHotkey,
+        BrightnessUpHotkey,
+        BrightnessDownHotkey,
+        ContrastUpHotkey,
+        ContrastDownHotkey,
+        GammaUpHotkey,
+        GammaDownHotkey,
+        LoopProfiles,
+        StartMinimized,
+        MinimizeToTray,
+        LaunchOnStartup,
+        SelectedDisplay,
+        ApplyProfileOnLaunch,
+        SelectedProfileIndex,
+        AdvancedMode,
+        TransitionMs,
+        DurableSave,
+        JournalSave,
+        ReleaseUIAfterSec,
+
+        // Journal records only ([Profile] in a record body, ahead of the profile's fields): which
+        // profile the fields belong to, or a profile to insert or remove. See ConfigJournal.
+        Index,
+        InsertAt,
+        RemoveAt,
+    };
+
+    /**
+     * @brief One meaningful line of the file.
+     */
+    struct Entry
+    {
+        Section section = Section::None; // The section the line opens, or belongs to.
+        Key key = Key::Unknown;          // Key::Unknown for a section header.
+        std::string_view value;          // Trimmed UTF-8 value, pointing into the parsed buffer.
+
+        bool IsSectionHeader() const { return key == Key::Unknown; }
+    };
+
+    /**
+     * @brief Resolve a section name, case-insensitively.
+     * @return Section::None if the name is not a known section.
+     */
+    Section LookupSection(const std::string_view name);
+
+    /**
+     * @brief Resolve a key name, case-insensitively.
+     * @return Key::Unknown if the name is not a known key.
+     */
+    Key LookupKey(const std::string_view name);
+
+    /**
+     * @brief The canonical spelling of a section, as written to the file (e.g. "GlobalHotkeys").
+     */
+    std::string_view GetSectionName(const Section section);
+
+    /**
+     * @brief The canonical spelling of a key, as written to the file (e.g. "ToggleHotkey").
+     */
+    std::string_view GetKeyName(const Key key);
+
+    /**
+     * @brief Parse a leading integer, like std::stoi (optional sign, trailing characters ignored).
+     * @return false (leaving out untouched) if there is no number or it does not fit an int.
+     */
+    bool ParseInt(const std::string_view text, int& out);
+
+    /**
+     * @brief Parse a leading float, like std::stof (optional sign, trailing characters ignored).
+     * @return false (leaving out untouched) if there is no number or it does not fit a float.
+     */
+    bool ParseFloat(const std::string_view text, float& out);
+
+    /**
+     * @brief Walk the whole buffer once, reporting every section header and known key/value pair.
+     * @param[in] text The file contents. Must outlive the callback, which receives views into it.
+     * @param[in] callback Called as callback(const Entry&) in file order. Headers of unknown sections
+     *            are reported too (as Section::None) so callers can close the previous section.
+     */
+    template <typename Callback>
+    void Parse(std::string_view text, Callback&& callback);
+
+    namespace Detail
+    {
+        // Spaces, tabs, CRs and LFs, as StringUtils::Trim.
+        inline bool IsSpace(const char ch)
+        {
+            return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+        }
+
+        inline std::string_view Trim(std::string_view text)
+        {
+            while (!text.empty() && IsSpace(text.front()))
+                text.remove_prefix(1);
+            while (!text.empty() && IsSpace(text.back()))
+                text.remove_suffix(1);
+            return text;
+        }
+    }
+
+    template <typename Callback>
+    void Parse(std::string_view text, Callback&& callback)
+    {
+        if (text.size() >= 3 && (unsigned char)text[0] == 0xEF && (unsigned char)text[1] == 0xBB &&
+            (unsigned char)text[2] == 0xBF)
+        {
+            text.remove_prefix(3);
+        }
+
+        Section section = Section::None;
+        while (!text.empty())
+        {
+            const size_t end = text.find('\n');
+            const std::string_view line = Detail::Trim(text.substr(0, end));
+            text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+            if (line.empty() || line.front() == ';' || line.front() == '#')
+                continue;
+
+            if (line.front() == '[' && line.back() == ']')
+            {
+                section = LookupSection(Detail::Trim(line.substr(1, line.size() - 2)));
+                Entry header;
+                header.section = section;
+                callback(header);
+                continue;
+            }
+
+            const size_t eq = line.find('=');
+            if (eq == std::string_view::npos || section == Section::None)
+                continue;
+
+            Entry entry;
+            entry.section = section;
+            entry.key = LookupKey(Detail::Trim(line.substr(0, eq)));
+            entry.value = Detail::Trim(line.substr(eq + 1));
+            if (entry.key != Key::Unknown)
+                callback(entry);
+        }
+    }
+}
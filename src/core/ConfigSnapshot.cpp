@@ -0,0 +1,175 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ConfigSnapshot.h"
+#include "ConfigWriter.h"
+#include <cstring>
+
+namespace ConfigSnapshot
+{
+    static constexpr char MAGIC[4] = { 'G', 'H', 'K', 'S' };
+
+    void Builder::AddGlobal(const ConfigParser::Key key, const int32_t value)
+    {
+        m_globals.push_back({ (uint32_t)key, value });
+    }
+
+    void Builder::SetSimpleProfile(const uint32_t fields, const int32_t brightness, const float contrast, const float gamma)
+    {
+        m_header.simpleFields = fields;
+        m_header.simpleBrightness = brightness;
+        m_header.simpleContrast = contrast;
+        m_header.simpleGamma = gamma;
+    }
+
+    void Builder::AddProfile(const std::wstring_view name, const int32_t brightness, const float contrast,
+                             const float gamma, const uint32_t hotkey)
+    {
+        ProfileRecord record;
+        record.nameOffset = (uint32_t)m_names.size();
+        record.brightness = brightness;
+        record.contrast = contrast;
+        record.gamma = gamma;
+        record.hotkey = hotkey;
+
+        // Names are stored as UTF-16 whatever the width of wchar_t, so the file reads the same everywhere.
+        for (const wchar_t ch : name)
+        {
+            const uint32_t codePoint = (uint32_t)ch;
+            if (codePoint > 0xFFFF)
+            {
+                m_names.push_back((uint16_t)(0xD800 + ((codePoint - 0x10000) >> 10)));
+                m_names.push_back((uint16_t)(0xDC00 + ((codePoint - 0x10000) & 0x3FF)));
+            }
+            else
+            {
+                m_names.push_back((uint16_t)codePoint);
+            }
+        }
+
+        record.nameLength = (uint32_t)m_names.size() - record.nameOffset;
+        m_profiles.push_back(record);
+    }
+
+    void Builder::Finish(const IniStamp& ini, std::string& out) const
+    {
+        Header header = m_header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.iniSize = ini.size;
+        header.iniWriteTime = ini.writeTime;
+        header.iniHash = ini.hash;
+        header.globalCount = (uint32_t)m_globals.size();
+        header.profileCount = (uint32_t)m_profiles.size();
+        header.nameUnits = (uint32_t)m_names.size();
+
+        const size_t globalBytes = m_globals.size() * sizeof(GlobalRecord);
+        const size_t profileBytes = m_profiles.size() * sizeof(ProfileRecord);
+        const size_t nameBytes = m_names.size() * sizeof(uint16_t);
+
+        out.resize(sizeof(Header) + globalBytes + profileBytes + nameBytes);
+        char* cursor = out.data() + sizeof(Header);
+        if (globalBytes)
+            std::memcpy(cursor, m_globals.data(), globalBytes);
+        cursor += globalBytes;
+        if (profileBytes)
+            std::memcpy(cursor, m_profiles.data(), profileBytes);
+        cursor += profileBytes;
+        if (nameBytes)
+            std::memcpy(cursor, m_names.data(), nameBytes);
+
+        header.fileHash = 0;
+        std::memcpy(out.data(), &header, sizeof(Header));
+        header.fileHash = HashConfigBytes(out);
+        std::memcpy(out.data(), &header, sizeof(Header));
+    }
+
+    bool View::Open(const void* data, const size_t size, const IniStamp& ini)
+    {
+        if (!data || size < sizeof(Header))
+            return false;
+
+        const unsigned char* const bytes = (const unsigned char*)data;
+        std::memcpy(&m_header, bytes, sizeof(Header));
+        if (std::memcmp(m_header.magic, MAGIC, sizeof(MAGIC)) != 0 || m_header.version != VERSION ||
+            m_header.iniSize != ini.size || m_header.iniWriteTime != ini.writeTime || m_header.iniHash != ini.hash)
+        {
+            return false;
+        }
+
+        // Counts are 32-bit, so none of these products can overflow a 64-bit size.
+        const uint64_t globalBytes = (uint64_t)m_header.globalCount * sizeof(GlobalRecord);
+        const uint64_t profileBytes = (uint64_t)m_header.profileCount * sizeof(ProfileRecord);
+        const uint64_t nameBytes = (uint64_t)m_header.nameUnits * sizeof(uint16_t);
+        if (sizeof(Header) + globalBytes + profileBytes + nameBytes != size)
+            return false;
+
+        // The header as it was hashed, then the rest in place.
+        Header hashed = m_header;
+        hashed.fileHash = 0;
+        const uint64_t headerHash = HashConfigBytes(std::string_view((const char*)&hashed, sizeof(Header)));
+        const std::string_view payload((const char*)bytes + sizeof(Header), size - sizeof(Header));
+        if (HashConfigBytes(payload, headerHash) != m_header.fileHash)
+            return false;
+
+        m_globals = bytes + sizeof(Header);
+        m_profiles = m_globals + globalBytes;
+        m_names = m_profiles + profileBytes;
+
+        for (uint32_t index = 0; index < m_header.profileCount; ++index)
+        {
+            const ProfileRecord profile = GetProfile(index);
+            if ((uint64_t)profile.nameOffset + profile.nameLength > m_header.nameUnits)
+                return false;
+        }
+        return true;
+    }
+
+    GlobalRecord View::GetGlobal(const uint32_t index) const
+    {
+        GlobalRecord record;
+        std::memcpy(&record, m_globals + (size_t)index * sizeof(GlobalRecord), sizeof(record));
+        return record;
+    }
+
+    ProfileRecord View::GetProfile(const uint32_t index) const
+    {
+        ProfileRecord record;
+        std::memcpy(&record, m_profiles + (size_t)index * sizeof(ProfileRecord), sizeof(record));
+        return record;
+    }
+
+    void View::AppendName(const ProfileRecord& profile, std::wstring& out) const
+    {
+        const unsigned char* const name = m_names + (size_t)profile.nameOffset * sizeof(uint16_t);
+
+        if constexpr (sizeof(wchar_t) == sizeof(uint16_t))
+        {
+            // Windows: the pool already is wchar_t text.
+            const size_t start = out.size();
+            out.resize(start + profile.nameLength);
+            std::memcpy(out.data() + start, name, profile.nameLength * sizeof(uint16_t));
+        }
+        else
+        {
+            for (uint32_t index = 0; index < profile.nameLength; ++index)
+            {
+                uint16_t unit;
+                std::memcpy(&unit, name + (size_t)index * sizeof(uint16_t), sizeof(unit));
+
+                uint16_t next = 0;
+                if (unit >= 0xD800 && unit <= 0xDBFF && index + 1 < profile.nameLength)
+                    std::memcpy(&next, name + (size_t)(index + 1) * sizeof(uint16_t), sizeof(next));
+
+                if (next >= 0xDC00 && next <= 0xDFFF)
+                {
+                    out += (wchar_t)(0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00));
+                    ++index;
+                }
+                else
+                {
+                    out += (wchar_t)unit;
+                }
+            }
+        }
+    }
+}
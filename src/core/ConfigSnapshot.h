@@ -0,0 +1,142 @@
+// Copyright (c) 2025 Max Godman
+
+// Versioned binary image of a parsed config file, written beside the ini for fast cold starts.
+
+/**
+ * Load sits on the login-time critical path, and with thousands of profiles most of it is text
+ * parsing. After every full write of the ini, the saver also writes "<config>.snapshot": the result of
+ * parsing those exact bytes, laid out so Load can memory-map it and copy the values straight out.
+ *
+ * LAYOUT (little-endian, every field naturally aligned):
+ *   Header          magic, version, the ini it describes, payload hash, counts, the simple profile
+ *   GlobalRecord[]  the [GlobalHotkeys] values in file order, already parsed to integers
+ *   ProfileRecord[] the [Profile] sections that survived parsing (named, unique, clamped)
+ *   uint16_t[]      string pool of UTF-16 profile names, referenced by offset and length
+ *
+ * VALIDATION:
+ * A snapshot is only used if it matches the ini next to it exactly: size, modification time and content
+ * hash, as ConfigManager records them. Its own bytes must also pass a hash of the whole file, header
+ * included, and every count and name reference must lie inside the file. Anything else (an older version, a hand-edited ini, a torn
+ * write) fails Open, and Load parses the ini as before.
+ *
+ * Portable (no <windows.h>): mapping the file is up to the caller.
+ */
+
+#pragma once
+
+#include "ConfigParser.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ConfigSnapshot
+{
+    // Bump whenever the layout or the meaning of a field changes; other versions never validate.
+    constexpr uint32_t VERSION = 4;
+
+    // Bits of Header::simpleFields: which [SimpleProfile] values the ini set.
+    constexpr uint32_t SIMPLE_BRIGHTNESS = 1u << 0;
+    constexpr uint32_t SIMPLE_CONTRAST = 1u << 1;
+    constexpr uint32_t SIMPLE_GAMMA = 1u << 2;
+
+    /**
+     * @brief The ini a snapshot was built from.
+     */
+    struct IniStamp
+    {
+        uint64_t size = 0;
+        int64_t writeTime = 0; // File time in the filesystem clock's native ticks.
+        uint64_t hash = 0;     // HashConfigBytes of the contents.
+    };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t iniSize;
+        int64_t iniWriteTime;
+        uint64_t iniHash;
+        uint64_t fileHash;    // HashConfigBytes of the whole file, with this field zeroed.
+        uint32_t globalCount;
+        uint32_t profileCount;
+        uint32_t nameUnits;   // Length of the string pool, in UTF-16 code units.
+        uint32_t simpleFields;
+        int32_t simpleBrightness;
+        float simpleContrast;
+        float simpleGamma;
+        uint32_t reserved;
+    };
+
+    struct GlobalRecord
+    {
+        uint32_t key;         // A ConfigParser::Key.
+        int32_t value;
+    };
+
+    struct ProfileRecord
+    {
+        uint32_t nameOffset;  // Into the string pool, in code units.
+        uint32_t nameLength;
+        int32_t brightness;
+        float contrast;
+        float gamma;
+        uint32_t hotkey;
+    };
+
+    static_assert(sizeof(Header) == 72 && sizeof(GlobalRecord) == 8 && sizeof(ProfileRecord) == 24,
+                  "Snapshot records must have no padding; change VERSION along with them.");
+
+    /**
+     * @brief Collects parsed values, then lays them out as a snapshot file.
+     */
+    class Builder
+    {
+    public:
+        void AddGlobal(const ConfigParser::Key key, const int32_t value);
+        void SetSimpleProfile(const uint32_t fields, const int32_t brightness, const float contrast, const float gamma);
+        void AddProfile(const std::wstring_view name, const int32_t brightness, const float contrast,
+                        const float gamma, const uint32_t hotkey);
+
+        /**
+         * @brief Replace out with the finished file, stamped with the ini it describes.
+         */
+        void Finish(const IniStamp& ini, std::string& out) const;
+
+    private:
+        Header m_header = {};
+        std::vector<GlobalRecord> m_globals;
+        std::vector<ProfileRecord> m_profiles;
+        std::vector<uint16_t> m_names;
+    };
+
+    /**
+     * @brief Read-only view over a snapshot in memory, e.g. a mapped file. Copies nothing.
+     */
+    class View
+    {
+    public:
+        /**
+         * @brief Validate the bytes as a snapshot of exactly this ini.
+         * @param[in] data, size The snapshot; must stay valid (mapped) while the view is used.
+         * @return false if anything is off, in which case nothing else may be called.
+         */
+        bool Open(const void* data, const size_t size, const IniStamp& ini);
+
+        const Header& GetHeader() const { return m_header; }
+        GlobalRecord GetGlobal(const uint32_t index) const;
+        ProfileRecord GetProfile(const uint32_t index) const;
+
+        /**
+         * @brief Append a profile's name, decoded from the string pool, to out.
+         */
+        void AppendName(const ProfileRecord& profile, std::wstring& out) const;
+
+    private:
+        Header m_header = {};
+        const unsigned char* m_globals = nullptr;
+        const unsigned char* m_profiles = nullptr;
+        const unsigned char* m_names = nullptr;
+    };
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ConfigWriter.h"
+#include <charconv>
+
+// Six significant digits in the shortest of fixed or scientific notation, i.e. what a default
+// std::wostream produced for the same float.
+static constexpr int FLOAT_PRECISION = 6;
+
+void ConfigWriter::Comment(const std::string_view text)
+{
+    m_buffer += "; ";
+    m_buffer += text;
+    m_buffer += NEWLINE;
+}
+
+void ConfigWriter::BlankLine()
+{
+    m_buffer += NEWLINE;
+}
+
+void ConfigWriter::Section(const ConfigParser::Section section)
+{
+    m_buffer += '[';
+    m_buffer += ConfigParser::GetSectionName(section);
+    m_buffer += ']';
+    m_buffer += NEWLINE;
+}
+
+void ConfigWriter::BeginValue(const ConfigParser::Key key)
+{
+    m_buffer += ConfigParser::GetKeyName(key);
+    m_buffer += '=';
+}
+
+void ConfigWriter::Int(const ConfigParser::Key key, const int64_t value)
+{
+    BeginValue(key);
+    char digits[24];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    m_buffer.append(digits, result.ptr);
+    m_buffer += NEWLINE;
+}
+
+void ConfigWriter::Float(const ConfigParser::Key key, const float value)
+{
+    BeginValue(key);
+    char digits[32];
+    const std::to_chars_result result =
+        std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, FLOAT_PRECISION);
+    m_buffer.append(digits, result.ptr);
+    m_buffer += NEWLINE;
+}
+
+void ConfigWriter::String(const ConfigParser::Key key, const std::wstring_view value)
+{
+    BeginValue(key);
+
+    for (size_t i = 0; i < value.size(); ++i)
+    {
+        uint32_t codePoint = (uint32_t)value[i];
+
+        // Combine a surrogate pair; anything unpaired is replaced.
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 1 < value.size() &&
+            (uint32_t)value[i + 1] >= 0xDC00 && (uint32_t)value[i + 1] <= 0xDFFF)
+        {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + ((uint32_t)value[i + 1] - 0xDC00);
+            ++i;
+        }
+        else if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+        {
+            codePoint = 0xFFFD;
+        }
+
+        if (codePoint < 0x80)
+        {
+            m_buffer += (char)codePoint;
+        }
+        else if (codePoint < 0x800)
+        {
+            m_buffer += (char)(0xC0 | (codePoint >> 6));
+            m_buffer += (char)(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            m_buffer += (char)(0xE0 | (codePoint >> 12));
+            m_buffer += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            m_buffer += (char)(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            m_buffer += (char)(0xF0 | (codePoint >> 18));
+            m_buffer += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+            m_buffer += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+            m_buffer += (char)(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    m_buffer += NEWLINE;
+}
+
+uint64_t HashConfigBytes(const std::string_view bytes, uint64_t hash)
+{
+    for (const char byte : bytes)
+    {
+        hash ^= (uint8_t)byte;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Max Godman
+
+// Direct UTF-8 serializer for the GammaHotkey ini format, the counterpart of ConfigParser.
+
+/**
+ * ConfigManager::Save used to build the whole file in a std::wostringstream, then convert the result to
+ * UTF-8 in a second full-size copy. ConfigWriter appends UTF-8 straight onto a caller-owned std::string
+ * instead, so the caller can keep one buffer across saves and its capacity is only ever paid for once.
+ *
+ * OUTPUT:
+ * Lines end in CRLF, written as-is, so the buffer is byte for byte what lands on disk (and what a
+ * later Load reads back). Integers and floats are formatted with std::to_chars; floats keep the six
+ * significant digits the stream output produced, so saved files look the same as before. Names come
+ * from ConfigParser's tables, so the parser and the writer cannot disagree on a spelling.
+ *
+ * Portable (no <windows.h>).
+ */
+
+#pragma once
+
+#include "ConfigParser.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class ConfigWriter
+{
+public:
+    static constexpr std::string_view NEWLINE = "\r\n";
+
+    /**
+     * @brief Append to the given buffer; existing contents are kept.
+     */
+    explicit ConfigWriter(std::string& buffer) : m_buffer(buffer) {}
+
+    /**
+     * @brief "; text" on its own line.
+     */
+    void Comment(const std::string_view text);
+
+    /**
+     * @brief An empty line.
+     */
+    void BlankLine();
+
+    /**
+     * @brief "[Section]" on its own line.
+     */
+    void Section(const ConfigParser::Section section);
+
+    /**
+     * @brief "Key=value" lines for each value type.
+     */
+    void Int(const ConfigParser::Key key, const int64_t value);
+    void Float(const ConfigParser::Key key, const float value);
+    void Bool(const ConfigParser::Key key, const bool value) { Int(key, value ? 1 : 0); }
+
+    /**
+     * @brief "Key=value" with a UTF-16 (or, where wchar_t is 32-bit, UTF-32) value encoded as UTF-8.
+     * @note Unpaired surrogates become U+FFFD, as WideCharToMultiByte does.
+     */
+    void String(const ConfigParser::Key key, const std::wstring_view value);
+
+private:
+    void BeginValue(const ConfigParser::Key key);
+
+    std::string& m_buffer;
+};
+
+// HashConfigBytes of nothing, where every hash starts.
+constexpr uint64_t CONFIG_HASH_SEED = 14695981039346656037ull;
+
+/**
+ * @brief 64-bit FNV-1a hash of a byte range, for cheap "same file contents?" checks.
+ * @param[in] hash To hash a file in pieces, the hash of the bytes before these.
+ */
+uint64_t HashConfigBytes(const std::string_view bytes, uint64_t hash = CONFIG_HASH_SEED);
@@ -0,0 +1,177 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ControlProtocol.h"
+#include <charconv>
+
+namespace ControlProtocol
+{
+    static bool IsSpace(const char c)
+    {
+        return c == ' ' || c == '\t';
+    }
+
+    static std::string_view TrimSpaces(std::string_view text)
+    {
+        while (!text.empty() && IsSpace(text.front()))
+            text.remove_prefix(1);
+        while (!text.empty() && IsSpace(text.back()))
+            text.remove_suffix(1);
+        return text;
+    }
+
+    // Split off the first space-separated word, leaving the rest (trimmed) in text.
+    static std::string_view NextWord(std::string_view& text)
+    {
+        size_t end = 0;
+        while (end < text.size() && !IsSpace(text[end]))
+            ++end;
+        const std::string_view word = text.substr(0, end);
+        text = TrimSpaces(text.substr(end));
+        return word;
+    }
+
+    static bool EqualsIgnoreCase(const std::string_view a, const std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t index = 0; index < a.size(); ++index)
+        {
+            const char x = (a[index] >= 'A' && a[index] <= 'Z') ? (char)(a[index] + 32) : a[index];
+            const char y = (b[index] >= 'A' && b[index] <= 'Z') ? (char)(b[index] + 32) : b[index];
+            if (x != y)
+                return false;
+        }
+        return true;
+    }
+
+    static Request Invalid(const char* error)
+    {
+        Request request;
+        request.error = error;
+        return request;
+    }
+
+    // The whole of text as a number; ConfigParser's parsers ignore trailing characters, the protocol does not.
+    template <typename T>
+    static bool ParseWhole(const std::string_view text, T& out)
+    {
+        T value = {};
+        const std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size())
+            return false;
+        out = value;
+        return true;
+    }
+
+    static Request ParseSet(std::string_view arguments)
+    {
+        Request request;
+        request.op = Op::Set;
+
+        while (!arguments.empty())
+        {
+            const std::string_view argument = NextWord(arguments);
+            const size_t equals = argument.find('=');
+            if (equals == std::string_view::npos)
+                return Invalid("set takes b=, c= and g=");
+
+            const std::string_view key = argument.substr(0, equals);
+            const std::string_view value = argument.substr(equals + 1);
+            if (EqualsIgnoreCase(key, "b") || EqualsIgnoreCase(key, "brightness"))
+            {
+                if (!ParseWhole(value, request.brightness))
+                    return Invalid("brightness must be an integer");
+                request.hasBrightness = true;
+            }
+            else if (EqualsIgnoreCase(key, "c") || EqualsIgnoreCase(key, "contrast"))
+            {
+                if (!ParseWhole(value, request.contrast))
+                    return Invalid("contrast must be a number");
+                request.hasContrast = true;
+            }
+            else if (EqualsIgnoreCase(key, "g") || EqualsIgnoreCase(key, "gamma"))
+            {
+                if (!ParseWhole(value, request.gamma))
+                    return Invalid("gamma must be a number");
+                request.hasGamma = true;
+            }
+            else
+            {
+                return Invalid("set takes b=, c= and g=");
+            }
+        }
+
+        if (!request.hasBrightness && !request.hasContrast && !request.hasGamma)
+            return Invalid("set needs at least one of b=, c= and g=");
+        return request;
+    }
+
+    Request ParseRequest(std::string_view line)
+    {
+        if (line.size() > MAX_LINE)
+            return Invalid("line too long");
+
+        std::string_view arguments = TrimSpaces(line);
+        const std::string_view verb = NextWord(arguments);
+        if (verb.empty())
+            return Invalid("empty request");
+
+        Request request;
+        if (EqualsIgnoreCase(verb, "apply"))
+        {
+            if (arguments.empty())
+                return Invalid("apply needs a profile name");
+            request.op = Op::Apply;
+            request.name = arguments;
+        }
+        else if (EqualsIgnoreCase(verb, "apply-id"))
+        {
+            if (!ParseWhole(arguments, request.value) || request.value <= 0)
+                return Invalid("apply-id needs a profile ID");
+            request.op = Op::ApplyId;
+        }
+        else if (EqualsIgnoreCase(verb, "set"))
+        {
+            return ParseSet(arguments);
+        }
+        else if (EqualsIgnoreCase(verb, "transition"))
+        {
+            if (!ParseWhole(arguments, request.value))
+                return Invalid("transition needs a length in ms");
+            request.op = Op::Transition;
+        }
+        else
+        {
+            static constexpr struct { std::string_view verb; Op op; } SIMPLE_VERBS[] = {
+                { "on", Op::On }, { "off", Op::Off }, { "toggle", Op::Toggle },
+                { "get", Op::Get }, { "list", Op::List }, { "sync", Op::Sync },
+                { "trace", Op::Trace }, { "stats", Op::Stats },
+            };
+            for (const auto& simple : SIMPLE_VERBS)
+            {
+                if (EqualsIgnoreCase(verb, simple.verb))
+                    request.op = simple.op;
+            }
+            if (request.op == Op::Invalid)
+                return Invalid("unknown request");
+            if (!arguments.empty())
+                return Invalid("unexpected arguments");
+        }
+        return request;
+    }
+
+    bool TakeLines(std::string& buffer, std::vector<std::string>& lines)
+    {
+        size_t start = 0;
+        for (size_t end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', start))
+        {
+            size_t length = end - start;
+            if (length > 0 && buffer[end - 1] == '\r')
+                --length;
+            lines.emplace_back(buffer, start, length);
+            start = end + 1;
+        }
+        buffer.erase(0, start);
+        return buffer.size() <= MAX_LINE;
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Max Godman
+
+// Line protocol of the local control pipe: request parsing and line framing.
+
+/**
+ * Automation (game launchers, stream decks, HTPC scripts) keeps one connection open to the control
+ * pipe (see ControlManager) and sends one request per line. Requests can be pipelined: a client may
+ * send any number without waiting, and gets one reply line per request, in order. Everything
+ * received together is carried out as one batch on the UI thread.
+ *
+ * REQUESTS:
+ * Lines end in LF or CRLF and are UTF-8. Verbs match ASCII case-insensitively; spaces separate
+ * arguments.
+ *   apply <name>               Apply a profile by name (the rest of the line, case-insensitive).
+ *   apply-id <id>              Apply a profile by its ID (see list). IDs last for the session only.
+ *   set [b=<int>] [c=<float>] [g=<float>]
+ *                              Change brightness, contrast and/or gamma of what the current mode
+ *                              applies (the working profile, or the simple profile), and apply it.
+ *   transition <ms>            Fade length for this connection's apply, apply-id and set. Default 0.
+ *   on | off | toggle          Turn the gamma adjustment on or off, as the toggle hotkey does.
+ *   get                        Report the current state.
+ *   list                       Report every profile's ID and name.
+ *   sync                       Reply once everything requested so far is on the displays.
+ *   trace                      Report how long each phase of start-up took (see StartupTrace).
+ *   stats                      Report how often the window redrew, in all and while idle (see
+ *                              RedrawPolicy), how many ramps and fades reached the driver (see
+ *                              GammaManager::GetApplyStats), and how the ramp cache did (see
+ *                              RampCache).
+ *
+ * REPLIES:
+ *   ok [<fields>]              Done. apply, set, on, off and toggle have been handed to the apply
+ *                              workers (which coalesce them, latest wins); use sync to wait for them.
+ *   err <reason>               Not done.
+ * get replies "ok on=1 mode=advanced display=0 b=-20 c=1.00 g=2.20 id=3 failed=0 name=Night"; name
+ * comes last and runs to the end of the line. list replies "ok 1=Day;2=Night": profile names never
+ * contain '=' or ';' (see ConfigManager::SanitizeProfileName). trace replies
+ * "ok total=48.2 config=0.4+3.1 displays=0.4+6.0 ...", each phase as name=start+duration in ms.
+ * stats replies "ok frames=412 idle_frames=0 idle_s=3581.2 idle_fpm=0.0 driver_calls=57 skipped_calls=12
+ * coalesced_calls=30 clamped=0 transitions=4 cancelled=1 transition_writes=210 last_transition_writes=60":
+ * frames rendered since launch, how many of them while idle, the idle time, and the idle frames per
+ * minute; then SetDeviceGammaRamp calls made, applies skipped because the display already had that
+ * ramp, ramps replaced before they were written, and ramps clamped; then fades started, fades cut
+ * short by a newer apply, the writes all fades made, and the writes the latest fade made; then
+ * "cache_hits=40 cache_misses=9 cache_evictions=0 cache_size=9", the ramp cache's counters.
+ *
+ * Portable (no <windows.h>), so it can be measured on its own.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ControlProtocol
+{
+    // Longest request line accepted. A connection that sends a longer one is closed.
+    constexpr size_t MAX_LINE = 1024;
+
+    enum class Op : uint8_t
+    {
+        Invalid, // See Request::error.
+        Apply,
+        ApplyId,
+        Set,
+        Transition,
+        On,
+        Off,
+        Toggle,
+        Get,
+        List,
+        Sync,
+        Trace,
+        Stats,
+    };
+
+    /**
+     * @brief A parsed request line.
+     */
+    struct Request
+    {
+        Op op = Op::Invalid;
+        std::string_view name;  // Apply: the profile name, a view into the line.
+        int value = 0;          // ApplyId: the ID. Transition: the fade length in ms.
+
+        // Set: which fields to change, and their new values.
+        bool hasBrightness = false;
+        bool hasContrast = false;
+        bool hasGamma = false;
+        int brightness = 0;
+        float contrast = 0.0f;
+        float gamma = 0.0f;
+
+        const char* error = nullptr; // Op::Invalid: why, for the "err" reply.
+    };
+
+    /**
+     * @brief Parse one request line, without its line ending. Values are not range-checked.
+     */
+    Request ParseRequest(std::string_view line);
+
+    /**
+     * @brief Move the complete lines at the start of buffer into lines (appending, without their line
+     *        endings), leaving an incomplete last line in buffer for the next read.
+     * @return false if the incomplete line is already longer than MAX_LINE.
+     */
+    bool TakeLines(std::string& buffer, std::vector<std::string>& lines);
+}
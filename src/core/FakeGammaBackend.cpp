@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Max Godman
+
+#include "FakeGammaBackend.h"
+#include <cstring>
+#include <thread>
+
+FakeGammaBackend::FakeGammaBackend(const int displayCount)
+    : m_pendingDisplayCount(displayCount > 0 ? displayCount : 0)
+{
+}
+
+// Caller holds m_mutex.
+bool FakeGammaBackend::IsValidIndex(const int displayIndex) const
+{
+    return displayIndex >= 0 && displayIndex < (int)m_displays.size();
+}
+
+std::vector<GammaDisplayInfo> FakeGammaBackend::Enumerate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_displays.assign(m_pendingDisplayCount, Display());
+
+    std::vector<GammaDisplayInfo> displays;
+    for (int index = 0; index < (int)m_displays.size(); ++index)
+    {
+        RampEngine::BuildIdentityRamp(m_displays[index].ramp);
+
+        GammaDisplayInfo info;
+        info.deviceName = L"\\\\.\\FAKE" + std::to_wstring(index + 1);
+        info.friendlyName = L"Fake Display " + std::to_wstring(index + 1) + L" | Fake GPU";
+        displays.push_back(info);
+    }
+
+    m_calls.push_back({ CallType::Enumerate, -1, 0, true });
+    return displays;
+}
+
+void FakeGammaBackend::Release()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calls.push_back({ CallType::Release, -1, 0, true });
+}
+
+int FakeGammaBackend::GetRampSize(const int displayIndex)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return IsValidIndex(displayIndex) ? RampEngine::RAMP_SIZE : 0;
+}
+
+int FakeGammaBackend::GetRefreshRate(const int displayIndex)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return IsValidIndex(displayIndex) ? m_refreshRate : 0;
+}
+
+RampPreflight::Limits FakeGammaBackend::GetRampLimits(const int displayIndex)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return IsValidIndex(displayIndex) ? m_rampLimits : RampPreflight::Limits();
+}
+
+bool FakeGammaBackend::ReadRamp(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE])
+{
+    std::chrono::microseconds latency;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        latency = m_readLatency;
+    }
+    if (latency.count() > 0)
+        std::this_thread::sleep_for(latency);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const bool success = IsValidIndex(displayIndex);
+    if (success)
+        std::memcpy(ramp, m_displays[displayIndex].ramp, sizeof(m_displays[displayIndex].ramp));
+
+    m_calls.push_back({ CallType::ReadRamp, displayIndex, success ? RampEngine::HashRamp(ramp) : 0, success });
+    return success;
+}
+
+bool FakeGammaBackend::WriteRamp(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE])
+{
+    std::chrono::microseconds latency;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        latency = m_writeLatency;
+    }
+    if (latency.count() > 0)
+        std::this_thread::sleep_for(latency);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool success = IsValidIndex(displayIndex) && !m_displays[displayIndex].writesFail &&
+                   RampPreflight::Check(ramp, m_rampLimits).accepted;
+    if (success && m_failNextWrites > 0)
+    {
+        --m_failNextWrites;
+        success = false;
+    }
+
+    // A rejected ramp leaves the display as it was, like SetDeviceGammaRamp returning FALSE.
+    if (success)
+        std::memcpy(m_displays[displayIndex].ramp, ramp, sizeof(m_displays[displayIndex].ramp));
+
+    m_calls.push_back({ CallType::WriteRamp, displayIndex, RampEngine::HashRamp(ramp), success });
+    return success;
+}
+
+void FakeGammaBackend::SetDisplayCount(const int displayCount)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingDisplayCount = displayCount > 0 ? displayCount : 0;
+}
+
+void FakeGammaBackend::SetRefreshRate(const int refreshRate)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_refreshRate = refreshRate > 0 ? refreshRate : 0;
+}
+
+void FakeGammaBackend::SetRampLimits(const RampPreflight::Limits& limits)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rampLimits = limits;
+}
+
+void FakeGammaBackend::SetLatency(const std::chrono::microseconds readLatency, const std::chrono::microseconds writeLatency)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_readLatency = readLatency;
+    m_writeLatency = writeLatency;
+}
+
+void FakeGammaBackend::SetWritesFail(const int displayIndex, const bool fail)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int index = 0; index < (int)m_displays.size(); ++index)
+    {
+        if (displayIndex == -1 || displayIndex == index)
+            m_displays[index].writesFail = fail;
+    }
+}
+
+void FakeGammaBackend::FailNextWrites(const int count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_failNextWrites = count > 0 ? count : 0;
+}
+
+std::vector<FakeGammaBackend::Call> FakeGammaBackend::GetCalls() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_calls;
+}
+
+size_t FakeGammaBackend::GetWriteCount(const int displayIndex) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const Call& call : m_calls)
+    {
+        if (call.type == CallType::WriteRamp && (displayIndex == -1 || call.displayIndex == displayIndex))
+            ++count;
+    }
+    return count;
+}
+
+void FakeGammaBackend::ClearCalls()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calls.clear();
+}
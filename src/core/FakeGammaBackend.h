@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Max Godman
+
+// In-process gamma backend for headless runs: simulated displays, recorded calls, injected latency and failures.
+
+/**
+ * Stands in for Win32GammaBackend so the apply pipeline (GammaWorker, GammaManager's skip and result
+ * logic) can be driven and measured without a GPU, a desktop session or Windows at all. Install it with
+ * DisplayManager::SetBackend, or use it directly.
+ *
+ * Each simulated display holds the ramp last written to it (the identity ramp to begin with), so a
+ * ReadRamp after a WriteRamp returns what was written, as on real hardware. Writes are judged by
+ * RampPreflight's model, so a ramp Windows would refuse is refused here too. Every call is appended to
+ * a log with its outcome and, for ramps, RampEngine::HashRamp of the contents.
+ *
+ * Safe to call from any number of threads; the configured latency is slept outside the lock, so
+ * writes to different displays overlap the way real driver calls do.
+ */
+
+#pragma once
+
+#include "GammaBackend.h"
+#include <chrono>
+#include <mutex>
+
+class FakeGammaBackend : public GammaBackend
+{
+public:
+    enum class CallType
+    {
+        Enumerate,
+        Release,
+        ReadRamp,
+        WriteRamp,
+    };
+
+    /**
+     * @brief One recorded backend call.
+     */
+    struct Call
+    {
+        CallType type = CallType::Enumerate;
+        int displayIndex = -1;  // -1 for Enumerate and Release.
+        uint64_t rampHash = 0;  // HashRamp of the ramp read or written; 0 otherwise.
+        bool success = true;
+    };
+
+    /**
+     * @brief Create a fake with the given number of displays, named "\\\\.\\FAKE1" onwards.
+     */
+    explicit FakeGammaBackend(const int displayCount = 1);
+
+    std::vector<GammaDisplayInfo> Enumerate() override;
+    void Release() override;
+    int GetRampSize(const int displayIndex) override;
+    int GetRefreshRate(const int displayIndex) override;
+    RampPreflight::Limits GetRampLimits(const int displayIndex) override;
+    bool ReadRamp(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]) override;
+    bool WriteRamp(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]) override;
+
+    /**
+     * @brief Change the simulated display count. Takes effect at the next Enumerate.
+     */
+    void SetDisplayCount(const int displayCount);
+
+    /**
+     * @brief Refresh rate every simulated display reports. Default 60 Hz.
+     */
+    void SetRefreshRate(const int refreshRate);
+
+    /**
+     * @brief Limits every simulated display reports and enforces: a write outside them fails, as
+     *        SetDeviceGammaRamp does. Default RampPreflight's Windows defaults.
+     */
+    void SetRampLimits(const RampPreflight::Limits& limits);
+
+    /**
+     * @brief Time every ReadRamp / WriteRamp takes, e.g. to model a slow driver. Default 0.
+     */
+    void SetLatency(const std::chrono::microseconds readLatency, const std::chrono::microseconds writeLatency);
+
+    /**
+     * @brief Make every write to a display fail (true) or succeed (false), like a driver rejecting a ramp.
+     * @param[in] displayIndex Display index, or -1 for every display.
+     */
+    void SetWritesFail(const int displayIndex, const bool fail);
+
+    /**
+     * @brief Make the next count writes fail, whichever display they target, then succeed again.
+     */
+    void FailNextWrites(const int count);
+
+    /**
+     * @brief The recorded calls, oldest first.
+     */
+    std::vector<Call> GetCalls() const;
+
+    /**
+     * @brief Number of WriteRamp calls made for a display (successful or not), or for all with -1.
+     */
+    size_t GetWriteCount(const int displayIndex) const;
+
+    /**
+     * @brief Forget every recorded call. Display ramps and failure settings are kept.
+     */
+    void ClearCalls();
+
+private:
+    struct Display
+    {
+        bool writesFail = false;
+        uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE] = {};
+    };
+
+    bool IsValidIndex(const int displayIndex) const;
+
+    mutable std::mutex m_mutex;
+    int m_pendingDisplayCount = 1;     // Applied by the next Enumerate.
+    std::vector<Display> m_displays;   // The current enumeration.
+    std::vector<Call> m_calls;
+    std::chrono::microseconds m_readLatency{ 0 };
+    std::chrono::microseconds m_writeLatency{ 0 };
+    int m_failNextWrites = 0;
+    int m_refreshRate = 60;
+    RampPreflight::Limits m_rampLimits;
+};
@@ -0,0 +1,85 @@
+// Copyright (c) 2025 Max Godman
+
+// Interface to the device layer that lists displays and reads/writes their gamma ramps.
+
+/**
+ * Everything that talks to real hardware sits behind this interface: Win32GammaBackend is the one the
+ * app ships with (EnumDisplayDevices, Get/SetDeviceGammaRamp), FakeGammaBackend is an in-process
+ * stand-in that records calls and can simulate slow or failing drivers. DisplayManager owns the active
+ * backend; GammaManager and the startup curve seeding only ever go through it.
+ *
+ * The header is portable (no <windows.h>), so the fake and anything built on the interface can be
+ * compiled and exercised on any platform.
+ *
+ * THREADING:
+ * WriteRamp is called from the per-display apply workers, concurrently for different displays but
+ * never concurrently for the same one. Enumerate and Release are only called while no worker runs.
+ * ReadRamp, GetRampSize, GetRefreshRate and GetRampLimits may be called from the UI thread at any time,
+ * and ReadRamp also from a worker as it starts. At launch, Enumerate and the first ReadRamps run on a
+ * thread of their own, joined before the workers start (see WM_CREATE).
+ */
+
+#pragma once
+
+#include "RampEngine.h"
+#include "RampPreflight.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A display as reported by a backend, in enumeration order.
+ */
+struct GammaDisplayInfo
+{
+    std::wstring deviceName;    // Internal device name (e.g. "\\\\.\\DISPLAY1").
+    std::wstring friendlyName;  // User friendly name (e.g. "Branded Monitor | Branded GPU").
+};
+
+class GammaBackend
+{
+public:
+    virtual ~GammaBackend() = default;
+
+    /**
+     * @brief List the active displays and open whatever per-display handles writes need.
+     * @return The displays; their positions are the displayIndex every other call takes.
+     * @note Replaces the previous enumeration, and invalidates its indices.
+     */
+    virtual std::vector<GammaDisplayInfo> Enumerate() = 0;
+
+    /**
+     * @brief Close the per-display handles opened by Enumerate.
+     */
+    virtual void Release() = 0;
+
+    /**
+     * @brief Number of entries per channel in a display's ramp.
+     * @return RampEngine::RAMP_SIZE for every display a backend supports, 0 for an invalid index.
+     */
+    virtual int GetRampSize(const int displayIndex) = 0;
+
+    /**
+     * @brief A display's refresh rate, which paces timed transitions on it.
+     * @return Refresh rate in Hz, or 0 if unknown (callers then assume 60).
+     */
+    virtual int GetRefreshRate(const int displayIndex) = 0;
+
+    /**
+     * @brief Which ramps a display will accept, for RampPreflight to check against before writing.
+     * @return The display's limits; RampPreflight's defaults for an invalid index.
+     */
+    virtual RampPreflight::Limits GetRampLimits(const int displayIndex) = 0;
+
+    /**
+     * @brief Read a display's current ramp.
+     * @return false if the index is invalid or the read failed.
+     */
+    virtual bool ReadRamp(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]) = 0;
+
+    /**
+     * @brief Write a ramp to a display.
+     * @return false if the index is invalid or the device rejected the ramp.
+     */
+    virtual bool WriteRamp(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]) = 0;
+};
@@ -4,7 +4,19 @@
 
 #pragma once
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+// The portable core (see CMakeLists.txt) uses these types without <windows.h>; the values match it.
+#include <cstdint>
+using UINT = unsigned int;
+using UINT_PTR = uintptr_t;
+constexpr UINT MOD_ALT = 0x0001;
+constexpr UINT MOD_CONTROL = 0x0002;
+constexpr UINT MOD_SHIFT = 0x0004;
+constexpr UINT MOD_WIN = 0x0008;
+constexpr UINT WM_USER = 0x0400;
+#endif // _WIN32
 #include <string>
 
 /**
@@ -29,6 +41,29 @@ namespace ProfileRange
     constexpr float GAMMA_DEFAULT = 1.0f;
 }
 
+/**
+ * @brief Range of the profile switch fade, in milliseconds (0 = switch instantly).
+ *
+ * The options slider binds to these, and ConfigManager clamps the loaded value to them.
+ */
+namespace TransitionRange
+{
+    constexpr int MS_MIN = 0;
+    constexpr int MS_MAX = 5000;
+    constexpr int MS_DEFAULT = 0;
+}
+
+/**
+ * @brief How long the window stays hidden before its renderer is released (ReleaseUIAfterSec).
+ * 0 keeps the renderer for the whole session. ConfigManager clamps the loaded value to these.
+ */
+namespace UIReleaseRange
+{
+    constexpr int SEC_MIN = 0;
+    constexpr int SEC_MAX = 86400;
+    constexpr int SEC_DEFAULT = 30;
+}
+
 /**
  * @brief Profile containing gamma adjustment settings and hotkey binding.
  */
@@ -38,7 +73,8 @@ struct Profile
     int brightness = ProfileRange::BRIGHTNESS_DEFAULT;
     float contrast = ProfileRange::CONTRAST_DEFAULT;
     float gamma = ProfileRange::GAMMA_DEFAULT;
-    UINT hotkey = 0;  // Virtual key code, 0 = none.
+    UINT hotkey = 0;  // HotkeyCode (key plus modifiers), 0 = none.
+    int id = 0;       // Stable for the session whatever the list order, never saved; 0 = not assigned yet.
     
     Profile() = default;
     Profile(std::wstring n, int b, float c, float g, UINT h)
@@ -54,12 +90,50 @@ struct DisplayEntry
     std::wstring friendlyName;  // User friendly name (e.g. "Branded Monitor | Branded GPU").
 };
 
+/**
+ * @brief A hotkey binding packed into one integer: the form Profile::hotkey, the global hotkeys
+ *        and the config file all use.
+ *
+ * The low byte is the virtual-key code and the next four bits are the RegisterHotKey modifiers
+ * (MOD_ALT, MOD_CONTROL, MOD_SHIFT, MOD_WIN), so a plain key keeps the value it always had and
+ * every valid code is below COUNT. A table indexed by code therefore answers "what is bound to
+ * this key combination?" in one step. 0 = none.
+ */
+namespace HotkeyCode
+{
+    constexpr UINT VK_MASK = 0xFF;
+    constexpr UINT MODIFIER_SHIFT = 8;
+    constexpr UINT MODIFIER_MASK = MOD_ALT | MOD_CONTROL | MOD_SHIFT | MOD_WIN;
+    constexpr UINT COUNT = (VK_MASK + 1) << 4; // 256 keys times 16 modifier combinations.
+
+    constexpr UINT Make(const UINT vk, const UINT modifiers)
+    {
+        return (vk & VK_MASK) | ((modifiers & MODIFIER_MASK) << MODIFIER_SHIFT);
+    }
+
+    constexpr UINT Vk(const UINT code) { return code & VK_MASK; }
+    constexpr UINT Modifiers(const UINT code) { return (code >> MODIFIER_SHIFT) & MODIFIER_MASK; }
+
+    // A code names a key (anything else, e.g. a hand-edited config value, is treated as unbound).
+    constexpr bool IsValid(const UINT code) { return code < COUNT && Vk(code) != 0; }
+}
+
+// IDs passed to RegisterHotKey and back in WM_HOTKEY. Dense from 1, so HotkeyManager can
+// dispatch through a flat table indexed by ID. A profile's is PROFILE_BASE + Profile::id, so it
+// survives reordering and deleting other profiles.
 namespace HotkeyIDs
 {
     constexpr int TOGGLE = 1;
     constexpr int PREVIOUS_PROFILE = 2;
     constexpr int NEXT_PROFILE = 3;
-    constexpr int PROFILE_BASE = 1000;
+    constexpr int BRIGHTNESS_UP = 4;
+    constexpr int BRIGHTNESS_DOWN = 5;
+    constexpr int CONTRAST_UP = 6;
+    constexpr int CONTRAST_DOWN = 7;
+    constexpr int GAMMA_UP = 8;
+    constexpr int GAMMA_DOWN = 9;
+    constexpr int PROFILE_BASE = 10;
+    constexpr int MAX = 0xBFFF; // Highest ID RegisterHotKey accepts from an application.
 }
 
 /**
@@ -75,6 +149,12 @@ enum class HotkeyCapture
     TOGGLE,
     PREVIOUS_PROFILE,
     NEXT_PROFILE,
+    BRIGHTNESS_UP,
+    BRIGHTNESS_DOWN,
+    CONTRAST_UP,
+    CONTRAST_DOWN,
+    GAMMA_UP,
+    GAMMA_DOWN,
     PROFILE,
 };
 
@@ -87,6 +167,42 @@ namespace SystemTrayIDs
     constexpr UINT ID_EXIT = 2102;
 }
 
+namespace TimerIDs
+{
+    // SetTimer ID on the main window while a brightness/contrast/gamma step hotkey is held.
+    constexpr UINT_PTR STEP_HOLD = 1;
+
+    // SetTimer ID on the main window while it is hidden and still holds its renderer, see main.cpp.
+    constexpr UINT_PTR RELEASE_UI = 2;
+}
+
+namespace ConfigIDs
+{
+    // Posted to the main window by ConfigManager's file watcher when the config changed on disk.
+    constexpr UINT WM_CONFIG_CHANGED = WM_USER + 101;
+}
+
+namespace CommandLineIDs
+{
+    // Posted to the main window by CommandLineManager's pipe server with a command forwarded by a
+    // second launch; lParam owns a CommandLineManager::ForwardedCommand.
+    constexpr UINT WM_FORWARDED_COMMAND = WM_USER + 102;
+}
+
+namespace ControlIDs
+{
+    // Posted to the main window by a ControlManager client thread with a batch of requests; lParam
+    // is the client's ControlManager::Session.
+    constexpr UINT WM_CONTROL_BATCH = WM_USER + 103;
+}
+
+namespace GammaIDs
+{
+    // Posted to the main window by GammaManager when App::state.gammaRampFailed changes, typically
+    // from an apply worker once the driver has answered.
+    constexpr UINT WM_APPLY_RESULT = WM_USER + 104;
+}
+
 namespace AppConstants
 {
     constexpr int MAX_LOADSTRING = 100;
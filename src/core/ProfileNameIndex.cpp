@@ -0,0 +1,160 @@
+// Copyright (c) 2025 Max Godman
+
+#include "ProfileNameIndex.h"
+#include <cwctype>
+
+// Smallest table, and how full it may get (entries * MAX_LOAD_INVERSE <= table size).
+static constexpr size_t MIN_TABLE_SIZE = 16;
+static constexpr size_t MAX_LOAD_INVERSE = 2;
+
+static size_t TableSizeFor(const size_t count)
+{
+    size_t size = MIN_TABLE_SIZE;
+    while (size < count * MAX_LOAD_INVERSE)
+        size *= 2;
+    return size;
+}
+
+ProfileNameIndex::ProfileNameIndex(const std::vector<Profile>& profiles)
+    : m_profiles(profiles)
+{
+}
+
+uint32_t ProfileNameIndex::Hash(const std::wstring_view name)
+{
+    // FNV-1a over the folded code units.
+    uint32_t hash = 2166136261u;
+    for (const wchar_t ch : name)
+    {
+        hash ^= (uint32_t)std::towlower(ch);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool ProfileNameIndex::Equal(const std::wstring_view a, const std::wstring_view b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t index = 0; index < a.size(); ++index)
+    {
+        if (a[index] != b[index] && std::towlower(a[index]) != std::towlower(b[index]))
+            return false;
+    }
+    return true;
+}
+
+void ProfileNameIndex::Rebuild()
+{
+    m_table.assign(TableSizeFor(m_profiles.size()), Entry{ EMPTY, 0 });
+    m_count = 0;
+
+    // In slot order, so of two profiles with the same name Find returns the first, as a scan would.
+    for (size_t slot = 0; slot < m_profiles.size(); ++slot)
+        Insert((int)slot, Hash(m_profiles[slot].name));
+}
+
+int ProfileNameIndex::Find(const std::wstring_view name) const
+{
+    if (m_table.empty())
+        return -1;
+
+    const uint32_t hash = Hash(name);
+    const size_t mask = m_table.size() - 1;
+    for (size_t position = hash & mask; m_table[position].slot != EMPTY; position = (position + 1) & mask)
+    {
+        const Entry& entry = m_table[position];
+        if (entry.hash == hash && (size_t)entry.slot < m_profiles.size() &&
+            Equal(m_profiles[entry.slot].name, name))
+        {
+            return entry.slot;
+        }
+    }
+    return -1;
+}
+
+void ProfileNameIndex::Add(const int slot)
+{
+    // Growing re-indexes the whole list, the new profile included.
+    if ((m_count + 1) * MAX_LOAD_INVERSE > m_table.size())
+    {
+        Rebuild();
+        return;
+    }
+    Insert(slot, Hash(m_profiles[slot].name));
+}
+
+void ProfileNameIndex::Rename(const int slot, const std::wstring_view oldName)
+{
+    const size_t position = Locate(slot, Hash(oldName));
+    if (position == m_table.size())
+    {
+        Rebuild(); // Out of step with the list; start over.
+        return;
+    }
+    EraseAt(position);
+    Insert(slot, Hash(m_profiles[slot].name));
+}
+
+void ProfileNameIndex::Swap(const int a, const int b)
+{
+    // The name now at a was indexed as b's, and the other way round.
+    const size_t positionA = Locate(b, Hash(m_profiles[a].name));
+    const size_t positionB = Locate(a, Hash(m_profiles[b].name));
+    if (positionA == m_table.size() || positionB == m_table.size())
+    {
+        Rebuild();
+        return;
+    }
+    m_table[positionA].slot = a;
+    m_table[positionB].slot = b;
+}
+
+void ProfileNameIndex::Insert(const int slot, const uint32_t hash)
+{
+    const size_t mask = m_table.size() - 1;
+    size_t position = hash & mask;
+    while (m_table[position].slot != EMPTY)
+        position = (position + 1) & mask;
+
+    m_table[position] = Entry{ slot, hash };
+    ++m_count;
+}
+
+size_t ProfileNameIndex::Locate(const int slot, const uint32_t hash) const
+{
+    if (m_table.empty())
+        return 0;
+
+    const size_t mask = m_table.size() - 1;
+    for (size_t position = hash & mask; m_table[position].slot != EMPTY; position = (position + 1) & mask)
+    {
+        if (m_table[position].slot == slot)
+            return position;
+    }
+    return m_table.size();
+}
+
+void ProfileNameIndex::EraseAt(size_t position)
+{
+    // Backward-shift deletion: pull later entries of the probe run into the hole when their home
+    // position allows it, so no tombstones are needed.
+    const size_t mask = m_table.size() - 1;
+    size_t next = position;
+    for (;;)
+    {
+        next = (next + 1) & mask;
+        if (m_table[next].slot == EMPTY)
+            break;
+
+        const size_t home = m_table[next].hash & mask;
+        if (((next - home) & mask) >= ((next - position) & mask))
+        {
+            m_table[position] = m_table[next];
+            position = next;
+        }
+    }
+
+    m_table[position] = Entry{ EMPTY, 0 };
+    --m_count;
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2025 Max Godman
+
+// Case-insensitive hash index from profile name to its slot in a profile list.
+
+/**
+ * Profile names are unique ignoring case, and both Load (dropping duplicates) and the UI (finding the
+ * profile a name refers to) look profiles up by name. A linear scan made loading N profiles O(N^2);
+ * this index makes a lookup O(1).
+ *
+ * TABLE:
+ * Open addressing with linear probing, at most half full. An entry is only a slot number and the hash
+ * of that profile's case-folded name; the names themselves are read from the list, so nothing is
+ * copied and a lookup folds case on the fly. Folding is towlower per code unit, as _wcsicmp compares.
+ *
+ * KEEPING IT CURRENT:
+ * The index does not watch the list. Whoever changes the list calls Add, Rename or Swap for the
+ * one-profile changes the UI makes, and Rebuild for anything else (a load, a delete, a journal
+ * replay). Find checks the name of the slot it returns, so a missed update can make it miss, but
+ * never return the wrong profile.
+ */
+
+#pragma once
+
+#include "GammaHotkeyTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class ProfileNameIndex
+{
+public:
+    /**
+     * @param[in] profiles The list to index; must outlive the index. Starts empty, call Rebuild.
+     */
+    explicit ProfileNameIndex(const std::vector<Profile>& profiles);
+
+    /**
+     * @brief Index the whole list again. O(N).
+     */
+    void Rebuild();
+
+    /**
+     * @brief Slot of the profile with this name, ignoring case, or -1.
+     */
+    int Find(const std::wstring_view name) const;
+
+    /**
+     * @brief Index profiles[slot], which was just added (typically appended).
+     */
+    void Add(const int slot);
+
+    /**
+     * @brief Re-index profiles[slot] after its name changed from oldName.
+     */
+    void Rename(const int slot, const std::wstring_view oldName);
+
+    /**
+     * @brief Re-index after profiles[a] and profiles[b] were swapped (a reorder).
+     */
+    void Swap(const int a, const int b);
+
+private:
+    struct Entry
+    {
+        int32_t slot; // EMPTY for a free entry.
+        uint32_t hash;
+    };
+
+    static constexpr int32_t EMPTY = -1;
+
+    static uint32_t Hash(const std::wstring_view name);
+    static bool Equal(const std::wstring_view a, const std::wstring_view b);
+
+    void Insert(const int slot, const uint32_t hash);
+    size_t Locate(const int slot, const uint32_t hash) const; // Entry holding slot, or the table size.
+    void EraseAt(size_t position);
+
+    const std::vector<Profile>& m_profiles;
+    std::vector<Entry> m_table; // Size is a power of two, or zero.
+    size_t m_count = 0;
+};
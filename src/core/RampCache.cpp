@@ -0,0 +1,149 @@
+// Copyright (c) 2025 Max Godman
+
+#include "RampCache.h"
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace RampCache
+{
+    struct Key
+    {
+        int32_t brightness = 0;
+        uint32_t contrastBits = 0;
+        uint32_t gammaBits = 0;
+        uint32_t powMode = 0; // RampEngine::PowMode the entry was built with.
+
+        bool operator==(const Key& other) const
+        {
+            return brightness == other.brightness &&
+                contrastBits == other.contrastBits &&
+                gammaBits == other.gammaBits &&
+                powMode == other.powMode;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            // FNV-1a over the fields; plenty for a few dozen entries.
+            uint64_t hash = 14695981039346656037ull;
+            for (const uint32_t field : { (uint32_t)key.brightness, key.contrastBits, key.gammaBits, key.powMode })
+            {
+                hash ^= field;
+                hash *= 1099511628211ull;
+            }
+            return (size_t)hash;
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        float curve[RampEngine::RAMP_SIZE];
+        uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE];
+    };
+
+    // Most recently used at the front. The map points into the list, whose iterators stay valid
+    // across splices, so a hit only relinks a node.
+    static std::list<Entry> s_entries;
+    static std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> s_index;
+    static size_t s_capacity = DEFAULT_CAPACITY;
+    static Stats s_stats;
+
+    // Lookups happen on the UI thread today; the lock is uncontended and keeps the cache safe to
+    // share should ramps ever be built elsewhere.
+    static std::mutex s_mutex;
+
+    static Key MakeKey(const RampEngine::Params& params)
+    {
+        Key key;
+        key.brightness = params.brightness;
+        std::memcpy(&key.contrastBits, &params.contrast, sizeof(key.contrastBits));
+        std::memcpy(&key.gammaBits, &params.gamma, sizeof(key.gammaBits));
+        key.powMode = (uint32_t)RampEngine::GetPowMode();
+        return key;
+    }
+
+    static void EvictToCapacity()
+    {
+        while (s_entries.size() > s_capacity)
+        {
+            s_index.erase(s_entries.back().key);
+            s_entries.pop_back();
+            ++s_stats.evictions;
+        }
+    }
+
+    // Find or build the entry for params and move it to the front. Caller holds s_mutex.
+    static const Entry& Acquire(const RampEngine::Params& params)
+    {
+        const Key key = MakeKey(params);
+
+        const auto it = s_index.find(key);
+        if (it != s_index.end())
+        {
+            ++s_stats.hits;
+            s_entries.splice(s_entries.begin(), s_entries, it->second);
+            return s_entries.front();
+        }
+
+        ++s_stats.misses;
+        s_entries.emplace_front();
+        Entry& entry = s_entries.front();
+        entry.key = key;
+        RampEngine::BuildCurve(params, entry.curve);
+        RampEngine::CurveToRamp(entry.curve, entry.ramp);
+        s_index[key] = s_entries.begin();
+
+        EvictToCapacity();
+        return s_entries.front();
+    }
+
+    void GetCurve(const RampEngine::Params& params, float curve[RampEngine::RAMP_SIZE])
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        const Entry& entry = Acquire(params);
+        std::memcpy(curve, entry.curve, sizeof(entry.curve));
+    }
+
+    void GetRamp(const RampEngine::Params& params, float curve[RampEngine::RAMP_SIZE],
+                 uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE])
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        const Entry& entry = Acquire(params);
+        std::memcpy(curve, entry.curve, sizeof(entry.curve));
+        std::memcpy(ramp, entry.ramp, sizeof(entry.ramp));
+    }
+
+    void SetCapacity(const size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_capacity = capacity > 0 ? capacity : 1;
+        EvictToCapacity();
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_index.clear();
+        s_entries.clear();
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        Stats stats = s_stats;
+        stats.size = s_entries.size();
+        stats.capacity = s_capacity;
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_stats = Stats();
+    }
+}
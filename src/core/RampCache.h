@@ -0,0 +1,79 @@
+// Copyright (c) 2025 Max Godman
+
+// Bounded LRU cache of finished gamma ramps, keyed by their brightness/contrast/gamma.
+
+/**
+ * Every profile apply, profile cycle and slider change needs a ramp, and users tend to bounce between
+ * the same handful of profiles. A ramp is a pure function of its three parameters, so one cache shared
+ * by every display and profile turns a repeat build (256 powf calls) into a table copy.
+ *
+ * KEYS:
+ * Parameters are quantized to their exact float bit patterns rather than to a coarser grid. A coarser
+ * step would let two slider positions share an entry, and a hit would then hand back a ramp that
+ * differs from what a fresh build produces. Bit-exact keys keep a hit indistinguishable from a miss,
+ * and still hit on every real repeat: saved profiles, defaults and restored values are the same floats
+ * each time. The key also carries RampEngine's power mode, since the fast mode builds slightly
+ * different ramps.
+ */
+
+#pragma once
+
+#include "RampEngine.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace RampCache
+{
+    // Entries kept before the least recently used one is evicted. Each holds a curve and a ramp
+    // (about 2.5 KB), so the default bounds the cache to roughly 160 KB.
+    constexpr size_t DEFAULT_CAPACITY = 64;
+
+    /**
+     * @brief Counters for observing the cache, e.g. that profile switches become hits.
+     */
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t size = 0;
+        size_t capacity = 0;
+    };
+
+    /**
+     * @brief Get the normalized curve for the given parameters, building and caching it on a miss.
+     * @param[in] params Brightness, contrast and gamma.
+     * @param[out] curve Output array of RampEngine::RAMP_SIZE values.
+     */
+    void GetCurve(const RampEngine::Params& params, float curve[RampEngine::RAMP_SIZE]);
+
+    /**
+     * @brief Get the normalized curve and the 16-bit ramp for the given parameters, building and
+     *        caching them on a miss.
+     * @param[in] params Brightness, contrast and gamma.
+     * @param[out] curve Output array of RampEngine::RAMP_SIZE values.
+     * @param[out] ramp Output array [3][256].
+     */
+    void GetRamp(const RampEngine::Params& params, float curve[RampEngine::RAMP_SIZE],
+                 uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]);
+
+    /**
+     * @brief Change the number of entries kept, evicting the oldest if it shrinks. Minimum 1.
+     */
+    void SetCapacity(const size_t capacity);
+
+    /**
+     * @brief Drop every entry. Counters are kept; see ResetStats.
+     */
+    void Clear();
+
+    /**
+     * @brief Current counters, size and capacity.
+     */
+    Stats GetStats();
+
+    /**
+     * @brief Zero the hit, miss and eviction counters.
+     */
+    void ResetStats();
+}
@@ -0,0 +1,507 @@
+// Copyright (c) 2025 Max Godman
+
+#include "RampEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+#include <math.h>
+
+// The batch kernels are bit-exact with the scalar reference only if neither contracts a * b + c
+// into a fused multiply-add (see the header). Pin that here rather than trusting the build flags;
+// CMakeLists.txt also passes -ffp-contract=off, which is the only switch older GCCs honour.
+#if defined(__clang__)
+    #pragma clang fp contract(off)
+#elif defined(_MSC_VER)
+    #pragma fp_contract(off)
+#elif defined(__GNUC__)
+    #pragma GCC optimize("fp-contract=off")
+#endif
+
+// Pick the widest batch kernel the build targets. This is decided at compile time from the
+// compiler's own architecture macros (MSVC /arch, GCC/Clang -m flags), so there is no runtime
+// CPU dispatch: an x64 build always has SSE2, and /arch:AVX2 upgrades it to AVX2.
+#if defined(__AVX2__)
+    #define RAMPENGINE_AVX2 1
+    #include <immintrin.h>
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define RAMPENGINE_SSE2 1
+    #include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define RAMPENGINE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace RampEngine
+{
+    // Remap brightness from (-50 to +50) to (-0.25 to +0.25).
+    static float GetBrightnessOffset(const Params& params)
+    {
+        return params.brightness / 200.0f;
+    }
+
+    // Step 4 of the curve, shared by both paths so they cannot drift apart. powf stays exact here
+    // (see the header); the skipped cases are ones where powf is exact by definition: 0 and 1 are
+    // fixed points of any positive power, and an exponent of exactly 1 (gamma 1.0, the default)
+    // returns its input.
+    static void ApplyGammaCurve(const float exponent, float curve[RAMP_SIZE])
+    {
+        if (exponent == 1.0f)
+            return;
+
+        for (int i = 0; i < RAMP_SIZE; ++i)
+        {
+            const float v = curve[i];
+            if (v > 0.0f && v < 1.0f)
+                curve[i] = powf(v, exponent);
+        }
+    }
+
+    static std::atomic<PowMode> s_powMode = PowMode::Exact;
+
+    // Fast power path: v^e = exp2(e * log2(v)), both halves as short polynomials.
+    //
+    // log2: v = m * 2^k with m in [sqrt(1/2), sqrt(2)), then log2(m) = 2/ln2 * atanh(t) with
+    // t = (m - 1) / (m + 1), |t| <= 0.172. The odd series through t^9 leaves a truncation error
+    // near 1e-9, and m - 1 is exact, so values close to 1 keep full relative precision.
+    //
+    // exp2: y = n + f with n = round(y), |f| <= 0.5, and 2^f from its Taylor series through f^7
+    // (relative truncation error near 5e-9). 2^n goes straight into the exponent bits.
+    //
+    // What remains is float rounding of y = e * log2(v) itself. Every result at or above half a
+    // ramp step has y > -17, so that is at most a few ulp of 17 in y, i.e. a relative error under
+    // 1e-6 in the result: about 0.05 of a 16-bit ramp step, well inside the half step that would
+    // let it change a rounded entry by more than one. Results that small are 0 in the ramp anyway.
+    // Inputs below FLT_MIN are raised to it (their powers are below 1e-12 for any exponent >= 1/3),
+    // and y is floored at -126 to stay clear of denormals.
+    static constexpr float FAST_SQRT2 = 1.41421356f;
+    static constexpr float LOG2_C1 = 2.88539008f;  // 2/ln2
+    static constexpr float LOG2_C3 = 0.961796694f; // 2/ln2 / 3
+    static constexpr float LOG2_C5 = 0.577078017f; // 2/ln2 / 5
+    static constexpr float LOG2_C7 = 0.412198583f; // 2/ln2 / 7
+    static constexpr float LOG2_C9 = 0.320598898f; // 2/ln2 / 9
+    static constexpr float EXP2_C1 = 0.693147181f; // ln2^k / k!
+    static constexpr float EXP2_C2 = 0.240226507f;
+    static constexpr float EXP2_C3 = 0.0555041087f;
+    static constexpr float EXP2_C4 = 0.00961812911f;
+    static constexpr float EXP2_C5 = 0.00133335581f;
+    static constexpr float EXP2_C6 = 0.000154035304f;
+    static constexpr float EXP2_C7 = 0.0000152527338f;
+    static constexpr float FAST_Y_MIN = -126.0f;
+
+    [[maybe_unused]] static float FastPow(const float value, const float exponent)
+    {
+        uint32_t bits;
+        const float v = std::max(value, FLT_MIN);
+        std::memcpy(&bits, &v, sizeof(bits));
+
+        float k = (float)((int)(bits >> 23) - 127);
+        bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+        const bool big = m > FAST_SQRT2;
+        m = big ? m * 0.5f : m;
+        k = big ? k + 1.0f : k;
+
+        const float t = (m - 1.0f) / (m + 1.0f);
+        const float t2 = t * t;
+        const float log2m = t * (LOG2_C1 + t2 * (LOG2_C3 + t2 * (LOG2_C5 + t2 * (LOG2_C7 + t2 * LOG2_C9))));
+
+        const float y = std::max(exponent * (k + log2m), FAST_Y_MIN);
+        const float shifted = y + 0.5f;
+        int ni = (int)shifted;
+        ni -= ((float)ni > shifted) ? 1 : 0; // Floor: truncation rounds negative values up.
+        const float n = (float)ni;
+        const float f = y - n;
+        const float p = 1.0f + f * (EXP2_C1 + f * (EXP2_C2 + f * (EXP2_C3 + f * (EXP2_C4 +
+                        f * (EXP2_C5 + f * (EXP2_C6 + f * EXP2_C7))))));
+
+        const uint32_t scaleBits = (uint32_t)(ni + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &scaleBits, sizeof(scale));
+        return p * scale;
+    }
+
+    // Step 4 with the fast power. Same skips as ApplyGammaCurve: 0, 1 and an exponent of 1 stay exact.
+    static void ApplyGammaCurveFast(const float exponent, float curve[RAMP_SIZE])
+    {
+        if (exponent == 1.0f)
+            return;
+
+#if defined(RAMPENGINE_AVX2)
+        const __m256 e = _mm256_set1_ps(exponent);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 minValue = _mm256_set1_ps(FLT_MIN);
+        const __m256 sqrt2 = _mm256_set1_ps(FAST_SQRT2);
+        const __m256 yMin = _mm256_set1_ps(FAST_Y_MIN);
+        const __m256i mantissaMask = _mm256_set1_epi32(0x007FFFFF);
+        const __m256i oneBits = _mm256_set1_epi32(0x3F800000);
+        const __m256i bias = _mm256_set1_epi32(127);
+
+        for (int i = 0; i < RAMP_SIZE; i += 8)
+        {
+            const __m256 value = _mm256_loadu_ps(curve + i);
+            const __m256i bits = _mm256_castps_si256(_mm256_max_ps(value, minValue));
+
+            __m256 k = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), bias));
+            __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, mantissaMask), oneBits));
+            const __m256 big = _mm256_cmp_ps(m, sqrt2, _CMP_GT_OQ);
+            m = _mm256_blendv_ps(m, _mm256_mul_ps(m, half), big);
+            k = _mm256_add_ps(k, _mm256_and_ps(big, one));
+
+            const __m256 t = _mm256_div_ps(_mm256_sub_ps(m, one), _mm256_add_ps(m, one));
+            const __m256 t2 = _mm256_mul_ps(t, t);
+            __m256 poly = _mm256_add_ps(_mm256_set1_ps(LOG2_C7), _mm256_mul_ps(t2, _mm256_set1_ps(LOG2_C9)));
+            poly = _mm256_add_ps(_mm256_set1_ps(LOG2_C5), _mm256_mul_ps(t2, poly));
+            poly = _mm256_add_ps(_mm256_set1_ps(LOG2_C3), _mm256_mul_ps(t2, poly));
+            poly = _mm256_add_ps(_mm256_set1_ps(LOG2_C1), _mm256_mul_ps(t2, poly));
+            const __m256 log2m = _mm256_mul_ps(t, poly);
+
+            const __m256 y = _mm256_max_ps(_mm256_mul_ps(e, _mm256_add_ps(k, log2m)), yMin);
+            const __m256 n = _mm256_floor_ps(_mm256_add_ps(y, half));
+            const __m256 f = _mm256_sub_ps(y, n);
+            __m256 p = _mm256_add_ps(_mm256_set1_ps(EXP2_C6), _mm256_mul_ps(f, _mm256_set1_ps(EXP2_C7)));
+            p = _mm256_add_ps(_mm256_set1_ps(EXP2_C5), _mm256_mul_ps(f, p));
+            p = _mm256_add_ps(_mm256_set1_ps(EXP2_C4), _mm256_mul_ps(f, p));
+            p = _mm256_add_ps(_mm256_set1_ps(EXP2_C3), _mm256_mul_ps(f, p));
+            p = _mm256_add_ps(_mm256_set1_ps(EXP2_C2), _mm256_mul_ps(f, p));
+            p = _mm256_add_ps(_mm256_set1_ps(EXP2_C1), _mm256_mul_ps(f, p));
+            p = _mm256_add_ps(one, _mm256_mul_ps(f, p));
+
+            const __m256i scaleBits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), bias), 23);
+            const __m256 result = _mm256_mul_ps(p, _mm256_castsi256_ps(scaleBits));
+
+            // Keep 0 and 1 (and anything outside them) exactly as they were.
+            const __m256 inside = _mm256_and_ps(_mm256_cmp_ps(value, zero, _CMP_GT_OQ), _mm256_cmp_ps(value, one, _CMP_LT_OQ));
+            _mm256_storeu_ps(curve + i, _mm256_blendv_ps(value, result, inside));
+        }
+#elif defined(RAMPENGINE_SSE2)
+        const __m128 e = _mm_set1_ps(exponent);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 minValue = _mm_set1_ps(FLT_MIN);
+        const __m128 sqrt2 = _mm_set1_ps(FAST_SQRT2);
+        const __m128 yMin = _mm_set1_ps(FAST_Y_MIN);
+        const __m128i mantissaMask = _mm_set1_epi32(0x007FFFFF);
+        const __m128i oneBits = _mm_set1_epi32(0x3F800000);
+        const __m128i bias = _mm_set1_epi32(127);
+
+        // SSE2 has no blend or floor: selects are and/andnot/or, and y + 0.5 is floored by truncating
+        // and stepping down where truncation rounded a negative value up.
+        for (int i = 0; i < RAMP_SIZE; i += 4)
+        {
+            const __m128 value = _mm_loadu_ps(curve + i);
+            const __m128i bits = _mm_castps_si128(_mm_max_ps(value, minValue));
+
+            __m128 k = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), bias));
+            __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), oneBits));
+            const __m128 big = _mm_cmpgt_ps(m, sqrt2);
+            m = _mm_or_ps(_mm_andnot_ps(big, m), _mm_and_ps(big, _mm_mul_ps(m, half)));
+            k = _mm_add_ps(k, _mm_and_ps(big, one));
+
+            const __m128 t = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+            const __m128 t2 = _mm_mul_ps(t, t);
+            __m128 poly = _mm_add_ps(_mm_set1_ps(LOG2_C7), _mm_mul_ps(t2, _mm_set1_ps(LOG2_C9)));
+            poly = _mm_add_ps(_mm_set1_ps(LOG2_C5), _mm_mul_ps(t2, poly));
+            poly = _mm_add_ps(_mm_set1_ps(LOG2_C3), _mm_mul_ps(t2, poly));
+            poly = _mm_add_ps(_mm_set1_ps(LOG2_C1), _mm_mul_ps(t2, poly));
+            const __m128 log2m = _mm_mul_ps(t, poly);
+
+            const __m128 y = _mm_max_ps(_mm_mul_ps(e, _mm_add_ps(k, log2m)), yMin);
+            const __m128 shifted = _mm_add_ps(y, half);
+            __m128i ni = _mm_cvttps_epi32(shifted);
+            const __m128 truncated = _mm_cvtepi32_ps(ni);
+            ni = _mm_add_epi32(ni, _mm_castps_si128(_mm_cmpgt_ps(truncated, shifted))); // -1 where truncation rounded up.
+            const __m128 n = _mm_cvtepi32_ps(ni);
+            const __m128 f = _mm_sub_ps(y, n);
+            __m128 p = _mm_add_ps(_mm_set1_ps(EXP2_C6), _mm_mul_ps(f, _mm_set1_ps(EXP2_C7)));
+            p = _mm_add_ps(_mm_set1_ps(EXP2_C5), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(EXP2_C4), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(EXP2_C3), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(EXP2_C2), _mm_mul_ps(f, p));
+            p = _mm_add_ps(_mm_set1_ps(EXP2_C1), _mm_mul_ps(f, p));
+            p = _mm_add_ps(one, _mm_mul_ps(f, p));
+
+            const __m128i scaleBits = _mm_slli_epi32(_mm_add_epi32(ni, bias), 23);
+            const __m128 result = _mm_mul_ps(p, _mm_castsi128_ps(scaleBits));
+
+            // Keep 0 and 1 (and anything outside them) exactly as they were.
+            const __m128 inside = _mm_and_ps(_mm_cmpgt_ps(value, zero), _mm_cmplt_ps(value, one));
+            _mm_storeu_ps(curve + i, _mm_or_ps(_mm_andnot_ps(inside, value), _mm_and_ps(inside, result)));
+        }
+#else
+        // NEON and scalar builds: the same arithmetic per entry; branch-free enough for the compiler
+        // to vectorize where it can.
+        for (int i = 0; i < RAMP_SIZE; ++i)
+        {
+            const float v = curve[i];
+            const float result = FastPow(v, exponent);
+            curve[i] = (v > 0.0f && v < 1.0f) ? result : v;
+        }
+#endif
+    }
+
+    Kernel GetActiveKernel()
+    {
+#if defined(RAMPENGINE_AVX2)
+        return Kernel::AVX2;
+#elif defined(RAMPENGINE_SSE2)
+        return Kernel::SSE2;
+#elif defined(RAMPENGINE_NEON)
+        return Kernel::NEON;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    const char* GetKernelName(const Kernel kernel)
+    {
+        switch (kernel)
+        {
+        case Kernel::SSE2: return "SSE2";
+        case Kernel::AVX2: return "AVX2";
+        case Kernel::NEON: return "NEON";
+        case Kernel::Scalar:
+        default:           return "Scalar";
+        }
+    }
+
+    void SetPowMode(const PowMode mode)
+    {
+        s_powMode = mode;
+    }
+
+    PowMode GetPowMode()
+    {
+        return s_powMode;
+    }
+
+    const char* GetPowModeName(const PowMode mode)
+    {
+        return (mode == PowMode::Fast) ? "Fast" : "Exact";
+    }
+
+    void BuildCurveScalar(const Params& params, float curve[RAMP_SIZE])
+    {
+        const float brightnessOffset = GetBrightnessOffset(params);
+        const float contrast = params.contrast;
+        const float exponent = 1.0f / params.gamma;
+
+        for (int i = 0; i < RAMP_SIZE; ++i)
+        {
+            // Start with normalized input (0.0 to 1.0).
+            float v = i / 255.0f;
+
+            // 1. Apply brightness (linear offset).
+            v += brightnessOffset;
+
+            // 2. Apply contrast (scale around midpoint 0.5).
+            // Formula: output = (input - 0.5) * contrast + 0.5
+            // This keeps midpoint unchanged while expanding/compressing range.
+            v = (v - 0.5f) * contrast + 0.5f;
+
+            // 3. Clamp to valid range [0, 1].
+            v = std::max(0.0f, std::min(1.0f, v));
+
+            // 4. Apply gamma curve (power function).
+            curve[i] = powf(v, exponent);
+        }
+    }
+
+    void BuildCurve(const Params& params, float curve[RAMP_SIZE])
+    {
+        const float brightnessOffset = GetBrightnessOffset(params);
+        const float contrast = params.contrast;
+
+        // Steps 1-3 (brightness, contrast, clamp) in batches. Each lane performs exactly the scalar
+        // operations in the scalar order: the min/max operand order reproduces std::min/std::max.
+#if defined(RAMPENGINE_AVX2)
+        const __m256 offset = _mm256_set1_ps(brightnessOffset);
+        const __m256 scale = _mm256_set1_ps(contrast);
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 divisor = _mm256_set1_ps(255.0f);
+        const __m256 step = _mm256_set1_ps(8.0f);
+        __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+        for (int i = 0; i < RAMP_SIZE; i += 8)
+        {
+            __m256 v = _mm256_div_ps(index, divisor);
+            v = _mm256_add_ps(v, offset);
+            v = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(v, half), scale), half);
+            v = _mm256_max_ps(_mm256_min_ps(v, one), zero);
+            _mm256_storeu_ps(curve + i, v);
+            index = _mm256_add_ps(index, step);
+        }
+#elif defined(RAMPENGINE_SSE2)
+        const __m128 offset = _mm_set1_ps(brightnessOffset);
+        const __m128 scale = _mm_set1_ps(contrast);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 divisor = _mm_set1_ps(255.0f);
+        const __m128 step = _mm_set1_ps(4.0f);
+        __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+        for (int i = 0; i < RAMP_SIZE; i += 4)
+        {
+            __m128 v = _mm_div_ps(index, divisor);
+            v = _mm_add_ps(v, offset);
+            v = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(v, half), scale), half);
+            v = _mm_max_ps(_mm_min_ps(v, one), zero);
+            _mm_storeu_ps(curve + i, v);
+            index = _mm_add_ps(index, step);
+        }
+#elif defined(RAMPENGINE_NEON)
+        const float32x4_t offset = vdupq_n_f32(brightnessOffset);
+        const float32x4_t scale = vdupq_n_f32(contrast);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t divisor = vdupq_n_f32(255.0f);
+        const float32x4_t step = vdupq_n_f32(4.0f);
+        const float indexInit[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+        float32x4_t index = vld1q_f32(indexInit);
+
+        for (int i = 0; i < RAMP_SIZE; i += 4)
+        {
+            float32x4_t v = vdivq_f32(index, divisor);
+            v = vaddq_f32(v, offset);
+            v = vaddq_f32(vmulq_f32(vsubq_f32(v, half), scale), half);
+            v = vmaxq_f32(vminq_f32(v, one), zero);
+            vst1q_f32(curve + i, v);
+            index = vaddq_f32(index, step);
+        }
+#else
+        for (int i = 0; i < RAMP_SIZE; ++i)
+        {
+            float v = i / 255.0f;
+            v += brightnessOffset;
+            v = (v - 0.5f) * contrast + 0.5f;
+            curve[i] = std::max(0.0f, std::min(1.0f, v));
+        }
+#endif
+
+        // Step 4, the gamma power curve.
+        if (s_powMode == PowMode::Fast)
+            ApplyGammaCurveFast(1.0f / params.gamma, curve);
+        else
+            ApplyGammaCurve(1.0f / params.gamma, curve);
+    }
+
+    void CurveToRampScalar(const float curve[RAMP_SIZE], uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        for (int index = 0; index < RAMP_SIZE; ++index)
+        {
+            // Convert to the 16-bit gamma ramp format (0-65535).
+            const uint16_t val = (uint16_t)(curve[index] * RAMP_MAX + 0.5f);
+
+            // Apply same value to all three color channels.
+            // Could be extended to support per-channel adjustments for color tinting.
+            ramp[0][index] = val;  // Red.
+            ramp[1][index] = val;  // Green.
+            ramp[2][index] = val;  // Blue.
+        }
+    }
+
+    void CurveToRamp(const float curve[RAMP_SIZE], uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        // Same scale, round and truncate as the scalar path; only the narrowing to 16 bits differs,
+        // and that is exact because every value is already within 0..65535.
+#if defined(RAMPENGINE_AVX2)
+        const __m256 scale = _mm256_set1_ps((float)RAMP_MAX);
+        const __m256 round = _mm256_set1_ps(0.5f);
+
+        for (int i = 0; i < RAMP_SIZE; i += 16)
+        {
+            const __m256i lo = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(curve + i), scale), round));
+            const __m256i hi = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(curve + i + 8), scale), round));
+
+            // packus interleaves the two sources per 128-bit lane; the permute restores input order.
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+            for (int channel = 0; channel < RAMP_CHANNELS; ++channel)
+                _mm256_storeu_si256((__m256i*)(ramp[channel] + i), packed);
+        }
+#elif defined(RAMPENGINE_SSE2)
+        const __m128 scale = _mm_set1_ps((float)RAMP_MAX);
+        const __m128 round = _mm_set1_ps(0.5f);
+
+        // SSE2 only has a signed 32->16 pack, so shift into the signed range and back.
+        const __m128i bias32 = _mm_set1_epi32(32768);
+        const __m128i bias16 = _mm_set1_epi16((short)0x8000);
+
+        for (int i = 0; i < RAMP_SIZE; i += 8)
+        {
+            const __m128i lo = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(curve + i), scale), round));
+            const __m128i hi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(curve + i + 4), scale), round));
+            const __m128i packed = _mm_add_epi16(
+                _mm_packs_epi32(_mm_sub_epi32(lo, bias32), _mm_sub_epi32(hi, bias32)), bias16);
+            for (int channel = 0; channel < RAMP_CHANNELS; ++channel)
+                _mm_storeu_si128((__m128i*)(ramp[channel] + i), packed);
+        }
+#elif defined(RAMPENGINE_NEON)
+        const float32x4_t scale = vdupq_n_f32((float)RAMP_MAX);
+        const float32x4_t round = vdupq_n_f32(0.5f);
+
+        for (int i = 0; i < RAMP_SIZE; i += 8)
+        {
+            const uint32x4_t lo = vcvtq_u32_f32(vaddq_f32(vmulq_f32(vld1q_f32(curve + i), scale), round));
+            const uint32x4_t hi = vcvtq_u32_f32(vaddq_f32(vmulq_f32(vld1q_f32(curve + i + 4), scale), round));
+            const uint16x8_t packed = vcombine_u16(vmovn_u32(lo), vmovn_u32(hi));
+            for (int channel = 0; channel < RAMP_CHANNELS; ++channel)
+                vst1q_u16(ramp[channel] + i, packed);
+        }
+#else
+        CurveToRampScalar(curve, ramp);
+#endif
+    }
+
+    void BuildIdentityRamp(uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        for (int i = 0; i < RAMP_SIZE; ++i)
+        {
+            const uint16_t val = (uint16_t)(i * 257);
+            ramp[0][i] = val;
+            ramp[1][i] = val;
+            ramp[2][i] = val;
+        }
+    }
+
+    void LerpRamp(const uint16_t from[RAMP_CHANNELS][RAMP_SIZE], const uint16_t to[RAMP_CHANNELS][RAMP_SIZE],
+                  const int step, const int steps, uint16_t out[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        // Weights sum to steps, so the blend never leaves 0..65535; 32 bits hold 65535 * steps for
+        // any step count a transition uses. Plain loops: compilers vectorize these well enough.
+        const uint32_t toWeight = (uint32_t)step;
+        const uint32_t fromWeight = (uint32_t)(steps - step);
+        const uint32_t divisor = (uint32_t)steps;
+        const uint32_t round = divisor / 2;
+
+        for (int channel = 0; channel < RAMP_CHANNELS; ++channel)
+        {
+            for (int i = 0; i < RAMP_SIZE; ++i)
+                out[channel][i] = (uint16_t)((from[channel][i] * fromWeight + to[channel][i] * toWeight + round) / divisor);
+        }
+    }
+
+    uint64_t HashRamp(const uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        // FNV-1a, fed 64 bits at a time rather than per byte: 192 rounds for the whole ramp.
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(ramp);
+        constexpr size_t byteCount = sizeof(uint16_t) * RAMP_CHANNELS * RAMP_SIZE;
+
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t offset = 0; offset < byteCount; offset += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, bytes + offset, sizeof(word));
+            hash ^= word;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2025 Max Godman
+
+// Portable gamma ramp math: brightness, contrast and gamma evaluated over the whole ramp.
+
+/**
+ * This is the pure math behind GammaManager, kept free of <windows.h> and of any App:: state so it
+ * can be compiled, measured and unit-tested on its own, on any platform. GammaManager owns the
+ * Windows side (WORD ramps, App::state.lastRamp, SetDeviceGammaRamp) and calls into here.
+ *
+ * KERNELS:
+ * Every entry point has a scalar reference path, the original per-entry loop, and a batch path
+ * that evaluates the ramp several entries at a time with SSE2, AVX2 or NEON, whichever the build
+ * targets (chosen at compile time, see GetActiveKernel). The batch path is bit-exact with the
+ * scalar one: it performs the same IEEE operations in the same order, and keeps powf() per lane
+ * rather than approximating it. Bit-exactness assumes no floating-point contraction, since a fused
+ * multiply-add rounds once where the reference rounds twice; RampEngine.cpp turns it off for itself,
+ * and tests/RampEngineTest.cpp checks the kernels against the reference on every build.
+ *
+ * FAST POWER:
+ * The gamma power curve (256 powf calls) dominates a build. SetPowMode(PowMode::Fast) swaps it for a
+ * polynomial log2/exp2 evaluated in the same batches. It is not bit-exact: its error against powf
+ * stays below half a 16-bit ramp step, so an entry of the finished ramp can move by at most one
+ * step. Exact is the default; the switch exists to compare throughput and is read on every build.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace RampEngine
+{
+    constexpr int RAMP_SIZE = 256;    // One entry per 8-bit input value.
+    constexpr int RAMP_MAX = 65535;   // Each entry is 16-bit (0-65535).
+    constexpr int RAMP_CHANNELS = 3;  // Red, green, blue.
+
+    /**
+     * @brief The adjustments a ramp is built from, mirroring the Profile fields.
+     */
+    struct Params
+    {
+        int brightness = 0;    // Linear offset, -50 to +50.
+        float contrast = 1.0f; // Multiplier around the midpoint, 0.5 to 1.5.
+        float gamma = 1.0f;    // Power curve, 0.1 to 3.0.
+    };
+
+    /**
+     * @brief The batch kernels a build can carry.
+     */
+    enum class Kernel
+    {
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON,
+    };
+
+    /**
+     * @brief How BuildCurve evaluates the gamma power curve.
+     */
+    enum class PowMode
+    {
+        Exact, // powf per entry; bit-exact with BuildCurveScalar.
+        Fast,  // Polynomial log2/exp2; error under half a 16-bit ramp step.
+    };
+
+    /**
+     * @brief Select the power evaluation for subsequent BuildCurve calls. Thread-safe.
+     * @note RampCache keys on the mode, so switching never serves a ramp built the other way.
+     */
+    void SetPowMode(const PowMode mode);
+
+    /**
+     * @brief The power evaluation BuildCurve currently uses.
+     */
+    PowMode GetPowMode();
+
+    /**
+     * @brief Short display name for a power mode, e.g. "Fast".
+     */
+    const char* GetPowModeName(const PowMode mode);
+
+    /**
+     * @brief The batch kernel BuildCurve/CurveToRamp use in this build (Scalar if none is available).
+     */
+    Kernel GetActiveKernel();
+
+    /**
+     * @brief Short display name for a kernel, e.g. "AVX2".
+     */
+    const char* GetKernelName(const Kernel kernel);
+
+    /**
+     * @brief Compute the normalized (0.0 to 1.0) curve for all 256 inputs, one entry at a time.
+     * @param[in] params Brightness, contrast and gamma.
+     * @param[out] curve Output array of RAMP_SIZE values.
+     * @note The reference implementation; BuildCurve must match it bit for bit.
+     */
+    void BuildCurveScalar(const Params& params, float curve[RAMP_SIZE]);
+
+    /**
+     * @brief Compute the normalized (0.0 to 1.0) curve for all 256 inputs with the active batch kernel.
+     * @param[in] params Brightness, contrast and gamma.
+     * @param[out] curve Output array of RAMP_SIZE values.
+     * @note Uses the power evaluation selected by SetPowMode.
+     */
+    void BuildCurve(const Params& params, float curve[RAMP_SIZE]);
+
+    /**
+     * @brief Convert a normalized curve to the 16-bit ramp format, one entry at a time.
+     * @param[in] curve Normalized curve of RAMP_SIZE values.
+     * @param[out] ramp Output array [3][256]; the same value is written to every channel.
+     */
+    void CurveToRampScalar(const float curve[RAMP_SIZE], uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE]);
+
+    /**
+     * @brief Convert a normalized curve to the 16-bit ramp format with the active batch kernel.
+     * @param[in] curve Normalized curve of RAMP_SIZE values.
+     * @param[out] ramp Output array [3][256]; the same value is written to every channel.
+     */
+    void CurveToRamp(const float curve[RAMP_SIZE], uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE]);
+
+    /**
+     * @brief Fill a ramp with the default linear identity (i * 257), i.e. no adjustment.
+     * @param[out] ramp Output array [3][256].
+     */
+    void BuildIdentityRamp(uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE]);
+
+    /**
+     * @brief Blend two ramps entry by entry: from + (to - from) * step / steps, rounded to nearest.
+     * @param[in] from Ramp at step 0.
+     * @param[in] to Ramp at step == steps.
+     * @param[in] step Position in the blend, 0 to steps.
+     * @param[in] steps Number of steps in the whole blend, at least 1.
+     * @param[out] out Output array [3][256]; may alias neither input.
+     * @note Integer-only, so a fade between two finished ramps never recomputes the curve, and
+     *       both ends reproduce their input exactly.
+     */
+    void LerpRamp(const uint16_t from[RAMP_CHANNELS][RAMP_SIZE], const uint16_t to[RAMP_CHANNELS][RAMP_SIZE],
+                  const int step, const int steps, uint16_t out[RAMP_CHANNELS][RAMP_SIZE]);
+
+    /**
+     * @brief 64-bit content hash of a ramp (all channels), for cheap "same ramp?" checks.
+     * @note Not collision-free; confirm a match by comparing contents.
+     */
+    uint64_t HashRamp(const uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE]);
+}
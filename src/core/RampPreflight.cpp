@@ -0,0 +1,69 @@
+// Copyright (c) 2025 Max Godman
+
+#include "RampPreflight.h"
+#include <algorithm>
+
+namespace RampPreflight
+{
+    // Bounds on the full 16-bit entry at one index: its high byte may sit anywhere in
+    // [index - maxDeviation, index + maxDeviation], clipped to the 16-bit range.
+    static int LowerBound(const int index, const Limits& limits)
+    {
+        return std::max(0, index - limits.maxDeviation) << 8;
+    }
+
+    static int UpperBound(const int index, const Limits& limits)
+    {
+        return std::min(RampEngine::RAMP_MAX, ((index + limits.maxDeviation) << 8) | 0xFF);
+    }
+
+    Report Check(const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const Limits& limits)
+    {
+        Report report;
+        if (limits.maxDeviation >= UNLIMITED_DEVIATION)
+            return report;
+
+        for (int index = 0; index < RampEngine::RAMP_SIZE; ++index)
+        {
+            const int lower = LowerBound(index, limits);
+            const int upper = UpperBound(index, limits);
+            for (int channel = 0; channel < RampEngine::RAMP_CHANNELS; ++channel)
+            {
+                const int value = ramp[channel][index];
+                if (value >= lower && value <= upper)
+                    continue;
+
+                ++report.rejectedEntries;
+                if (report.firstRejectedIndex == -1)
+                    report.firstRejectedIndex = index;
+            }
+        }
+
+        report.accepted = (report.rejectedEntries == 0);
+        return report;
+    }
+
+    bool Clamp(uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const Limits& limits)
+    {
+        if (limits.maxDeviation >= UNLIMITED_DEVIATION)
+            return false;
+
+        bool changed = false;
+        for (int index = 0; index < RampEngine::RAMP_SIZE; ++index)
+        {
+            const int lower = LowerBound(index, limits);
+            const int upper = UpperBound(index, limits);
+            for (int channel = 0; channel < RampEngine::RAMP_CHANNELS; ++channel)
+            {
+                const int value = ramp[channel][index];
+                const int clamped = std::max(lower, std::min(upper, value));
+                if (clamped != value)
+                {
+                    ramp[channel][index] = (uint16_t)clamped;
+                    changed = true;
+                }
+            }
+        }
+        return changed;
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright (c) 2025 Max Godman
+
+// Offline model of which gamma ramps the driver will accept, and a clamp to the nearest one it will.
+
+/**
+ * SetDeviceGammaRamp() refuses ramps that stray too far from the identity, so that no application can
+ * leave the screen unreadable. Until now we only learned that from its return value: one wasted driver
+ * round-trip per apply, repeated every frame while a slider sat in a rejected region.
+ *
+ * THE RULE:
+ * Windows compares every entry of every channel against the identity ramp (i * 256) and rejects the
+ * whole ramp if any entry's high byte differs from its index by more than a fixed range. The range is
+ * 128 unless the machine-wide GdiIcmGammaRange registry value says otherwise; 256 or more disables the
+ * check. This matches what we observe on real drivers: dimming, raising or flattening the top or bottom
+ * of the curve by more than half the range fails, everything milder succeeds.
+ *
+ * The model is deliberately pure (no <windows.h>, no App:: state): the backend supplies the range, and
+ * GammaManager checks every ramp before it posts it. A driver that rejects a ramp the model accepted
+ * still surfaces through App::state.gammaRampFailed, as before.
+ */
+
+#pragma once
+
+#include "RampEngine.h"
+#include <cstdint>
+
+namespace RampPreflight
+{
+    constexpr int DEFAULT_MAX_DEVIATION = 128; // Windows' range when GdiIcmGammaRange is not set.
+    constexpr int UNLIMITED_DEVIATION = 256;   // Any range this large accepts every ramp.
+
+    /**
+     * @brief What a display will accept.
+     */
+    struct Limits
+    {
+        int maxDeviation = DEFAULT_MAX_DEVIATION; // Largest allowed |(entry >> 8) - index|.
+    };
+
+    /**
+     * @brief The verdict on one ramp.
+     */
+    struct Report
+    {
+        bool accepted = true;
+        int rejectedEntries = 0;     // Entries outside the limits, all channels counted.
+        int firstRejectedIndex = -1; // Lowest index with an entry outside the limits, -1 if none.
+    };
+
+    /**
+     * @brief Predict whether a display with the given limits would accept a ramp.
+     * @param[in] ramp Ramp [3][256] about to be applied.
+     * @param[in] limits The display's limits.
+     */
+    Report Check(const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const Limits& limits);
+
+    /**
+     * @brief Move every out-of-limits entry to the nearest value the limits allow.
+     * @param[in,out] ramp Ramp [3][256]; entries already inside the limits are left untouched.
+     * @param[in] limits The display's limits.
+     * @return true if any entry changed.
+     * @note A non-decreasing ramp stays non-decreasing, since both bounds rise with the index.
+     */
+    bool Clamp(uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const Limits& limits);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2025 Max Godman
+
+#include "RedrawPolicy.h"
+#include <algorithm>
+
+namespace RedrawPolicy
+{
+    static constexpr uint64_t NOT_DUE = UINT64_MAX;
+
+    static int s_pendingFrames = SETTLE_FRAMES; // The first frame needs no request.
+    static uint64_t s_dueMs = NOT_DUE;          // When the next animation frame is due.
+    static bool s_visible = false;
+    static uint64_t s_lastInputMs = 0;
+    static uint64_t s_accountedMs = 0;          // Idle time is added up to here.
+    static Stats s_stats;
+
+    // Idle time between s_accountedMs and nowMs: the part after the idle threshold, while visible.
+    static uint64_t IdleSince(const uint64_t nowMs)
+    {
+        if (!s_visible)
+            return 0;
+        const uint64_t from = std::max(s_accountedMs, s_lastInputMs + IDLE_AFTER_MS);
+        return nowMs > from ? nowMs - from : 0;
+    }
+
+    static void Advance(const uint64_t nowMs)
+    {
+        s_stats.idleMs += IdleSince(nowMs);
+        s_accountedMs = std::max(s_accountedMs, nowMs);
+    }
+
+    void OnInput(const uint64_t nowMs)
+    {
+        Advance(nowMs);
+        s_lastInputMs = nowMs;
+        RequestFrames();
+    }
+
+    void RequestFrames(const int frames)
+    {
+        s_pendingFrames = std::max(s_pendingFrames, frames);
+    }
+
+    void RequestFrameIn(const uint64_t nowMs, const uint32_t delayMs)
+    {
+        s_dueMs = std::min(s_dueMs, nowMs + delayMs);
+    }
+
+    void SetVisible(const bool visible, const uint64_t nowMs)
+    {
+        if (visible == s_visible)
+            return;
+
+        Advance(nowMs);
+        s_visible = visible;
+        if (visible)
+        {
+            // Being shown is not idle: draw the window, and start the idle clock over.
+            s_lastInputMs = nowMs;
+            RequestFrames();
+        }
+    }
+
+    bool ShouldRender(const uint64_t nowMs)
+    {
+        return s_pendingFrames > 0 || nowMs >= s_dueMs;
+    }
+
+    void OnFrameRendered(const uint64_t nowMs)
+    {
+        Advance(nowMs);
+        ++s_stats.frames;
+        if (s_visible && nowMs >= s_lastInputMs + IDLE_AFTER_MS)
+            ++s_stats.idleFrames;
+
+        if (s_pendingFrames > 0)
+            --s_pendingFrames;
+        if (nowMs >= s_dueMs)
+            s_dueMs = NOT_DUE; // The renderer asks again if it is still animating.
+    }
+
+    uint32_t GetWaitTimeout(const uint64_t nowMs)
+    {
+        if (s_pendingFrames > 0 || nowMs >= s_dueMs)
+            return 0;
+        if (s_dueMs == NOT_DUE)
+            return NO_TIMEOUT;
+        return (uint32_t)std::min<uint64_t>(s_dueMs - nowMs, NO_TIMEOUT - 1);
+    }
+
+    Stats GetStats(const uint64_t nowMs)
+    {
+        Stats stats = s_stats;
+        stats.idleMs += IdleSince(nowMs);
+        if (stats.idleMs > 0)
+            stats.idleFramesPerMinute = stats.idleFrames * 60000.0 / (double)stats.idleMs;
+        return stats;
+    }
+}
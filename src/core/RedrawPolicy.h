@@ -0,0 +1,92 @@
+// Copyright (c) 2025 Max Godman
+
+// Decides when the main window needs a new frame, and counts the frames rendered while idle.
+
+/**
+ * The main loop used to render and Present every vsync whenever the window was visible, so an
+ * untouched window cost a core's worth of wakeups and a GPU present 60+ times a second. ImGui only
+ * draws something new when its inputs change, so a frame is now rendered only when one is asked for:
+ *
+ * - Input (mouse, keyboard) and window changes (size, focus, DPI, paint): WndProc reports them.
+ * - App state changes: UI::SyncUIToState and every gamma apply call RequestFrames, and so does
+ *   WndProc when a worker reports that the driver refused (or again accepted) a ramp.
+ * - Running animations: after each frame the renderer says when it next needs one without input
+ *   (every frame while a slider is held, a caret blink while a text field has focus).
+ *
+ * Each request is a few frames (SETTLE_FRAMES), not one: ImGui settles hover state and opens popups
+ * a frame after the input that caused them. Between frames the loop blocks until a message arrives
+ * or the next animation frame is due (GetWaitTimeout).
+ *
+ * IDLE COUNTER:
+ * The window is idle once it is visible and has had no input for IDLE_AFTER_MS. GetStats reports how
+ * many frames were rendered per minute of idle time, which was the refresh rate times 60 before.
+ *
+ * UI thread only. Portable (no <windows.h>): the caller supplies the clock, in milliseconds.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace RedrawPolicy
+{
+    // Frames rendered after each request.
+    constexpr int SETTLE_FRAMES = 3;
+
+    // Input-free time after which the window counts as idle.
+    constexpr uint64_t IDLE_AFTER_MS = 1000;
+
+    // GetWaitTimeout when no frame is due without a message (INFINITE on Windows).
+    constexpr uint32_t NO_TIMEOUT = 0xFFFFFFFF;
+
+    /**
+     * @brief Counters for observing the policy.
+     */
+    struct Stats
+    {
+        uint64_t frames = 0;           // Frames rendered since launch.
+        uint64_t idleFrames = 0;       // Of those, frames rendered while idle.
+        uint64_t idleMs = 0;           // Time spent visible and idle.
+        double idleFramesPerMinute = 0.0;
+    };
+
+    /**
+     * @brief User input reached the window: render, and restart the idle clock.
+     */
+    void OnInput(const uint64_t nowMs);
+
+    /**
+     * @brief Something the window shows changed: render the next few frames.
+     */
+    void RequestFrames(const int frames = SETTLE_FRAMES);
+
+    /**
+     * @brief Render once nowMs + delayMs is reached, even without input. An earlier request wins.
+     */
+    void RequestFrameIn(const uint64_t nowMs, const uint32_t delayMs);
+
+    /**
+     * @brief Whether the window can be drawn at all. Idle time only accrues while visible.
+     */
+    void SetVisible(const bool visible, const uint64_t nowMs);
+
+    /**
+     * @brief Whether a frame is wanted now.
+     */
+    bool ShouldRender(const uint64_t nowMs);
+
+    /**
+     * @brief A frame was rendered; consumes one requested frame.
+     */
+    void OnFrameRendered(const uint64_t nowMs);
+
+    /**
+     * @brief Milliseconds until a frame is due without any message, or NO_TIMEOUT.
+     */
+    uint32_t GetWaitTimeout(const uint64_t nowMs);
+
+    /**
+     * @brief Frame counts and idle time, idle time included up to nowMs.
+     */
+    Stats GetStats(const uint64_t nowMs);
+}
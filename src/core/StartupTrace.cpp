@@ -0,0 +1,104 @@
+// Copyright (c) 2025 Max Godman
+
+#include "StartupTrace.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+namespace StartupTrace
+{
+    static std::chrono::steady_clock::time_point s_origin;
+    static std::atomic<bool> s_recording = false;
+    static std::mutex s_mutex; // Guards everything below.
+    static Record s_records[MAX_PHASES];
+    static size_t s_count = 0;
+    static int64_t s_finishUs = -1;
+
+    static int64_t NowUs()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_origin).count();
+    }
+
+    void Start()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_origin = std::chrono::steady_clock::now();
+        s_count = 0;
+        s_finishUs = -1;
+        s_recording = true;
+    }
+
+    void Finish()
+    {
+        if (!s_recording.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_recording)
+        {
+            s_finishUs = NowUs();
+            s_recording = false;
+        }
+    }
+
+    bool IsRecording()
+    {
+        return s_recording.load(std::memory_order_relaxed);
+    }
+
+    Phase::Phase(const char* name)
+        : m_name(name)
+    {
+        m_open = IsRecording();
+        if (m_open)
+            m_startUs = NowUs();
+    }
+
+    void Phase::End()
+    {
+        if (!m_open)
+            return;
+        m_open = false;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_recording || s_count == MAX_PHASES)
+            return;
+        s_records[s_count++] = { m_name, m_startUs, NowUs() - m_startUs };
+    }
+
+    std::vector<Record> GetRecords()
+    {
+        std::vector<Record> records;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            records.assign(s_records, s_records + s_count);
+        }
+
+        // Recorded as they end; a phase that contains others ends after them.
+        std::stable_sort(records.begin(), records.end(),
+            [](const Record& a, const Record& b) { return a.startUs < b.startUs; });
+        return records;
+    }
+
+    int64_t GetTotalUs()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        return s_finishUs >= 0 ? s_finishUs : NowUs();
+    }
+
+    std::string Format()
+    {
+        char field[96];
+        snprintf(field, sizeof(field), "total=%.1f", GetTotalUs() / 1000.0);
+        std::string text = field;
+
+        for (const Record& record : GetRecords())
+        {
+            snprintf(field, sizeof(field), " %s=%.1f+%.1f", record.name, record.startUs / 1000.0, record.durationUs / 1000.0);
+            text += field;
+        }
+        return text;
+    }
+}
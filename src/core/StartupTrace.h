@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Max Godman
+
+// Records how long each phase of start-up took, and when it ran, for the control pipe's "trace".
+
+/**
+ * Start-up sits on the login path, where everything else is starting too, so it is worth knowing
+ * where its time goes. Phases are timed from Start (the top of wWinMain) until the message loop
+ * first goes idle (Finish), on whichever thread runs them; several run at once (see WM_CREATE).
+ *
+ * Recording stops at Finish, so phases that recur later (the renderer after the window is
+ * released and shown again) keep their start-up timing. Outside start-up a Phase costs one relaxed
+ * atomic load.
+ *
+ * Portable (no <windows.h>), thread-safe.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace StartupTrace
+{
+    // Phases kept; any beyond are dropped.
+    constexpr size_t MAX_PHASES = 32;
+
+    /**
+     * @brief One timed phase. Times are microseconds since Start.
+     */
+    struct Record
+    {
+        const char* name = nullptr; // A string literal.
+        int64_t startUs = 0;
+        int64_t durationUs = 0;
+    };
+
+    /**
+     * @brief Start the clock and begin recording. Call first thing.
+     */
+    void Start();
+
+    /**
+     * @brief Stop recording: start-up is over. Later calls do nothing.
+     */
+    void Finish();
+
+    bool IsRecording();
+
+    /**
+     * @brief Times the scope it lives in (or up to End) as a phase, if recording when it began.
+     */
+    class Phase
+    {
+    public:
+        explicit Phase(const char* name);
+        ~Phase() { End(); }
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+        void End();
+
+    private:
+        const char* m_name;
+        int64_t m_startUs = 0;
+        bool m_open = false;
+    };
+
+    /**
+     * @brief The phases recorded, in the order they began.
+     */
+    std::vector<Record> GetRecords();
+
+    /**
+     * @brief Start to Finish, or to now while still recording.
+     */
+    int64_t GetTotalUs();
+
+    /**
+     * @brief The trace on one line, times in ms: "total=48.2 config=0.4+3.1 displays=0.4+6.0 ...",
+     *        each phase as name=start+duration, in the order they began.
+     */
+    std::string Format();
+}
@@ -3,6 +3,7 @@
 #include "UIGlobals.h"
 #include "AppGlobals.h"
 #include "SystemTrayManager.h"
+#include "RedrawPolicy.h"
 
 namespace UI
 {
@@ -14,5 +15,8 @@ namespace UI
         // indicator lives in the custom title bar, which reads state directly each frame - see
         // RenderTitleBar.
         SystemTrayManager::UpdateIcon(App::state.IsGammaEnabled());
+
+        // The window renders on demand; redraw it so it shows the new state.
+        RedrawPolicy::RequestFrames();
     }
 }
@@ -7,11 +7,20 @@
  * ARCHITECTURE OVERVIEW:
  * - Win32 window provides the container for ImGui rendering.
  * - DirectX 11 is used for hardware-accelerated rendering (ImGui backend).
- * - Message loop uses PeekMessage (non-blocking) to allow continuous ImGui rendering.
+ * - Message loop renders ImGui frames on demand (input, state changes, animations, see RedrawPolicy)
+ *   and otherwise blocks in MsgWaitForMultipleObjectsEx.
+ * - The renderer (D3D11 device, swap chain, ImGui context and font atlas) exists only while it is
+ *   needed: it is created when the window is first shown and released once the window has been
+ *   hidden for App::releaseUIAfterSec. Gamma, hotkeys, the tray and the pipes never need it.
  * - Window is borderless, title bar and controls are drawn by ImGui for consistent styling.
  * - AppGlobals/AppState and UIGlobals/UIState provides centralized app and UI globals and state
  *   management via App and UI namespaces. State global objects accessible via App/UI::state.
  * - Functional duties are segregated into managers and utils.
+ * - Command-line verbs (--apply, --reset, --toggle) are forwarded to the running instance over a
+ *   named pipe, or, with none running, run headless without any window or renderer; see
+ *   CommandLineManager.
+ * - Automation keeps a control pipe open and pipelines line requests (apply, set, get, ...), which
+ *   the UI thread runs in batches; see ControlManager.
  * 
  * DESIGN DECISIONS:
  * - Single instance enforcement:
@@ -20,10 +29,11 @@
  * - DPI awareness:
  *   Per-monitor DPI V2 for proper scaling across multiple monitors.
  * - RegisterHotKey for global hotkeys:
- *   Binds single keys (letters, digits, function keys including F10) as system-wide hotkeys.
- *   Bare modifier keys (Alt/Ctrl/Shift/Win alone) and F12 are not supported, see HotkeyManager.
+ *   Binds keys (letters, digits, function keys including F10), optionally with Ctrl/Alt/Shift/Win
+ *   held, as system-wide hotkeys. Bare modifier keys (Alt/Ctrl/Shift/Win alone) and F12 are not
+ *   supported, see HotkeyManager.
  *   A low-level keyboard hook was deliberately avoided as it resembles a keylogger and triggers
- *   antivirus false positives. Chorded (modifier+key) inputs are not supported.
+ *   antivirus false positives.
  * - Simple and Advanced modes:
  *   Simple mode by default offers frictionless basic functionality, for users looking to quickly
  *   set up gamma adjustments with a toggle hotkey.
@@ -43,11 +53,18 @@
 #include "DisplayManager.h"
 #include "StartupManager.h"
 #include "SystemTrayManager.h"
+#include "CommandLineManager.h"
+#include "ControlManager.h"
 #include "ImGui_Integration.h"
+#include "RedrawPolicy.h"
+#include "StartupTrace.h"
 #include "UI_Shared.h"
 #include <windowsx.h>
 #include <uxtheme.h>  // MARGINS.
 #include <dwmapi.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 // Explicitly link libraries.
 // This seems to be handled automatically in VS by CoreLibraryDependencies in the project properties.
@@ -61,7 +78,9 @@ ATOM RegisterMainWindowClass(const HINSTANCE hInstance);
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 void ShowMainWindow(const HWND hWnd);
 void HideMainWindow(const HWND hWnd);
+void OnConfigFileChanged(const HWND hWnd);
 bool RenderImGuiFrame();
+static void NoteMessageForRedraw(const UINT message);
 
 // Global instance variables.
 HINSTANCE hInst;
@@ -85,6 +104,15 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     UNREFERENCED_PARAMETER(hPrevInstance);
     UNREFERENCED_PARAMETER(lpCmdLine);
 
+    StartupTrace::Start();
+
+    // Command-line verbs (--apply, --reset, --toggle) exit before anything the GUI needs is created.
+    // They skip the single-instance check: with the app already running they are forwarded to it,
+    // otherwise they run headless. lpCmdLine is not split into arguments, so parse the full command line.
+    const CommandLineManager::Command command = CommandLineManager::Parse(CommandLineManager::GetArguments());
+    if (command.IsHeadless())
+        return CommandLineManager::RunHeadless(command);
+
     // Enforce only a single instance of the application by matching mutex.
     if (!EnforceSingleInstance())
         return 0;
@@ -95,6 +123,8 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
 
     hInst = hInstance;
 
+    // WM_CREATE runs inside CreateWindowW, so this phase holds all of its own.
+    StartupTrace::Phase createPhase("create-window");
     const HWND hWnd = CreateWindowW(szWindowClass, szTitle,
         // Borderless (WS_POPUP) but resizable (WS_THICKFRAME); WM_NCCALCSIZE strips the visible frame
         // so the ImGui title bar owns the window. The sys-menu/min/max box styles add no chrome
@@ -104,15 +134,18 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         CW_USEDEFAULT, CW_USEDEFAULT, 0, 0, // Created with zero window size, updated to desired size later.
         nullptr, nullptr, hInstance, nullptr);
 
+    createPhase.End();
+
     if (!hWnd) return FALSE;
     
     MSG msg;
     ZeroMemory(&msg, sizeof(msg));
 
     // Main message loop.
-    // Uses PeekMessage (non-blocking) so ImGui can render continuously while the window
-    // is visible. When the window is hidden or minimized to the tray there is nothing to
-    // draw, so we block in WaitMessage instead of spinning, keeping idle CPU usage at zero.
+    // Renders only when a frame is wanted (see RedrawPolicy): after input, a state change, or when
+    // an animation needs its next frame. Otherwise, and whenever the window is hidden or minimized
+    // to the tray, it blocks until a message arrives or the next animation frame is due, so an
+    // untouched window costs no CPU and no GPU presents.
     while (msg.message != WM_QUIT)
     {
         // Process all pending Windows messages first.
@@ -120,16 +153,25 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
+            continue;
         }
-        else if (App::mainWindow && IsWindowVisible(App::mainWindow) && !IsIconic(App::mainWindow))
+
+        const uint64_t now = GetTickCount64();
+        const bool visible = App::mainWindow && IsWindowVisible(App::mainWindow) && !IsIconic(App::mainWindow);
+        RedrawPolicy::SetVisible(visible, now);
+
+        if (visible && RedrawPolicy::ShouldRender(now))
         {
-            // Window is visible: render the next ImGui frame.
             RenderImGuiFrame();
         }
         else
         {
-            // Window is hidden/minimized: sleep until the next message arrives.
-            WaitMessage();
+            // Nothing left to do: start-up is over.
+            StartupTrace::Finish();
+
+            // MWMO_INPUTAVAILABLE: also wake for input already queued but not yet removed.
+            const DWORD timeout = visible ? RedrawPolicy::GetWaitTimeout(now) : INFINITE;
+            MsgWaitForMultipleObjectsEx(0, nullptr, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
         }
     }
 
@@ -151,21 +193,11 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
  */
 bool EnforceSingleInstance()
 {
-    wchar_t exePath[MAX_PATH];
-    if (!GetModuleFileNameW(nullptr, exePath, MAX_PATH))
+    // Create mutex name from path (shared with the command pipe, see CommandLineManager).
+    const std::wstring mutexName = CommandLineManager::GetInstanceName();
+    if (mutexName.empty())
         return true; // Fail open.
 
-    // Create mutex name from path.
-    std::wstring mutexName = L"GammaHotkey_";
-    mutexName += exePath;
-
-    // Mutex names can't contain backslashes, colons, or slashes.
-    for (wchar_t& c : mutexName)
-    {
-        if (c == L'\\' || c == L':' || c == L'/')
-            c = L'_';
-    }
-
     // Deliberately leaked on the success path: leaving this handle open is what keeps the
     // named mutex owned for the process lifetime, so a second launch sees ERROR_ALREADY_EXISTS.
     // A plain local suffices — the open handle holds the mutex, not the variable's storage
@@ -216,6 +248,101 @@ ATOM RegisterMainWindowClass(const HINSTANCE hInstance)
     return RegisterClassExW(&wcex);
 }
 
+/**
+ * @brief A display's ramp at launch, as the single 0..1 curve the preview draws.
+ *
+ * Seeds App::state.lastRamp so the curve graph reflects reality on launch, in case another tool (or a
+ * prior session) left a non-default ramp applied.
+ */
+struct DisplayCurve
+{
+    bool valid = false;
+    float curve[GammaConstants::RAMP_SIZE] = {};
+};
+
+// Read the current ramp of each of the displayCount displays just enumerated. Runs at launch while the
+// config loads, before anything is applied, so the selected display is not known yet and all of them
+// are read. The backend reads the ramp as WORD[3][256] per channel (0-65535); we average the channels
+// into the single 0..1 curve the preview consumes, inverting how BuildGammaRamp stores it (identical
+// channels round-trip exactly).
+static std::vector<DisplayCurve> ReadDisplayCurves(const size_t displayCount)
+{
+    std::vector<DisplayCurve> curves(displayCount);
+    for (int displayIndex = 0; displayIndex < (int)curves.size(); ++displayIndex)
+    {
+        WORD currentRamp[3][GammaConstants::RAMP_SIZE];
+        if (DisplayManager::GetBackend().GetRampSize(displayIndex) != GammaConstants::RAMP_SIZE ||
+            !DisplayManager::GetBackend().ReadRamp(displayIndex, currentRamp))
+            continue;
+
+        for (int index = 0; index < GammaConstants::RAMP_SIZE; ++index)
+        {
+            const float channelAverage = (currentRamp[0][index] + currentRamp[1][index] + currentRamp[2][index]) / 3.0f;
+            curves[displayIndex].curve[index] = channelAverage / GammaConstants::RAMP_MAX;
+        }
+        curves[displayIndex].valid = true;
+    }
+    return curves;
+}
+
+// Create the renderer if the window does not have one (never shown yet, or released while hidden).
+static bool EnsureRenderer(const HWND hWnd)
+{
+    KillTimer(hWnd, TimerIDs::RELEASE_UI);
+    if (g_ImGuiRenderer)
+        return true;
+
+    StartupTrace::Phase phase("renderer");
+    g_ImGuiRenderer = new ImGuiRenderer();
+    if (!g_ImGuiRenderer->Initialize(hWnd))
+    {
+        delete g_ImGuiRenderer;
+        g_ImGuiRenderer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// Free every GPU object and the ImGui context while the window is hidden in the tray. The next
+// ShowWindowCloaked builds them again, at the window's DPI of the moment.
+static void ReleaseRenderer()
+{
+    if (!g_ImGuiRenderer)
+        return;
+
+    g_ImGuiRenderer->Shutdown();
+    delete g_ImGuiRenderer;
+    g_ImGuiRenderer = nullptr;
+    UI::state.titleBar.valid = false; // Published again by the first frame.
+}
+
+// The window was just hidden: release its renderer if it stays hidden long enough.
+static void ScheduleRendererRelease(const HWND hWnd)
+{
+    if (g_ImGuiRenderer && App::releaseUIAfterSec > 0)
+        SetTimer(hWnd, TimerIDs::RELEASE_UI, (UINT)App::releaseUIAfterSec * 1000, nullptr);
+}
+
+static void OnReleaseTimer(const HWND hWnd)
+{
+    if (IsWindowVisible(hWnd))
+    {
+        KillTimer(hWnd, TimerIDs::RELEASE_UI);
+        return;
+    }
+
+    // Hotkeys stay unregistered while one is being captured, and the capture popup lives in the
+    // ImGui context: wait for it to finish (the timer fires again).
+    if (UI::state.capturingHotkeyType != HotkeyCapture::NONE)
+        return;
+
+    KillTimer(hWnd, TimerIDs::RELEASE_UI);
+    ReleaseRenderer();
+
+    // Hand the pages the renderer touched back to Windows now, rather than when memory gets tight.
+    SetProcessWorkingSetSize(GetCurrentProcess(), (SIZE_T)-1, (SIZE_T)-1);
+}
+
 // Show the window without the white flash that appears when a never-composited (or previously
 // hidden) window is shown: its DWM redirection surface starts blank and DWM composites that blank
 // surface for one frame before our next render lands. Cloak the window (DWMWA_CLOAK) so DWM does
@@ -223,6 +350,13 @@ ATOM RegisterMainWindowClass(const HINSTANCE hInstance)
 // UI, then uncloak to reveal it already painted. Covers both first show and re-show from the tray.
 static void ShowWindowCloaked(const HWND hWnd, const bool restore)
 {
+    // Without a renderer the window would show blank; stay in the tray, where everything else works.
+    if (!EnsureRenderer(hWnd))
+    {
+        MessageBoxW(nullptr, L"Failed to initialize ImGui!", L"Error", MB_OK | MB_ICONERROR);
+        return;
+    }
+
     BOOL cloaked = TRUE;
     DwmSetWindowAttribute(hWnd, 13 /* DWMWA_CLOAK */, &cloaked, sizeof(cloaked));
 
@@ -230,7 +364,9 @@ static void ShowWindowCloaked(const HWND hWnd, const bool restore)
     if (restore)
         ShowWindow(hWnd, SW_RESTORE); // Un-minimize when re-shown from the tray.
 
+    StartupTrace::Phase framePhase("first-frame");
     RenderImGuiFrame();
+    framePhase.End();
 
     cloaked = FALSE;
     DwmSetWindowAttribute(hWnd, 13 /* DWMWA_CLOAK */, &cloaked, sizeof(cloaked));
@@ -247,6 +383,50 @@ void HideMainWindow(const HWND hWnd)
     ShowWindow(hWnd, SW_HIDE);
 }
 
+/**
+ * @brief Reloads the config after it changed on disk and applies only what differs.
+ *
+ * Hotkeys are re-registered only where a binding changed, and gamma is re-applied only when the
+ * mode, the display, or the values of the active profile changed. Unsaved edits to the working
+ * profile survive a reload that leaves the selected profile as it was.
+ */
+void OnConfigFileChanged(const HWND hWnd)
+{
+    const ConfigManager::ReloadResult result = ConfigManager::Reload();
+    if (!result.reloaded)
+        return;
+
+    // The same fixups as at launch: the display index must exist, and the startup shortcut, not
+    // the file, says whether we launch on startup.
+    if (App::selectedDisplayIndex < -1 || App::selectedDisplayIndex >= (int)App::displays.size())
+        App::selectedDisplayIndex = 0;
+    App::launchOnStartup = StartupManager::IsEnabled();
+
+    // Profile indices held by open dialogs may now name another profile; close them.
+    UI::state.deleteProfileIndex = -1;
+    UI::state.renamingProfileIndex = -1;
+
+    HotkeyManager::Refresh(hWnd);
+
+    if (result.modeChanged)
+        App::SyncWindowSizeToState();
+
+    if (result.activeChanged)
+    {
+        if (App::state.IsAdvancedModeEnabled() && App::HasSelectedProfile())
+            App::workingProfile = App::profiles[App::selectedProfileIndex];
+        SyncUIWithCurrentProfile();
+
+        // Leave nothing behind on a display that is no longer the target, as the display picker does.
+        if (result.displayChanged && result.previousDisplayIndex != App::selectedDisplayIndex)
+            GammaManager::ResetDisplay(result.previousDisplayIndex);
+        if (App::state.IsGammaEnabled())
+            App::SyncGammaToState();
+    }
+
+    UI::SyncUIToState();
+}
+
 /**
  * @brief Handles rendering a new ImGui frame.
  * New ImGui frame -> Build our ImGui UI -> Render the ImGui frame.
@@ -266,11 +446,53 @@ bool RenderImGuiFrame()
 
     // Now render it.
     g_ImGuiRenderer->Render();
+
+    const uint64_t now = GetTickCount64();
+    RedrawPolicy::OnFrameRendered(now);
+    const int animationDelayMs = g_ImGuiRenderer->GetAnimationDelayMs();
+    if (animationDelayMs >= 0)
+        RedrawPolicy::RequestFrameIn(now, (uint32_t)animationDelayMs);
     return true;
 }
 
+/**
+ * @brief Ask RedrawPolicy for frames when a message can change what the window shows.
+ *
+ * Sent messages (WM_SIZE from SetWindowPos, for one) never pass through the message loop, so this
+ * runs in WndProc, which sees them all. Messages not listed change nothing on screen by themselves;
+ * those that change app state reach UI::SyncUIToState or a gamma apply, which request frames too.
+ */
+static void NoteMessageForRedraw(const UINT message)
+{
+    if ((message >= WM_MOUSEFIRST && message <= WM_MOUSELAST) || (message >= WM_KEYFIRST && message <= WM_KEYLAST) ||
+        (message >= WM_NCMOUSEMOVE && message <= WM_NCMBUTTONDBLCLK) || message == WM_MOUSELEAVE ||
+        message == WM_NCMOUSELEAVE)
+    {
+        RedrawPolicy::OnInput(GetTickCount64());
+        return;
+    }
+
+    switch (message)
+    {
+    case WM_PAINT:
+    case WM_SIZE:
+    case WM_SHOWWINDOW:
+    case WM_ACTIVATE:
+    case WM_SETFOCUS:
+    case WM_KILLFOCUS:
+    case WM_CAPTURECHANGED:
+    case WM_DPICHANGED:
+    case WM_DISPLAYCHANGE:
+    case WM_SETTINGCHANGE:
+        RedrawPolicy::RequestFrames();
+        break;
+    }
+}
+
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
+    NoteMessageForRedraw(message);
+
     // ImGui backend needs to first look at all messages to track mouse/keyboard state.
     // If ImGui handles it (returns true), we don't process further to avoid conflicts.
     if (ImGui_ImplWin32_WndProcHandler(hWnd, message, wParam, lParam))
@@ -310,13 +532,27 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         DwmSetWindowAttribute(hWnd, 33 /* DWMWA_WINDOW_CORNER_PREFERENCE */,
             &cornerPreferenceRound, sizeof(cornerPreferenceRound));
 
-        // Initialize ImGui renderer for the UI.
-        g_ImGuiRenderer = new ImGuiRenderer();
-        if (!g_ImGuiRenderer->Initialize(hWnd))
+        // Displays (enumerating them, reading the ramps they have) and the startup shortcut do not
+        // depend on the config: look them up on threads of their own while this one loads it. The
+        // display thread only talks to the backend and fills locals; App::displays and the apply
+        // workers are UI thread state, set up once it is joined.
+        std::vector<GammaDisplayInfo> displayInfos;
+        std::vector<DisplayCurve> displayCurves;
+        std::thread displayThread([&displayInfos, &displayCurves]
         {
-            MessageBoxW(hWnd, L"Failed to initialize ImGui!", L"Error", MB_OK | MB_ICONERROR);
-            return -1;
-        }
+            {
+                StartupTrace::Phase phase("displays");
+                displayInfos = DisplayManager::GetBackend().Enumerate();
+            }
+            StartupTrace::Phase phase("ramp-read");
+            displayCurves = ReadDisplayCurves(displayInfos.size());
+        });
+        bool shortcutExists = false;
+        std::thread shortcutThread([&shortcutExists]
+        {
+            StartupTrace::Phase phase("shortcut");
+            shortcutExists = StartupManager::IsEnabled();
+        });
 
         // Initialize COM on this (UI) thread. COM is only used by StartupManager, to write the
         // "launch on startup" shortcut via IShellLink; nothing else in the app needs it. A failure
@@ -329,16 +565,32 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         const HRESULT hr = CoInitialize(nullptr);
         s_comInitialized = SUCCEEDED(hr);
 
-        // Enumerate displays, required before config load validates display index.
-        DisplayManager::EnumerateDisplays();
-
         // Load config and register hotkeys.
+        StartupTrace::Phase configPhase("config");
         ConfigManager::Load();
+        configPhase.End();
         App::state.SetConfigInitialized(true); // Mark initialized, so we can check if config data is ready.
+        ConfigManager::StartSaver(); // UI changes save in the background from here on.
+        ConfigManager::StartWatcher(hWnd); // And edits made outside the app are loaded as they land.
+        StartupTrace::Phase hotkeyPhase("hotkeys");
         HotkeyManager::RegisterAll(hWnd);
+        hotkeyPhase.End();
+        CommandLineManager::StartServer(hWnd); // Later launches with a verb hand it to us.
+        ControlManager::StartServer(hWnd);
         
         // Window was created with zero size, now update it.
         App::SyncWindowSizeToState();
+
+        // Everything below needs the displays. The time spent waiting here is what the other threads
+        // still had left once this one was done.
+        StartupTrace::Phase joinPhase("join");
+        displayThread.join();
+        shortcutThread.join();
+        joinPhase.End();
+
+        StartupTrace::Phase workersPhase("workers");
+        DisplayManager::SetDisplays(displayInfos);
+        workersPhase.End();
         
         // Validate selected monitor index, required after config load.
         if (App::selectedDisplayIndex < -1 || App::selectedDisplayIndex >= (int)App::displays.size())
@@ -347,47 +599,28 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         }
         
         // Check startup shortcut status.
-        App::launchOnStartup = StartupManager::IsEnabled();
-
-        // Seed lastRamp from the display's current gamma ramp so the curve graph reflects reality on
-        // launch, in case another tool (or a prior session) left a non-default ramp applied. When the
-        // target is "all displays" (-1) we read display 0 as representative, mirroring how GammaManager
-        // opens a DC via CreateDC on the device name. GetDeviceGammaRamp gives WORD[3][256] per channel
-        // (0-65535); we average the channels into the single 0..1 curve the preview consumes, inverting
-        // how BuildGammaRamp stores it (identical channels round-trip exactly). Falls back to the linear
-        // identity if there is no display or the read fails.
-        bool seededFromDevice = false;
-        if (!App::displays.empty())
-        {
-            const int readIndex = (App::selectedDisplayIndex >= 0) ? App::selectedDisplayIndex : 0;
-            const HDC hdc = CreateDC(NULL, App::displays[readIndex].deviceName.c_str(), NULL, NULL);
-            if (hdc)
-            {
-                WORD currentRamp[3][GammaConstants::RAMP_SIZE];
-                if (GetDeviceGammaRamp(hdc, currentRamp))
-                {
-                    for (int index = 0; index < GammaConstants::RAMP_SIZE; ++index)
-                    {
-                        const float channelAverage = (currentRamp[0][index] + currentRamp[1][index] + currentRamp[2][index]) / 3.0f;
-                        App::state.lastRamp[index] = channelAverage / GammaConstants::RAMP_MAX;
-                    }
-                    seededFromDevice = true;
-                }
-                DeleteDC(hdc);
-            }
-        }
+        App::launchOnStartup = shortcutExists;
 
-        if (!seededFromDevice)
+        // Seed lastRamp from the target display's current ramp so the curve graph reflects reality on
+        // launch. When the target is "all displays" (-1) we read display 0 as representative.
+        const int readIndex = (App::selectedDisplayIndex >= 0) ? App::selectedDisplayIndex : 0;
+        if (readIndex < (int)displayCurves.size() && displayCurves[readIndex].valid)
+        {
+            std::copy(std::begin(displayCurves[readIndex].curve), std::end(displayCurves[readIndex].curve), App::state.lastRamp);
+        }
+        else
         {
             // No display available or the read failed, assume the default (linear) state.
             for (int index = 0; index < GammaConstants::RAMP_SIZE; ++index)
                 App::state.lastRamp[index] = index / 255.0f;
         }
 
+
         // Add system tray icon, do this early enough to later receive an update as part of initialization.
         SystemTrayManager::AddIcon(hWnd);
 
         // Handle advanced and simple mode profile initialization as desired by the settings.
+        StartupTrace::Phase applyPhase("first-apply");
         if (App::state.IsAdvancedModeEnabled() && App::HasSelectedProfile())
         {
             // Advanced mode, requires a valid selected profile.
@@ -409,6 +642,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             App::SyncGammaToState();
         }
         
+        applyPhase.End();
+        
         // Ensure UI is synced after any state changes.
         UI::SyncUIToState();
 
@@ -432,7 +667,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
     case WM_ENDSESSION:
         // The session is ending and the process may be terminated without WM_DESTROY.
-        // Persist settings and restore gamma now so nothing is lost. Guard the save on
+        // Persist settings and restore gamma now so nothing is lost. Save writes synchronously and
+        // supersedes any save still scheduled on the saver thread. Guard the save on
         // IsConfigInitialized for the same reason as WM_DESTROY: never write in-memory
         // defaults over the user's config if it was somehow never loaded.
         if (wParam)
@@ -440,6 +676,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             if (App::state.IsConfigInitialized())
                 ConfigManager::Save();
             GammaManager::ResetDisplay(App::selectedDisplayIndex);
+            GammaManager::Flush(); // Applies are asynchronous; make sure the reset lands before we return.
         }
         return 0;
 
@@ -454,43 +691,46 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         return DefWindowProc(hWnd, message, wParam, lParam);
 
     case WM_DESTROY:
-        // Persist settings on a normal close. This is not an "excessive" save: the config is
-        // already written after each user action, but a few runtime-only changes are not saved
+        // Persist settings on a normal close. This is not an "excessive" save: a save is already
+        // scheduled after each user action, but a few runtime-only changes are not saved
         // anywhere else (most notably the selected profile after cycling it with the next/previous
         // hotkeys), so this final save captures them. ConfigManager::Save writes a small UTF-8 .ini
-        // via a temp file and an atomic rename - cheap enough to do once on exit, so a dirty-flag
-        // is not worth its complexity here.
+        // via a temp file and an atomic rename - cheap enough to do once on exit, and skipped
+        // outright if the bytes match the file. It runs here, synchronously, and drops any save
+        // still waiting out its quiet period on the saver thread, which is then stopped.
         //
         // A hard process kill (TerminateProcess / End task) cannot be intercepted, so at worst the
-        // on-disk config is missing runtime-only changes made since the last per-action save; the
+        // on-disk config is missing runtime-only changes, plus UI changes from the last
+        // ConfigManager::SAVE_DELAY_MS that were still waiting to be written; the
         // atomic rename means no partial/corrupt file results. PC shutdown and logoff are handled
         // by WM_ENDSESSION above, which runs the same save for the case where WM_DESTROY is not
         // delivered.
         //
         // Guard on IsConfigInitialized so an early teardown never overwrites the user's real config
-        // with in-memory defaults: WM_DESTROY also fires when WM_CREATE returns -1 (e.g. renderer
-        // init failed before the config was loaded).
+        // with in-memory defaults: WM_DESTROY also fires when WM_CREATE returns -1, before the
+        // config was loaded.
+        CommandLineManager::StopServer();
+        ControlManager::StopServer();
+        ConfigManager::StopWatcher();
         if (App::state.IsConfigInitialized())
             ConfigManager::Save();
+        ConfigManager::StopSaver();
 
-        // Reset gamma to default before closing.
+        // Reset gamma to default before closing. Stopping the apply workers writes the reset first.
         GammaManager::ResetDisplay(App::selectedDisplayIndex);
+        GammaManager::StopWorkers();
+        DisplayManager::ReleaseDisplays();
         
         HotkeyManager::UnregisterAll(hWnd);
         SystemTrayManager::RemoveIcon();
         
-        if (g_ImGuiRenderer)
-        {
-            g_ImGuiRenderer->Shutdown();
-            delete g_ImGuiRenderer;
-            g_ImGuiRenderer = nullptr;
-        }
+        ReleaseRenderer();
         
         // Balance the CoInitialize from WM_CREATE, but only when it actually took a reference
         // (S_OK/S_FALSE). If it failed - including RPC_E_CHANGED_MODE, where COM was already
         // initialized in another mode and we took no reference - we must not uninitialize. This
-        // guard also matters because WM_DESTROY runs when WM_CREATE returns -1 (e.g. renderer init
-        // failed), before COM was ever initialized.
+        // guard also matters because WM_DESTROY runs when WM_CREATE returns -1, before COM was ever
+        // initialized.
         if (s_comInitialized)
         {
             CoUninitialize();
@@ -753,6 +993,13 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         break;
     }
 
+    case WM_SHOWWINDOW:
+        // Every way of hiding the window (tray minimize, close to tray) ends here; showing it again
+        // always goes through ShowWindowCloaked, which cancels the release.
+        if (!wParam)
+            ScheduleRendererRelease(hWnd);
+        return DefWindowProc(hWnd, message, wParam, lParam);
+
     case WM_ERASEBKGND:
         // Don't erase background, ImGui will draw everything.
         return 1;
@@ -820,6 +1067,41 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         HotkeyManager::HandleHotkey((int)wParam);
         return 0;
 
+    case WM_TIMER:
+        // A step hotkey is being held, see HotkeyManager.
+        if (wParam == TimerIDs::STEP_HOLD)
+        {
+            HotkeyManager::OnStepTimer();
+            return 0;
+        }
+        // The window has been hidden for a while, see ScheduleRendererRelease.
+        if (wParam == TimerIDs::RELEASE_UI)
+        {
+            OnReleaseTimer(hWnd);
+            return 0;
+        }
+        return DefWindowProc(hWnd, message, wParam, lParam);
+
+    case ConfigIDs::WM_CONFIG_CHANGED:
+        // The config file was changed outside the app (see ConfigManager's watcher).
+        OnConfigFileChanged(hWnd);
+        return 0;
+
+    case CommandLineIDs::WM_FORWARDED_COMMAND:
+        // A second launch forwarded its command line (see CommandLineManager).
+        CommandLineManager::OnForwardedCommand((CommandLineManager::ForwardedCommand*)lParam);
+        return 0;
+
+    case ControlIDs::WM_CONTROL_BATCH:
+        // A control pipe client sent requests (see ControlManager).
+        ControlManager::OnBatch((ControlManager::Session*)lParam);
+        return 0;
+
+    case GammaIDs::WM_APPLY_RESULT:
+        // The driver accepted or refused a ramp after the apply had drawn (see GammaManager).
+        RedrawPolicy::RequestFrames();
+        return 0;
+
     case SystemTrayIDs::WM_ICON:
         if (lParam == WM_LBUTTONDOWN)
         {
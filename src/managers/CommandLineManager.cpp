@@ -0,0 +1,614 @@
+// Copyright (c) 2025 Max Godman
+
+#include "framework.h"
+#include "CommandLineManager.h"
+#include "AppGlobals.h"
+#include "ConfigManager.h"
+#include "DisplayManager.h"
+#include "GammaManager.h"
+#include "ProfileManager.h"
+#include "RampCache.h"
+#include "UI_Shared.h"
+#include "UIGlobals.h"
+#include "RampEngine.h"
+#include "StringUtils.h"
+#include <shellapi.h> // CommandLineToArgvW.
+#include <psapi.h>    // GetProcessMemoryInfo.
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#pragma comment(lib, "psapi.lib")
+
+namespace CommandLineManager
+{
+    static const wchar_t* const USAGE_TEXT =
+        L"Usage:\n"
+        L"  GammaHotkey.exe --apply <profile> [--display <name>] [--stats]\n"
+        L"  GammaHotkey.exe --reset [--display <name>] [--stats]\n"
+        L"  GammaHotkey.exe --toggle [--display <name>] [--stats]\n"
+        L"\n"
+        L"  --display  Device name (DISPLAY2), monitor name, or \"all\". Defaults to the display\n"
+        L"             selected in the app.\n"
+        L"  --stats    Print the run time and peak memory use, the driver calls made, and ramp\n"
+        L"             cache hits.\n";
+
+    // The pipe server thread, which hands commands from second launches to the window.
+    struct Server
+    {
+        std::thread thread;
+        HANDLE stop = NULL; // Manual-reset event, set by StopServer.
+    };
+
+    static Server s_server;
+
+    // How long the server waits for a connected client to send its request.
+    static constexpr DWORD REQUEST_TIMEOUT_MS = 1000;
+
+    std::wstring GetInstanceName()
+    {
+        wchar_t exePath[MAX_PATH];
+        if (!GetModuleFileNameW(nullptr, exePath, MAX_PATH))
+            return std::wstring();
+
+        std::wstring name = L"GammaHotkey_";
+        name += exePath;
+
+        // Mutex names can't contain backslashes, colons, or slashes.
+        for (wchar_t& c : name)
+        {
+            if (c == L'\\' || c == L':' || c == L'/')
+                c = L'_';
+        }
+        return name;
+    }
+
+    static std::wstring GetPipeName()
+    {
+        return L"\\\\.\\pipe\\" + GetInstanceName();
+    }
+
+    Command Parse(const std::vector<std::wstring>& arguments)
+    {
+        Command command;
+        command.arguments = arguments;
+
+        // The first problem is the one reported.
+        const auto fail = [&command](const std::wstring& error)
+        {
+            if (command.error.empty())
+                command.error = error;
+        };
+
+        const auto setVerb = [&command, &fail](const Verb verb, const std::wstring& argument)
+        {
+            if (command.verb != Verb::None)
+                fail(L"Only one of --apply, --reset and --toggle can be given, found " + argument + L" as well.");
+            else
+                command.verb = verb;
+        };
+
+        for (size_t index = 0; index < arguments.size(); ++index)
+        {
+            const std::wstring& argument = arguments[index];
+            const bool hasValue = index + 1 < arguments.size();
+
+            if (argument == L"--apply")
+            {
+                setVerb(Verb::Apply, argument);
+                if (!hasValue)
+                    fail(L"--apply needs a profile name.");
+                else
+                    command.profile = arguments[++index];
+            }
+            else if (argument == L"--reset")
+            {
+                setVerb(Verb::Reset, argument);
+            }
+            else if (argument == L"--toggle")
+            {
+                setVerb(Verb::Toggle, argument);
+            }
+            else if (argument == L"--display")
+            {
+                if (!hasValue || arguments[index + 1].empty())
+                    fail(L"--display needs a display name.");
+                else
+                    command.display = arguments[++index];
+            }
+            else if (argument == L"--stats")
+            {
+                command.stats = true;
+            }
+            else if (argument == L"--help" || argument == L"-h" || argument == L"/?")
+            {
+                command.help = true;
+            }
+            else
+            {
+                fail(L"Unknown argument: " + argument);
+            }
+        }
+
+        // Options without a verb would otherwise launch the app and silently ignore them.
+        if (command.verb == Verb::None && !command.help && (!command.display.empty() || command.stats))
+            fail(L"--display and --stats need --apply, --reset or --toggle.");
+
+        return command;
+    }
+
+    std::vector<std::wstring> GetArguments()
+    {
+        std::vector<std::wstring> arguments;
+
+        int count = 0;
+        LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &count);
+        if (!argv)
+            return arguments;
+
+        for (int index = 1; index < count; ++index) // Skip the program name.
+            arguments.emplace_back(argv[index]);
+
+        LocalFree(argv);
+        return arguments;
+    }
+
+    // Write to the console of the process that started us. A GUI subsystem process has none of its
+    // own: use the standard error handle if the caller redirected it, otherwise attach to the parent's
+    // console. Nothing is shown when started from Explorer or a scheduled task; the exit code still is.
+    static void Print(const std::wstring& text)
+    {
+        static HANDLE s_output = nullptr;
+        static bool s_resolved = false;
+        if (!s_resolved)
+        {
+            s_resolved = true;
+            s_output = GetStdHandle(STD_ERROR_HANDLE);
+            if ((!s_output || s_output == INVALID_HANDLE_VALUE) && AttachConsole(ATTACH_PARENT_PROCESS))
+            {
+                s_output = CreateFileW(L"CONOUT$", GENERIC_WRITE, FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+            }
+            if (s_output == INVALID_HANDLE_VALUE)
+                s_output = nullptr;
+        }
+        if (!s_output || text.empty())
+            return;
+
+        // A console takes UTF-16 directly; a redirected handle (file, pipe) gets UTF-8.
+        DWORD mode = 0;
+        DWORD written = 0;
+        if (GetConsoleMode(s_output, &mode))
+        {
+            WriteConsoleW(s_output, text.c_str(), (DWORD)text.size(), &written, nullptr);
+        }
+        else
+        {
+            const std::string utf8 = StringUtils::WideToUTF8(text);
+            WriteFile(s_output, utf8.data(), (DWORD)utf8.size(), &written, nullptr);
+        }
+    }
+
+    static bool EqualsIgnoreCase(const std::wstring& a, const std::wstring& b)
+    {
+        return CompareStringOrdinal(a.c_str(), (int)a.size(), b.c_str(), (int)b.size(), TRUE) == CSTR_EQUAL;
+    }
+
+    // Index of the display --display names, -1 for "all", or -2 if no display matches.
+    static int FindDisplay(const std::wstring& name)
+    {
+        if (EqualsIgnoreCase(name, L"all"))
+            return -1;
+
+        static const std::wstring DEVICE_PREFIX = L"\\\\.\\";
+        for (int index = 0; index < (int)App::displays.size(); ++index)
+        {
+            const DisplayEntry& display = App::displays[index];
+            const bool prefixed = display.deviceName.compare(0, DEVICE_PREFIX.size(), DEVICE_PREFIX) == 0;
+            const std::wstring shortName = prefixed ? display.deviceName.substr(DEVICE_PREFIX.size()) : display.deviceName;
+
+            if (EqualsIgnoreCase(name, display.deviceName) || EqualsIgnoreCase(name, shortName) ||
+                EqualsIgnoreCase(name, display.friendlyName))
+                return index;
+        }
+        return -2;
+    }
+
+    // Whether the display holds the default (linear) ramp. A display that cannot be read counts as
+    // adjusted, so toggling it resets: the safe direction.
+    static bool HasIdentityRamp(const int displayIndex)
+    {
+        GammaBackend& backend = DisplayManager::GetBackend();
+        WORD current[3][GammaConstants::RAMP_SIZE];
+        if (backend.GetRampSize(displayIndex) != GammaConstants::RAMP_SIZE || !backend.ReadRamp(displayIndex, current))
+            return false;
+
+        WORD identity[3][GammaConstants::RAMP_SIZE];
+        RampEngine::BuildIdentityRamp(identity);
+        return memcmp(current, identity, sizeof(current)) == 0;
+    }
+
+    static void PrintStats()
+    {
+        // Wall-clock time since the process was created, loader and CRT start-up included.
+        FILETIME creation, exit, kernel, user, now;
+        GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+        GetSystemTimePreciseAsFileTime(&now);
+        const ULARGE_INTEGER start = { { creation.dwLowDateTime, creation.dwHighDateTime } };
+        const ULARGE_INTEGER end = { { now.dwLowDateTime, now.dwHighDateTime } };
+        const double elapsedMs = (end.QuadPart - start.QuadPart) / 10000.0; // 100 ns units.
+
+        PROCESS_MEMORY_COUNTERS memory = {};
+        memory.cb = sizeof(memory);
+        GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory));
+
+        wchar_t line[128];
+        swprintf_s(line, L"Done in %.1f ms, peak working set %.1f MB.\n", elapsedMs,
+            memory.PeakWorkingSetSize / (1024.0 * 1024.0));
+        Print(line);
+    }
+
+    // Run after the workers stop, so every write has been counted. A display that already had the
+    // ramp takes no driver call at all, and a ramp built for one display is a cache hit for the next.
+    static void PrintApplyStats()
+    {
+        const GammaManager::ApplyStats stats = GammaManager::GetApplyStats();
+
+        wchar_t line[160];
+        swprintf_s(line, L"Driver calls %llu, skipped %llu (ramp already applied), coalesced %llu, clamped %llu.\n",
+            (unsigned long long)stats.driverCalls, (unsigned long long)stats.skippedCalls,
+            (unsigned long long)stats.coalescedCalls, (unsigned long long)stats.clampedApplies);
+        Print(line);
+
+        const RampCache::Stats cache = RampCache::GetStats();
+        swprintf_s(line, L"Ramp cache hits %llu, misses %llu.\n", (unsigned long long)cache.hits,
+            (unsigned long long)cache.misses);
+        Print(line);
+    }
+
+    // Wait for the apply workers, then report whether the driver took the ramp.
+    static int FinishApply(std::wstring& message)
+    {
+        // Applies are asynchronous; the driver has answered once this returns.
+        GammaManager::Flush();
+        if (App::state.gammaRampFailed)
+        {
+            message = L"The display driver rejected the gamma ramp.\n";
+            return ExitCode::APPLY_FAILED;
+        }
+        return ExitCode::OK;
+    }
+
+    // Apply the command to App::selectedDisplayIndex, already resolved, in this process.
+    static int Run(const Command& command, std::wstring& message)
+    {
+        switch (command.verb)
+        {
+        case Verb::Apply:
+            if (!ProfileManager::ApplyByName(command.profile))
+            {
+                message = L"No profile named \"" + command.profile + L"\".\n";
+                return ExitCode::PROFILE_NOT_FOUND;
+            }
+            break;
+
+        case Verb::Reset:
+            GammaManager::ResetDisplay(App::selectedDisplayIndex);
+            break;
+
+        case Verb::Toggle:
+        {
+            // There is no running app to remember the toggle state, so the display is the state. As
+            // at launch, "all displays" reads display 0 as representative.
+            const int readIndex = App::selectedDisplayIndex >= 0 ? App::selectedDisplayIndex : 0;
+            if (HasIdentityRamp(readIndex))
+            {
+                if (App::state.IsAdvancedModeEnabled() && App::HasSelectedProfile())
+                    App::workingProfile = App::profiles[App::selectedProfileIndex];
+                App::state.SetGammaEnabled(true);
+            }
+            App::SyncGammaToState();
+            break;
+        }
+
+        case Verb::None:
+            break;
+        }
+
+        return FinishApply(message);
+    }
+
+    // Send the arguments to the running instance and wait for its answer.
+    // @return false if there is no running instance, or it did not answer.
+    static bool Forward(const Command& command, int& exitCode)
+    {
+        std::wstring request;
+        for (const std::wstring& argument : command.arguments)
+        {
+            request += argument;
+            request += L'\0';
+        }
+        if (request.size() * sizeof(wchar_t) > REQUEST_SIZE)
+            return false; // Absurdly long; the running instance would refuse it, so run it here.
+
+        // One call connects, writes, reads the reply and disconnects. It fails at once with
+        // ERROR_FILE_NOT_FOUND when no instance is running.
+        BYTE reply[REPLY_SIZE];
+        DWORD replySize = 0;
+        if (!CallNamedPipeW(GetPipeName().c_str(), request.data(), (DWORD)(request.size() * sizeof(wchar_t)),
+            reply, sizeof(reply), &replySize, CONNECT_TIMEOUT_MS))
+            return false;
+        if (replySize < sizeof(int32_t))
+            return false;
+
+        int32_t code = 0;
+        memcpy(&code, reply, sizeof(code));
+        exitCode = code;
+
+        const std::wstring message((const wchar_t*)(reply + sizeof(code)), (replySize - sizeof(code)) / sizeof(wchar_t));
+        if (!message.empty())
+            Print(message);
+        return true;
+    }
+
+    int RunHeadless(const Command& command)
+    {
+        if (!command.error.empty())
+        {
+            Print(command.error + L"\n\n" + USAGE_TEXT);
+            return ExitCode::USAGE;
+        }
+        if (command.verb == Verb::None)
+        {
+            Print(USAGE_TEXT);
+            return ExitCode::OK;
+        }
+
+        int result = ExitCode::OK;
+        if (Forward(command, result))
+        {
+            if (command.stats)
+                PrintStats(); // Launch to ramp written by the running instance.
+            return result;
+        }
+
+        // The same order as WM_CREATE: displays first, so the config's display index can be checked.
+        // Neither the saver nor the watcher is started: a headless run never writes the config.
+        DisplayManager::EnumerateDisplays();
+        ConfigManager::Load();
+
+        // A script wants the ramp in place when we exit, not a fade that outlives the process.
+        App::transitionMs = 0;
+
+        if (App::displays.empty())
+        {
+            Print(L"No displays found.\n");
+            result = ExitCode::DISPLAY_NOT_FOUND;
+        }
+        else if (!command.display.empty())
+        {
+            App::selectedDisplayIndex = FindDisplay(command.display);
+            if (App::selectedDisplayIndex < -1)
+            {
+                Print(L"No display named \"" + command.display + L"\".\n");
+                result = ExitCode::DISPLAY_NOT_FOUND;
+            }
+        }
+        else if (App::selectedDisplayIndex < -1 || App::selectedDisplayIndex >= (int)App::displays.size())
+        {
+            App::selectedDisplayIndex = 0; // Fallback to 0 if invalid, as at launch.
+        }
+
+        if (result == ExitCode::OK)
+        {
+            std::wstring message;
+            result = Run(command, message);
+            Print(message);
+        }
+
+        // Unlike WM_DESTROY, leave the ramp applied: that is what we were run for. Stopping the
+        // workers lets any write still in flight finish first.
+        GammaManager::StopWorkers();
+        DisplayManager::ReleaseDisplays();
+
+        if (command.stats)
+        {
+            PrintApplyStats();
+            PrintStats();
+        }
+        return result;
+    }
+
+    // Wait for an overlapped operation on the pipe, or for StopServer. Cancels it on stop or timeout.
+    // @return true if the operation completed successfully.
+    static bool WaitForPipe(const HANDLE pipe, OVERLAPPED& overlapped, const DWORD timeoutMs, DWORD& transferred)
+    {
+        const HANDLE handles[2] = { s_server.stop, overlapped.hEvent };
+        if (WaitForMultipleObjects(2, handles, FALSE, timeoutMs) != WAIT_OBJECT_0 + 1)
+            CancelIo(pipe); // The OVERLAPPED must outlive the operation: wait for the cancel below.
+        return GetOverlappedResult(pipe, &overlapped, &transferred, TRUE) != FALSE;
+    }
+
+    static void RunServer(const HWND window)
+    {
+        const std::wstring pipeName = GetPipeName();
+
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (!overlapped.hEvent)
+            return;
+
+        std::vector<wchar_t> buffer(REQUEST_SIZE / sizeof(wchar_t));
+        while (WaitForSingleObject(s_server.stop, 0) != WAIT_OBJECT_0)
+        {
+            // One instance per client, created before each wait: the second launch connects to it.
+            const HANDLE pipe = CreateNamedPipeW(pipeName.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+                PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                PIPE_UNLIMITED_INSTANCES, REPLY_SIZE, REQUEST_SIZE, 0, NULL);
+            if (pipe == INVALID_HANDLE_VALUE)
+                break;
+
+            DWORD transferred = 0;
+            ResetEvent(overlapped.hEvent);
+            bool connected = ConnectNamedPipe(pipe, &overlapped) != FALSE;
+            if (!connected)
+            {
+                const DWORD error = GetLastError();
+                connected = error == ERROR_PIPE_CONNECTED ||
+                    (error == ERROR_IO_PENDING && WaitForPipe(pipe, overlapped, INFINITE, transferred));
+            }
+
+            // The client writes its request as soon as it connects; one that does not is dropped.
+            bool received = false;
+            if (connected)
+            {
+                ResetEvent(overlapped.hEvent);
+                received = ReadFile(pipe, buffer.data(), REQUEST_SIZE, &transferred, &overlapped) != FALSE;
+                if (!received && GetLastError() == ERROR_IO_PENDING)
+                    received = WaitForPipe(pipe, overlapped, REQUEST_TIMEOUT_MS, transferred);
+            }
+
+            if (!received)
+            {
+                CloseHandle(pipe);
+                continue;
+            }
+
+            std::unique_ptr<ForwardedCommand> command = std::make_unique<ForwardedCommand>();
+            command->pipe = pipe;
+            const size_t length = transferred / sizeof(wchar_t);
+            for (size_t start = 0, end; start < length; start = end + 1)
+            {
+                end = std::find(buffer.begin() + start, buffer.begin() + length, L'\0') - buffer.begin();
+                command->arguments.emplace_back(buffer.data() + start, end - start);
+            }
+
+            // The window owns it from here, and replies once the command is carried out.
+            if (PostMessage(window, CommandLineIDs::WM_FORWARDED_COMMAND, 0, (LPARAM)command.get()))
+                command.release();
+            else
+                CloseHandle(pipe);
+        }
+
+        CloseHandle(overlapped.hEvent);
+    }
+
+    void StartServer(const HWND window)
+    {
+        if (s_server.thread.joinable())
+            return;
+
+        s_server.stop = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (!s_server.stop)
+            return; // Second launches run their commands headless instead.
+
+        s_server.thread = std::thread(RunServer, window);
+    }
+
+    void StopServer()
+    {
+        if (!s_server.thread.joinable())
+            return;
+
+        SetEvent(s_server.stop);
+        s_server.thread.join();
+        CloseHandle(s_server.stop);
+        s_server.stop = NULL;
+    }
+
+    // Carry out a forwarded command in the running app, as the hotkeys and the tray menu would.
+    static int RunForwarded(const Command& command, std::wstring& message)
+    {
+        if (!command.error.empty())
+        {
+            message = command.error + L"\n\n" + USAGE_TEXT;
+            return ExitCode::USAGE;
+        }
+        if (command.verb == Verb::None)
+        {
+            message = USAGE_TEXT;
+            return ExitCode::OK;
+        }
+
+        if (!command.display.empty())
+        {
+            const int displayIndex = FindDisplay(command.display);
+            if (displayIndex < -1)
+            {
+                message = L"No display named \"" + command.display + L"\".\n";
+                return ExitCode::DISPLAY_NOT_FOUND;
+            }
+
+            // Switch the target as the display picker does: nothing is left behind on the old one, and
+            // the verb below applies to the new one.
+            if (displayIndex != App::selectedDisplayIndex)
+            {
+                GammaManager::ResetDisplay(App::selectedDisplayIndex);
+                App::selectedDisplayIndex = displayIndex;
+                ConfigManager::ScheduleSave();
+            }
+        }
+
+        switch (command.verb)
+        {
+        case Verb::Apply:
+        {
+            const int index = ProfileManager::FindByName(command.profile);
+            if (index < 0)
+            {
+                message = L"No profile named \"" + command.profile + L"\".\n";
+                return ExitCode::PROFILE_NOT_FOUND;
+            }
+
+            // As a profile hotkey does, but instant: the reply means the ramp is on the display.
+            App::state.SetGammaEnabled(true);
+            ProfileManager::ApplyByIndex(index, 0);
+            SyncUIWithCurrentProfile();
+            break;
+        }
+
+        case Verb::Reset:
+            App::state.SetGammaEnabled(false);
+            App::SyncGammaToState();
+            break;
+
+        case Verb::Toggle:
+            App::ToggleGamma();
+            break;
+
+        case Verb::None:
+            break;
+        }
+
+        UI::SyncUIToState();
+        return FinishApply(message);
+    }
+
+    void OnForwardedCommand(ForwardedCommand* command)
+    {
+        const std::unique_ptr<ForwardedCommand> owned(command);
+
+        std::wstring message;
+        const int32_t exitCode = RunForwarded(Parse(owned->arguments), message);
+
+        std::vector<BYTE> reply(sizeof(exitCode) + message.size() * sizeof(wchar_t));
+        memcpy(reply.data(), &exitCode, sizeof(exitCode));
+        memcpy(reply.data() + sizeof(exitCode), message.data(), message.size() * sizeof(wchar_t));
+        reply.resize(std::min<size_t>(reply.size(), REPLY_SIZE));
+
+        // The reply fits the pipe's buffer, so the write completes without waiting for the client.
+        // Closing our end keeps what was written readable; the client sees the pipe end after it.
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (overlapped.hEvent)
+        {
+            DWORD written = 0;
+            if (!WriteFile(owned->pipe, reply.data(), (DWORD)reply.size(), &written, &overlapped) &&
+                GetLastError() == ERROR_IO_PENDING)
+                GetOverlappedResult(owned->pipe, &overlapped, &written, TRUE);
+            CloseHandle(overlapped.hEvent);
+        }
+        CloseHandle(owned->pipe);
+    }
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2025 Max Godman
+
+// Command-line verbs, run headless: apply a profile, reset or toggle gamma, then exit.
+
+/**
+ * Login scripts and scheduled tasks only need to set the gamma and get out of the way. A normal
+ * launch pays for the window, the D3D11 device and swap chain and the ImGui font atlas before
+ * WM_CREATE applies anything; these verbs skip all of it. wWinMain checks for them first, before the
+ * single-instance check and CreateWindowW.
+ *
+ * USAGE:
+ *   GammaHotkey.exe --apply <profile> [--display <name>] [--stats]
+ *   GammaHotkey.exe --reset [--display <name>] [--stats]
+ *   GammaHotkey.exe --toggle [--display <name>] [--stats]
+ *
+ * --apply   Applies the named profile (case-insensitive), instantly: TransitionMs only fades
+ *           switches in the running app.
+ * --reset   Restores the default (linear) ramp.
+ * --toggle  Resets when the display is adjusted, otherwise applies what the app would turn on:
+ *           the selected profile in Advanced mode, the simple profile in Simple mode.
+ * --display Device name ("\\.\DISPLAY2" or "DISPLAY2"), friendly name, or "all". Defaults to
+ *           the display selected in the app.
+ * --stats   Prints the time since the process started and its peak working set once done.
+ * --help    Prints the usage above.
+ *
+ * The config is read, never written, and the ramp stays applied after the process exits. Errors
+ * and --stats go to the console of the script that started us, if any; the exit code (ExitCode)
+ * says what happened either way.
+ *
+ * FORWARDING:
+ * While the app runs from the same path (see GetInstanceName), a verb is not run headless: the
+ * running instance would not know, and its toggle state, UI and next save would disagree with the
+ * display. The arguments are sent over a named pipe instead, the running instance carries them out
+ * on its UI thread through the same paths as the hotkeys and the tray, and its answer (exit code and
+ * message) comes back once the ramp has been written. A forwarded --display switches the app's
+ * target display, as the display picker does, and a forwarded --apply is instant, like a headless
+ * one. With no running instance, or one that does not answer, the verb runs headless as before.
+ *
+ * Requests are at most REQUEST_SIZE bytes: the arguments as UTF-16, each followed by a null. Replies
+ * are at most REPLY_SIZE bytes: the exit code as an int32, then the message as UTF-16. The pipe
+ * refuses remote clients.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <vector>
+
+namespace CommandLineManager
+{
+    enum class Verb
+    {
+        None, // No verb: a normal GUI launch.
+        Apply,
+        Reset,
+        Toggle,
+    };
+
+    namespace ExitCode
+    {
+        constexpr int OK = 0;
+        constexpr int USAGE = 1;             // Unknown argument, missing value, or two verbs.
+        constexpr int PROFILE_NOT_FOUND = 2;
+        constexpr int DISPLAY_NOT_FOUND = 3;
+        constexpr int APPLY_FAILED = 4;      // The driver refused the ramp on a display.
+    }
+
+    constexpr DWORD REQUEST_SIZE = 4096;
+    constexpr DWORD REPLY_SIZE = 4096;
+
+    // How long a second launch waits for the running instance's pipe to free up.
+    constexpr DWORD CONNECT_TIMEOUT_MS = 2000;
+
+    /**
+     * @brief A parsed command line.
+     */
+    struct Command
+    {
+        std::vector<std::wstring> arguments; // As given, for forwarding.
+        Verb verb = Verb::None;
+        std::wstring profile;  // --apply's profile name.
+        std::wstring display;  // --display's value, empty if not given.
+        bool stats = false;
+        bool help = false;
+        std::wstring error;    // Why the arguments are invalid; empty if they are fine.
+
+        // Whether this launch is headless: a verb, --help, or arguments that tried to be one.
+        bool IsHeadless() const { return verb != Verb::None || help || !error.empty(); }
+    };
+
+    /**
+     * @brief Parse the arguments, without the program name. Portable; does not touch any state.
+     */
+    Command Parse(const std::vector<std::wstring>& arguments);
+
+    /**
+     * @brief This process's arguments, without the program name.
+     */
+    std::vector<std::wstring> GetArguments();
+
+    /**
+     * @brief A command received by the pipe server, on its way to the UI thread.
+     */
+    struct ForwardedCommand
+    {
+        HANDLE pipe = INVALID_HANDLE_VALUE; // Connected pipe instance to reply on, closed once replied.
+        std::vector<std::wstring> arguments;
+    };
+
+    /**
+     * @brief Name shared by everything that identifies this instance: the single-instance mutex and
+     *        the command pipe. Derived from the executable's full path, so renamed or relocated
+     *        copies run (and are addressed) separately.
+     */
+    std::wstring GetInstanceName();
+
+    /**
+     * @brief Run a headless command: forward it to the running instance if there is one, otherwise
+     *        load the config, apply, wait for the displays, and clean up.
+     * @return An ExitCode.
+     * @note Never creates a window, the renderer or COM.
+     */
+    int RunHeadless(const Command& command);
+
+    /**
+     * @brief Start the thread that accepts forwarded commands and posts them to the window.
+     */
+    void StartServer(const HWND window);
+
+    /**
+     * @brief Stop accepting forwarded commands. Commands already posted are dropped with the window.
+     */
+    void StopServer();
+
+    /**
+     * @brief Carry out a forwarded command (CommandLineIDs::WM_FORWARDED_COMMAND) and reply. UI thread.
+     * @param[in] command Takes ownership.
+     */
+    void OnForwardedCommand(ForwardedCommand* command);
+}
@@ -7,100 +7,148 @@
 #include "AppGlobals.h"
 #include "PathUtils.h"
 #include "StringUtils.h"
+#include "ConfigParser.h"
+#include "ConfigWriter.h"
+#include "ConfigJournal.h"
+#include "ConfigSnapshot.h"
+#include "ProfileManager.h"
 #include <fstream>
-#include <sstream>
 #include <filesystem>
-#include <map>
-#include <functional>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 #include <algorithm>
 
 namespace ConfigManager
 {
-    // Serializes Load() and Save(). Every caller runs on the UI thread today, so this
-    // never actually contends; it's kept only to keep config file I/O atomic if a save is
-    // ever moved off the UI thread. Not evidence of existing multi-threaded access.
+    // Serializes config file I/O between the UI thread (Load, Save) and the saver thread, and guards
+    // s_lastFile, s_journalOnDisk, s_snapshotStamp and s_writtenSequence. Never held while serializing, only around
+    // the disk work.
     static std::mutex configMutex;
 
-    // Config file section types.
-    enum class ConfigSection
+    // The config file as we last wrote or read it: its content hash and size, and its modification
+    // time straight afterwards. Save skips the write when it would produce identical bytes and the
+    // file still carries that time, i.e. nobody has replaced or edited it since.
+    struct FileRecord
     {
-        None,
-        GlobalHotkeys,
-        SimpleProfile,
-        Profile,
+        bool valid = false;
+        uint64_t hash = 0;
+        size_t size = 0;
+        std::filesystem::file_time_type writeTime;
     };
 
-    // Config file key names.
-    namespace Keys
+    static FileRecord s_lastFile;
+    static std::atomic<uint64_t> s_writtenSaves = 0;
+    static std::atomic<uint64_t> s_skippedSaves = 0;
+    static std::atomic<uint64_t> s_coalescedSaves = 0;
+    static std::atomic<uint64_t> s_journaledSaves = 0;
+
+    // The ini the binary snapshot on disk was built from, if there is one that is known to be current.
+    static bool s_snapshotValid = false;
+    static ConfigSnapshot::IniStamp s_snapshotStamp;
+
+    // Whether a journal file sits beside the ini (and applies to it). Journal mode only.
+    static bool s_journalOnDisk = false;
+
+    // Set by the saver when a journal append or the full write before it failed; the UI thread then
+    // makes its next save a full one, which leaves a clean ini and no journal.
+    static std::atomic<bool> s_journalBroken = false;
+
+    // Journal mode, UI thread only: the state as of the last save (or load), which the next journal
+    // record is a diff against, and what the files on disk will hold once everything scheduled lands.
+    struct JournalBase
     {
-        // Sections.
-        static constexpr const wchar_t* SECTION_GLOBALHOTKEYS = L"GlobalHotkeys";
-        static constexpr const wchar_t* SECTION_SIMPLEPROFILE = L"SimpleProfile";
-        static constexpr const wchar_t* SECTION_PROFILE = L"Profile";
-        
-        // Profile fields.
-        static constexpr const wchar_t* PROFILE_NAME = L"Name";
-        static constexpr const wchar_t* PROFILE_BRIGHTNESS = L"Brightness";
-        static constexpr const wchar_t* PROFILE_CONTRAST = L"Contrast";
-        static constexpr const wchar_t* PROFILE_GAMMA = L"Gamma";
-        static constexpr const wchar_t* PROFILE_HOTKEY = L"Hotkey";
-        
-        // Global settings.
-        static constexpr const wchar_t* TOGGLE_HOTKEY = L"ToggleHotkey";
-        static constexpr const wchar_t* NEXTPROFILE_HOTKEY = L"NextProfileHotkey";
-        static constexpr const wchar_t* PREVIOUSPROFILE_HOTKEY = L"PreviousProfileHotkey";
-        static constexpr const wchar_t* LOOP_PROFILES = L"LoopProfiles";
-        static constexpr const wchar_t* START_MINIMIZED = L"StartMinimized";
-        static constexpr const wchar_t* MINIMIZE_TO_TRAY = L"MinimizeToTray";
-        static constexpr const wchar_t* LAUNCH_ON_STARTUP = L"LaunchOnStartup";
-        static constexpr const wchar_t* SELECTED_DISPLAY = L"SelectedDisplay";
-        static constexpr const wchar_t* APPLY_ON_LAUNCH = L"ApplyProfileOnLaunch";
-        static constexpr const wchar_t* SELECTED_PROFILE_INDEX = L"SelectedProfileIndex";
-        static constexpr const wchar_t* ADVANCED_MODE = L"AdvancedMode";
-    }
-    
-    // Case-insensitive comparator for wide strings.
-    struct CaseInsensitiveCompare
+        bool valid = false;            // Describes what is on disk (or on its way there).
+        bool needsCompaction = false;  // The journal on disk is stale or torn; fold it away next save.
+        std::string globals;           // The [GlobalHotkeys] section as serialized, compared as text.
+        Profile simpleProfile;
+        std::vector<Profile> profiles;
+        uint64_t iniSize = 0;
+        uint64_t journalSize = 0;
+    };
+
+    static JournalBase s_journalBase;
+
+    // The journal is folded back into the ini once it outgrows half the ini, or this, if larger.
+    static constexpr uint64_t JOURNAL_COMPACT_MIN_BYTES = 64 * 1024;
+
+    // Snapshots are numbered as they are taken. A write only goes ahead if nothing newer has reached
+    // the disk, so a scheduled snapshot the saver picked up just before a synchronous Save cannot land
+    // on top of it.
+    static uint64_t s_writtenSequence = 0;
+
+    // The saver thread and its single-slot "latest wins" mailbox, as GammaWorker's.
+    struct Saver
     {
-        bool operator()(const std::wstring& a, const std::wstring& b) const
-        {
-            return _wcsicmp(a.c_str(), b.c_str()) < 0;
-        }
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable signal; // Wakes the saver on a schedule or stop.
+        bool pending = false;           // A snapshot is waiting in the mailbox.
+        bool stop = false;
+        bool durable = false;
+        uint64_t sequence = 0;          // Of the waiting snapshot.
+        uint64_t nextSequence = 0;      // Last number handed out, to scheduled and synchronous saves alike.
+        std::chrono::steady_clock::time_point due;
+        std::string snapshot;
+
+        // Journal records waiting to be appended. Unlike snapshots these accumulate, and are written
+        // after a snapshot waiting alongside them (they describe changes made since it was taken).
+        bool journalPending = false;
+        uint64_t journalSequence = 0;   // Of the newest waiting record.
+        std::string journal;
+
+        // A binary snapshot Load built after parsing the ini as text, written once the saver starts.
+        bool binaryPending = false;
+        ConfigSnapshot::IniStamp binaryStamp;
+        std::string binary;
     };
-    
-    // Helper to compare keys, case-insensitive.
-    static bool KeyEquals(const std::wstring& key, const wchar_t* target)
+
+    static Saver s_saver;
+    static bool s_saverRunning = false; // UI thread only.
+
+    // The watcher thread, which tells the window when the config has been changed by someone else.
+    struct Watcher
+    {
+        std::thread thread;
+        HANDLE change = INVALID_HANDLE_VALUE; // Change notification for the config's folder.
+        HANDLE stop = NULL;                   // Manual-reset event, set by StopWatcher.
+    };
+
+    static Watcher s_watcher;
+
+    // Set when the watcher posts WM_CONFIG_CHANGED and cleared by Reload, so a burst of changes the
+    // window has not got to yet costs one message.
+    static std::atomic<bool> s_reloadPosted = false;
+
+    static FileRecord MakeFileRecord(const std::filesystem::path& path, const std::string_view contents)
     {
-        return _wcsicmp(key.c_str(), target) == 0;
+        FileRecord record;
+        std::error_code error;
+        record.writeTime = std::filesystem::last_write_time(path, error);
+        record.valid = !error;
+        record.hash = HashConfigBytes(contents);
+        record.size = contents.size();
+        return record;
     }
-    
-    // Safe string to integer conversion with default value.
-    static int ParseInt(const std::wstring& str, const int defaultValue = 0)
+
+    static ConfigSnapshot::IniStamp MakeIniStamp(const FileRecord& record)
     {
-        try
-        {
-            return std::stoi(str);
-        }
-        catch (...)
-        {
-            return defaultValue;
-        }
+        ConfigSnapshot::IniStamp stamp;
+        stamp.size = record.size;
+        stamp.writeTime = (int64_t)record.writeTime.time_since_epoch().count();
+        stamp.hash = record.hash;
+        return stamp;
     }
-    
-    // Safe string to float conversion with default value.
-    static float ParseFloat(const std::wstring& str, const float defaultValue = 1.0f)
+
+    static bool StampMatches(const ConfigSnapshot::IniStamp& stamp, const FileRecord& record)
     {
-        try
-        {
-            return std::stof(str);
-        }
-        catch (...)
-        {
-            return defaultValue;
-        }
+        const ConfigSnapshot::IniStamp current = MakeIniStamp(record);
+        return record.valid && stamp.size == current.size && stamp.writeTime == current.writeTime &&
+               stamp.hash == current.hash;
     }
-    
+
     // Clamp a loaded profile to the same ranges the sliders permit, so a hand-edited
     // config can't assign values outside what the UI lets the user pick.
     static void ClampProfileValues(Profile& profile)
@@ -140,200 +188,588 @@ namespace ConfigManager
         return sanitized;
     }
     
-    // Check if a profile with the given name already exists (case-insensitive).
-    static bool ProfileExists(const std::wstring& name)
-    {
-        return std::find_if(App::profiles.begin(), App::profiles.end(),
-            [&name](const Profile& p)
-            {
-                return _wcsicmp(p.name.c_str(), name.c_str()) == 0;
-            }) != App::profiles.end();
-    }
-
-    // Finalize and add a completed profile to the profiles list.
+    // Finalize and add a completed profile to the profiles list, unless one with the same name
+    // (case-insensitive) is already there; names is the index over profiles.
     // This is called when we encounter a new section or reach end of file,
     // indicating that the current profile definition is complete.
-    static void FinalizeProfile(Profile& profile)
+    static void FinalizeProfile(Profile& profile, std::vector<Profile>& profiles, ProfileNameIndex& names)
     {
-        if (!profile.name.empty() && !ProfileExists(profile.name))
+        if (!profile.name.empty() && names.Find(profile.name) < 0)
         {
             ClampProfileValues(profile);
-            App::profiles.push_back(profile);
+            profiles.push_back(std::move(profile));
+            names.Add((int)profiles.size() - 1);
         }
 
         // Reset profile for potential reuse.
         profile = Profile();
     }
     
-    bool Load()
+    // Read the whole file into memory in one go.
+    static bool ReadConfigFile(const std::filesystem::path& path, std::string& contents)
     {
-        std::lock_guard<std::mutex> lock(configMutex);
-        
-        App::profiles.clear();
-        const std::wstring path = PathUtils::GetConfigPath();
-        std::ifstream ifs(path, std::ios::binary);
-
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
         if (!ifs)
+            return false;
+
+        const std::streamoff size = ifs.tellg();
+        if (size < 0)
+            return false;
+
+        contents.resize((size_t)size);
+        ifs.seekg(0);
+        return (bool)ifs.read(contents.data(), (std::streamsize)contents.size());
+    }
+
+    // Number parsing with a default for missing or malformed values; never throws.
+    static int ParseInt(const std::string_view value, const int defaultValue = 0)
+    {
+        int result = defaultValue;
+        ConfigParser::ParseInt(value, result);
+        return result;
+    }
+
+    static float ParseFloat(const std::string_view value, const float defaultValue = 1.0f)
+    {
+        float result = defaultValue;
+        ConfigParser::ParseFloat(value, result);
+        return result;
+    }
+
+    // Global settings, one case per key; anything else in the section is ignored. Every global is an
+    // integer (or a 0/1 flag), so a parsed value is all the binary snapshot needs to store.
+    static void SetGlobalSetting(const ConfigParser::Key key, const int value)
+    {
+        using ConfigParser::Key;
+
+        switch (key)
         {
-            return false; // Config file doesn't exist or can't be opened.
+        case Key::ToggleHotkey: App::toggleHotkey = static_cast<UINT>(value); break;
+        case Key::NextProfileHotkey: App::nextProfileHotkey = static_cast<UINT>(value); break;
+        case Key::PreviousProfileHotkey: App::previousProfileHotkey = static_cast<UINT>(value); break;
+        case Key::BrightnessUpHotkey: App::brightnessUpHotkey = static_cast<UINT>(value); break;
+        case Key::BrightnessDownHotkey: App::brightnessDownHotkey = static_cast<UINT>(value); break;
+        case Key::ContrastUpHotkey: App::contrastUpHotkey = static_cast<UINT>(value); break;
+        case Key::ContrastDownHotkey: App::contrastDownHotkey = static_cast<UINT>(value); break;
+        case Key::GammaUpHotkey: App::gammaUpHotkey = static_cast<UINT>(value); break;
+        case Key::GammaDownHotkey: App::gammaDownHotkey = static_cast<UINT>(value); break;
+        case Key::LoopProfiles: App::loopProfiles = (value != 0); break;
+        case Key::StartMinimized: App::startMinimized = (value != 0); break;
+        case Key::MinimizeToTray: App::minimizeToTray = (value != 0); break;
+        case Key::LaunchOnStartup: App::launchOnStartup = (value != 0); break;
+        case Key::SelectedDisplay: App::selectedDisplayIndex = value; break;
+        case Key::ApplyProfileOnLaunch: App::applyProfileOnLaunch = (value != 0); break;
+        case Key::SelectedProfileIndex: App::selectedProfileIndex = value; break;
+        case Key::AdvancedMode: App::state.SetAdvancedModeEnabled((value != 0)); break;
+        case Key::TransitionMs:
+            App::transitionMs = std::clamp(value, TransitionRange::MS_MIN, TransitionRange::MS_MAX);
+            break;
+        case Key::DurableSave: App::durableSave = (value != 0); break;
+        case Key::JournalSave: App::journalSave = (value != 0); break;
+        case Key::ReleaseUIAfterSec:
+            App::releaseUIAfterSec = std::clamp(value, UIReleaseRange::SEC_MIN, UIReleaseRange::SEC_MAX);
+            break;
+        default:
+            break;
+        }
+    }
+
+    static int ParseGlobalSetting(const ConfigParser::Key key, const std::string_view value)
+    {
+        switch (key)
+        {
+        case ConfigParser::Key::TransitionMs: return ParseInt(value, TransitionRange::MS_DEFAULT);
+        case ConfigParser::Key::ReleaseUIAfterSec: return ParseInt(value, UIReleaseRange::SEC_DEFAULT);
+        default: return ParseInt(value, 0);
         }
+    }
 
-        std::string rawLine;
-        bool firstLine = true;
-        Profile currentProfile;
-        ConfigSection currentSection = ConfigSection::None;
+    static void LoadGlobalSetting(const ConfigParser::Key key, const std::string_view value)
+    {
+        SetGlobalSetting(key, ParseGlobalSetting(key, value));
+    }
+
+    // Profile fields shared by [Profile] and [SimpleProfile]; the simple profile has no name or hotkey.
+    static void LoadProfileField(Profile& profile, const bool simple, const ConfigParser::Key key, const std::string_view value)
+    {
+        using ConfigParser::Key;
 
-        // Iterate through each line of the config. The file is stored as UTF-8.
-        while (std::getline(ifs, rawLine))
+        switch (key)
         {
-            // Strip a UTF-8 byte-order mark from the first line if present.
-            if (firstLine && rawLine.size() >= 3 &&
-                (unsigned char)rawLine[0] == 0xEF &&
-                (unsigned char)rawLine[1] == 0xBB &&
-                (unsigned char)rawLine[2] == 0xBF)
-            {
-                rawLine.erase(0, 3);
-            }
-            firstLine = false;
+        case Key::Name:
+            if (!simple)
+                profile.name = SanitizeProfileName(StringUtils::UTF8ToWide(std::string(value)));
+            break;
+        case Key::Brightness: profile.brightness = ParseInt(value, 0); break;
+        case Key::Contrast: profile.contrast = ParseFloat(value, 1.0f); break;
+        case Key::Gamma: profile.gamma = ParseFloat(value, 1.0f); break;
+        case Key::Hotkey:
+            if (!simple)
+                profile.hotkey = static_cast<UINT>(ParseInt(value, 0));
+            break;
+        default:
+            break;
+        }
+    }
 
-            // Convert UTF-8 to wide for parsing. Trim also removes any trailing CR.
-            std::wstring line = StringUtils::UTF8ToWide(rawLine);
-            StringUtils::Trim(line);
-            if (line.empty() || line[0] == L';' || line[0] == L'#')
-                continue;
+    // The [GlobalHotkeys] section: global hotkeys and settings.
+    static void WriteGlobalSettings(ConfigWriter& out)
+    {
+        using ConfigParser::Key;
 
-            // Handle section headers, now entered a new section.
-            if (line.front() == L'[' && line.back() == L']')
-            {
-                std::wstring section = line.substr(1, line.size() - 2);
-                StringUtils::Trim(section);
+        out.Section(ConfigParser::Section::GlobalHotkeys);
+        out.Int(Key::ToggleHotkey, App::toggleHotkey);
+        out.Int(Key::NextProfileHotkey, App::nextProfileHotkey);
+        out.Int(Key::PreviousProfileHotkey, App::previousProfileHotkey);
+        out.Int(Key::BrightnessUpHotkey, App::brightnessUpHotkey);
+        out.Int(Key::BrightnessDownHotkey, App::brightnessDownHotkey);
+        out.Int(Key::ContrastUpHotkey, App::contrastUpHotkey);
+        out.Int(Key::ContrastDownHotkey, App::contrastDownHotkey);
+        out.Int(Key::GammaUpHotkey, App::gammaUpHotkey);
+        out.Int(Key::GammaDownHotkey, App::gammaDownHotkey);
+        out.Bool(Key::LoopProfiles, App::loopProfiles);
+        out.Bool(Key::StartMinimized, App::startMinimized);
+        out.Bool(Key::MinimizeToTray, App::minimizeToTray);
+        out.Bool(Key::LaunchOnStartup, App::launchOnStartup);
+        out.Int(Key::SelectedDisplay, App::selectedDisplayIndex);
+        out.Bool(Key::ApplyProfileOnLaunch, App::applyProfileOnLaunch);
+        out.Int(Key::SelectedProfileIndex, App::selectedProfileIndex);
+        out.Bool(Key::AdvancedMode, App::state.IsAdvancedModeEnabled());
+        out.Int(Key::TransitionMs, App::transitionMs);
+        out.Bool(Key::DurableSave, App::durableSave);
+        out.Bool(Key::JournalSave, App::journalSave);
+        out.Int(Key::ReleaseUIAfterSec, App::releaseUIAfterSec);
+    }
 
-                // Handle switching sections, finalize any profile we were building.
-                if (currentSection == ConfigSection::Profile)
-                {
-                    FinalizeProfile(currentProfile);
-                }
+    // A profile's fields, after its section header; the simple profile has no name or hotkey.
+    static void WriteProfileFields(ConfigWriter& out, const Profile& profile, const bool simple)
+    {
+        using ConfigParser::Key;
 
-                if (KeyEquals(section, Keys::SECTION_PROFILE))
-                {
-                    currentSection = ConfigSection::Profile;
-                }
-                else if (KeyEquals(section, Keys::SECTION_SIMPLEPROFILE))
-                {
-                    currentSection = ConfigSection::SimpleProfile;
-                }
-                else if (KeyEquals(section, Keys::SECTION_GLOBALHOTKEYS))
-                {
-                    currentSection = ConfigSection::GlobalHotkeys;
-                }
-                else
-                {
-                    currentSection = ConfigSection::None; // Unknown section.
-                }
+        if (!simple)
+            out.String(Key::Name, profile.name);
+        out.Int(Key::Brightness, profile.brightness);
+        out.Float(Key::Contrast, profile.contrast);
+        out.Float(Key::Gamma, profile.gamma);
+        if (!simple)
+            out.Int(Key::Hotkey, profile.hotkey);
+    }
 
-                continue;
-            }
+    // Serialize the whole configuration as the UTF-8 bytes that go on disk.
+    static void SerializeConfig(std::string& buffer)
+    {
+        using ConfigParser::Section;
 
-            // Key=Value pairs.
-            const auto eq = line.find(L'=');
-            if (eq == std::wstring::npos)
+        // Roughly 100 bytes per profile plus the fixed sections; reserving up front means a
+        // reused buffer only grows when the profile list does.
+        buffer.clear();
+        buffer.reserve(1024 + App::profiles.size() * 128);
+        ConfigWriter out(buffer);
+
+        // Write configuration file header.
+        out.Comment("Configuration file for GammaHotkey application.");
+        out.Comment("Hotkey values are virtual-key codes, plus 256 x the Windows MOD_* flags for modifiers (0 = none).");
+        out.BlankLine();
+
+        // Save global hotkeys and settings.
+        WriteGlobalSettings(out);
+        out.BlankLine();
+
+        // Save simple profile.
+        out.Section(Section::SimpleProfile);
+        WriteProfileFields(out, App::simpleProfile, true);
+        out.BlankLine();
+
+        // Save profiles.
+        for (const auto& profile : App::profiles)
+        {
+            out.Section(Section::Profile);
+            WriteProfileFields(out, profile, false);
+            out.BlankLine();
+        }
+    }
+
+    static bool ProfilesEqual(const Profile& a, const Profile& b)
+    {
+        return a.name == b.name && a.brightness == b.brightness && a.contrast == b.contrast &&
+               a.gamma == b.gamma && a.hotkey == b.hotkey;
+    }
+
+    // Journal mode: remember the current state as what is on disk, after a load or a full save.
+    static void CaptureJournalBase(const uint64_t iniSize)
+    {
+        s_journalBase.valid = true;
+        s_journalBase.globals.clear();
+        ConfigWriter out(s_journalBase.globals);
+        WriteGlobalSettings(out);
+        s_journalBase.simpleProfile = App::simpleProfile;
+        s_journalBase.profiles = App::profiles;
+        s_journalBase.iniSize = iniSize;
+    }
+
+    // Journal mode: append to body a record of everything changed since the base, and move the base
+    // up to the current state. The profile list is compared from both ends, so the record only covers
+    // the span that changed: an edit or a swap rewrites those profiles by index, and an add or delete
+    // inserts or removes them, without touching the thousands around them. Leaves body empty if
+    // nothing changed.
+    static void JournalChanges(std::string& body)
+    {
+        using ConfigParser::Key;
+        using ConfigParser::Section;
+
+        body.clear();
+        ConfigWriter out(body);
+
+        static std::string globals;
+        globals.clear();
+        ConfigWriter globalsOut(globals);
+        WriteGlobalSettings(globalsOut);
+        if (globals != s_journalBase.globals)
+        {
+            body += globals;
+            s_journalBase.globals.swap(globals);
+        }
+
+        if (!ProfilesEqual(App::simpleProfile, s_journalBase.simpleProfile))
+        {
+            out.Section(Section::SimpleProfile);
+            WriteProfileFields(out, App::simpleProfile, true);
+            s_journalBase.simpleProfile = App::simpleProfile;
+        }
+
+        const std::vector<Profile>& before = s_journalBase.profiles;
+        const std::vector<Profile>& after = App::profiles;
+        const size_t shorter = std::min(before.size(), after.size());
+
+        size_t prefix = 0;
+        while (prefix < shorter && ProfilesEqual(before[prefix], after[prefix]))
+            ++prefix;
+        size_t suffix = 0;
+        while (suffix < shorter - prefix &&
+               ProfilesEqual(before[before.size() - 1 - suffix], after[after.size() - 1 - suffix]))
+        {
+            ++suffix;
+        }
+
+        const size_t removed = before.size() - prefix - suffix;
+        const size_t added = after.size() - prefix - suffix;
+        const size_t rewritten = std::min(removed, added);
+        if (removed == 0 && added == 0)
+            return;
+
+        for (size_t index = prefix; index < prefix + rewritten; ++index)
+        {
+            if (ProfilesEqual(before[index], after[index]))
                 continue;
-            
-            std::wstring key = line.substr(0, eq);
-            std::wstring val = line.substr(eq + 1);
-            StringUtils::Trim(key);
-            StringUtils::Trim(val);
+            out.Section(Section::Profile);
+            out.Int(Key::Index, (int64_t)index);
+            WriteProfileFields(out, after[index], false);
+        }
 
-            switch (currentSection)
-            {
-            case ConfigSection::GlobalHotkeys:
-            {
-                // Global settings, using dispatch table with lambdas.
-                using HandlerFunc = std::function<void(const std::wstring&)>;
-
-                // Static handler map with case-insensitive comparator.
-                static const std::map<std::wstring, HandlerFunc, CaseInsensitiveCompare> handlers = {
-                    {Keys::TOGGLE_HOTKEY, [](const std::wstring& v) { App::toggleHotkey = static_cast<UINT>(ParseInt(v, 0)); }},
-                    {Keys::NEXTPROFILE_HOTKEY, [](const std::wstring& v) { App::nextProfileHotkey = static_cast<UINT>(ParseInt(v, 0)); }},
-                    {Keys::PREVIOUSPROFILE_HOTKEY, [](const std::wstring& v) { App::previousProfileHotkey = static_cast<UINT>(ParseInt(v, 0)); }},
-                    {Keys::LOOP_PROFILES, [](const std::wstring& v) { App::loopProfiles = (ParseInt(v, 0) != 0); }},
-                    {Keys::START_MINIMIZED, [](const std::wstring& v) { App::startMinimized = (ParseInt(v, 0) != 0); }},
-                    {Keys::MINIMIZE_TO_TRAY, [](const std::wstring& v) { App::minimizeToTray = (ParseInt(v, 0) != 0); }},
-                    {Keys::LAUNCH_ON_STARTUP, [](const std::wstring& v) { App::launchOnStartup = (ParseInt(v, 0) != 0); }},
-                    {Keys::SELECTED_DISPLAY, [](const std::wstring& v) { App::selectedDisplayIndex = ParseInt(v, 0); }},
-                    {Keys::APPLY_ON_LAUNCH, [](const std::wstring& v) { App::applyProfileOnLaunch = (ParseInt(v, 0) != 0); }},
-                    {Keys::SELECTED_PROFILE_INDEX, [](const std::wstring& v) { App::selectedProfileIndex = ParseInt(v, 0); }},
-                    {Keys::ADVANCED_MODE, [](const std::wstring& v) { App::state.SetAdvancedModeEnabled((ParseInt(v, 0) != 0)); }}
-                };
-
-                // Lookup using case-insensitive comparator.
-                const auto it = handlers.find(key);
-                if (it != handlers.end())
-                {
-                    it->second(val);
-                }
+        const size_t tail = prefix + rewritten;
+        for (size_t count = rewritten; count < removed; ++count)
+        {
+            out.Section(Section::Profile);
+            out.Int(Key::RemoveAt, (int64_t)tail);
+        }
+        for (size_t index = tail; index < prefix + added; ++index)
+        {
+            out.Section(Section::Profile);
+            out.Int(Key::InsertAt, (int64_t)index);
+            WriteProfileFields(out, after[index], false);
+        }
 
-                break;
-            }
-            case ConfigSection::SimpleProfile:
+        // Replace just the changed span of the base.
+        std::vector<Profile>& base = s_journalBase.profiles;
+        base.erase(base.begin() + prefix, base.begin() + prefix + removed);
+        base.insert(base.begin() + prefix, after.begin() + prefix, after.begin() + prefix + added);
+    }
+
+    // The journal sits beside the ini, e.g. "GammaHotkey.ini.journal".
+    static std::wstring GetJournalPath()
+    {
+        return PathUtils::GetConfigPath() + L".journal";
+    }
+
+    // Apply one journal record on top of the loaded config. In a [Profile] section, Index, InsertAt or
+    // RemoveAt comes first and picks the profile the fields that follow belong to.
+    static void ApplyJournalRecord(const std::string_view body)
+    {
+        using ConfigParser::Key;
+
+        int target = -1;
+        ConfigParser::Parse(body, [&](const ConfigParser::Entry& entry)
+        {
+            if (entry.IsSectionHeader())
             {
-                // Simplified profile settings.
-                if (KeyEquals(key, Keys::PROFILE_BRIGHTNESS))
-                {
-                    App::simpleProfile.brightness = ParseInt(val, 0);
-                }
-                else if (KeyEquals(key, Keys::PROFILE_CONTRAST))
-                {
-                    App::simpleProfile.contrast = ParseFloat(val, 1.0f);
-                }
-                else if (KeyEquals(key, Keys::PROFILE_GAMMA))
-                {
-                    App::simpleProfile.gamma = ParseFloat(val, 1.0f);
-                }
+                target = -1;
+                return;
+            }
 
+            switch (entry.section)
+            {
+            case ConfigParser::Section::GlobalHotkeys:
+                LoadGlobalSetting(entry.key, entry.value);
                 break;
-            }
-                
-            case ConfigSection::Profile:
+            case ConfigParser::Section::SimpleProfile:
+                LoadProfileField(App::simpleProfile, true, entry.key, entry.value);
+                break;
+            case ConfigParser::Section::Profile:
             {
-                // Profile settings.
-                if (KeyEquals(key, Keys::PROFILE_NAME))
+                const int count = (int)App::profiles.size();
+                if (entry.key == Key::Index)
                 {
-                    currentProfile.name = SanitizeProfileName(val);
+                    const int index = ParseInt(entry.value, -1);
+                    target = (index >= 0 && index < count) ? index : -1;
                 }
-                else if (KeyEquals(key, Keys::PROFILE_BRIGHTNESS))
+                else if (entry.key == Key::InsertAt)
                 {
-                    currentProfile.brightness = ParseInt(val, 0);
+                    target = std::clamp(ParseInt(entry.value, count), 0, count);
+                    App::profiles.insert(App::profiles.begin() + target, Profile());
                 }
-                else if (KeyEquals(key, Keys::PROFILE_CONTRAST))
+                else if (entry.key == Key::RemoveAt)
                 {
-                    currentProfile.contrast = ParseFloat(val, 1.0f);
+                    const int index = ParseInt(entry.value, -1);
+                    if (index >= 0 && index < count)
+                        App::profiles.erase(App::profiles.begin() + index);
+                    target = -1;
                 }
-                else if (KeyEquals(key, Keys::PROFILE_GAMMA))
+                else if (target != -1)
                 {
-                    currentProfile.gamma = ParseFloat(val, 1.0f);
+                    LoadProfileField(App::profiles[target], false, entry.key, entry.value);
                 }
-                else if (KeyEquals(key, Keys::PROFILE_HOTKEY))
+                break;
+            }
+            case ConfigParser::Section::None:
+            default:
+                break;
+            }
+        });
+    }
+
+    // Replay the journal, if any, on top of the ini just loaded. Caller holds configMutex.
+    static void ReplayJournal(const std::string_view ini)
+    {
+        s_journalBase.journalSize = 0;
+        s_journalBase.needsCompaction = false;
+
+        std::string journal;
+        s_journalOnDisk = ReadConfigFile(GetJournalPath(), journal);
+        if (!s_journalOnDisk)
+            return;
+
+        const ConfigJournal::ReadResult result =
+            ConfigJournal::Read(journal, HashConfigBytes(ini), ini.size(), ApplyJournalRecord);
+
+        // Replayed values skipped ClampProfileValues on the way in.
+        for (Profile& profile : App::profiles)
+            ClampProfileValues(profile);
+
+        // A stale header or a torn tail is harmless to read past, but nothing more can be appended
+        // after it; the next save rewrites the ini in full and deletes the journal.
+        s_journalBase.journalSize = journal.size();
+        s_journalBase.needsCompaction = !result.matched || result.torn;
+    }
+
+    // A config file as parsed, before it is applied to App. Parsing touches no App state, so the saver
+    // thread can also parse what it has just written, to build the binary snapshot from.
+    struct ParsedConfig
+    {
+        std::vector<std::pair<ConfigParser::Key, int>> globals; // [GlobalHotkeys] values in file order.
+        Profile simpleProfile;
+        uint32_t simpleFields = 0; // ConfigSnapshot::SIMPLE_* bits for the values the file sets.
+        std::vector<Profile> profiles;
+    };
+
+    static void ParseConfigText(const std::string_view contents, ParsedConfig& parsed)
+    {
+        using ConfigParser::Key;
+
+        Profile currentProfile;
+        ConfigParser::Section currentSection = ConfigParser::Section::None;
+        ProfileNameIndex names(parsed.profiles);
+
+        ConfigParser::Parse(contents, [&](const ConfigParser::Entry& entry)
+        {
+            // Handle section headers, now entered a new section.
+            if (entry.IsSectionHeader())
+            {
+                // Handle switching sections, finalize any profile we were building.
+                if (currentSection == ConfigParser::Section::Profile)
                 {
-                    currentProfile.hotkey = static_cast<UINT>(ParseInt(val, 0));
+                    FinalizeProfile(currentProfile, parsed.profiles, names);
                 }
-
-                break;
+                currentSection = entry.section;
+                return;
             }
 
-            case ConfigSection::None:
+            switch (entry.section)
+            {
+            case ConfigParser::Section::GlobalHotkeys:
+                parsed.globals.emplace_back(entry.key, ParseGlobalSetting(entry.key, entry.value));
+                break;
+            case ConfigParser::Section::SimpleProfile:
+                LoadProfileField(parsed.simpleProfile, true, entry.key, entry.value);
+                if (entry.key == Key::Brightness)
+                    parsed.simpleFields |= ConfigSnapshot::SIMPLE_BRIGHTNESS;
+                else if (entry.key == Key::Contrast)
+                    parsed.simpleFields |= ConfigSnapshot::SIMPLE_CONTRAST;
+                else if (entry.key == Key::Gamma)
+                    parsed.simpleFields |= ConfigSnapshot::SIMPLE_GAMMA;
+                break;
+            case ConfigParser::Section::Profile:
+                LoadProfileField(currentProfile, false, entry.key, entry.value);
+                break;
+            case ConfigParser::Section::None:
             default:
                 // Ignore key-value pairs outside of known sections.
                 break;
             }
-        }
+        });
 
         // Finalize the last profile if we ended the file while in a profile section.
-        if (currentSection == ConfigSection::Profile)
+        if (currentSection == ConfigParser::Section::Profile)
+        {
+            FinalizeProfile(currentProfile, parsed.profiles, names);
+        }
+    }
+
+    // Simple profile values the file sets; the rest keep their current values, as with a text load.
+    static void SetSimpleProfileFields(const uint32_t fields, const int brightness, const float contrast, const float gamma)
+    {
+        if (fields & ConfigSnapshot::SIMPLE_BRIGHTNESS)
+            App::simpleProfile.brightness = brightness;
+        if (fields & ConfigSnapshot::SIMPLE_CONTRAST)
+            App::simpleProfile.contrast = contrast;
+        if (fields & ConfigSnapshot::SIMPLE_GAMMA)
+            App::simpleProfile.gamma = gamma;
+    }
+
+    static void ApplyParsedConfig(ParsedConfig& parsed)
+    {
+        for (const std::pair<ConfigParser::Key, int>& global : parsed.globals)
+            SetGlobalSetting(global.first, global.second);
+
+        SetSimpleProfileFields(parsed.simpleFields, parsed.simpleProfile.brightness,
+                               parsed.simpleProfile.contrast, parsed.simpleProfile.gamma);
+        App::profiles = std::move(parsed.profiles);
+    }
+
+    // The binary snapshot sits beside the ini, e.g. "GammaHotkey.ini.snapshot".
+    static std::wstring GetSnapshotPath()
+    {
+        return PathUtils::GetConfigPath() + L".snapshot";
+    }
+
+    static void BuildBinarySnapshot(const ParsedConfig& parsed, const ConfigSnapshot::IniStamp& ini, std::string& out)
+    {
+        ConfigSnapshot::Builder builder;
+        for (const std::pair<ConfigParser::Key, int>& global : parsed.globals)
+            builder.AddGlobal(global.first, global.second);
+
+        builder.SetSimpleProfile(parsed.simpleFields, parsed.simpleProfile.brightness,
+                                 parsed.simpleProfile.contrast, parsed.simpleProfile.gamma);
+
+        for (const Profile& profile : parsed.profiles)
+            builder.AddProfile(profile.name, profile.brightness, profile.contrast, profile.gamma, profile.hotkey);
+
+        builder.Finish(ini, out);
+    }
+
+    // Map the binary snapshot and, if it was built from exactly this ini, load from it. Caller holds
+    // configMutex.
+    static bool LoadBinarySnapshot(const FileRecord& ini)
+    {
+        s_snapshotValid = false;
+        if (!ini.valid)
+            return false;
+
+        const HANDLE file = CreateFileW(GetSnapshotPath().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size = {};
+        const HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+            ? CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL)
+            : NULL;
+        CloseHandle(file); // The mapping keeps the file open.
+        if (!mapping)
+            return false;
+
+        const void* const view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // And the view keeps the mapping.
+        if (!view)
+            return false;
+
+        ConfigSnapshot::View snapshot;
+        const bool valid = snapshot.Open(view, (size_t)size.QuadPart, MakeIniStamp(ini));
+        if (valid)
+        {
+            const ConfigSnapshot::Header& header = snapshot.GetHeader();
+            for (uint32_t index = 0; index < header.globalCount; ++index)
+            {
+                const ConfigSnapshot::GlobalRecord global = snapshot.GetGlobal(index);
+                SetGlobalSetting((ConfigParser::Key)global.key, global.value);
+            }
+
+            SetSimpleProfileFields(header.simpleFields, header.simpleBrightness, header.simpleContrast, header.simpleGamma);
+
+            App::profiles.resize(header.profileCount);
+            for (uint32_t index = 0; index < header.profileCount; ++index)
+            {
+                const ConfigSnapshot::ProfileRecord record = snapshot.GetProfile(index);
+                Profile& profile = App::profiles[index];
+                snapshot.AppendName(record, profile.name);
+                profile.brightness = record.brightness;
+                profile.contrast = record.contrast;
+                profile.gamma = record.gamma;
+                profile.hotkey = record.hotkey;
+            }
+
+            s_snapshotValid = true;
+            s_snapshotStamp = MakeIniStamp(ini);
+        }
+
+        UnmapViewOfFile(view);
+        return valid;
+    }
+
+    // Everything Load does once the ini is in memory; Reload shares it, passing the profiles it
+    // replaces so they keep their IDs. Caller holds configMutex.
+    static void LoadContents(const FileRecord& file, const std::string& contents,
+                             const std::vector<Profile>& previousProfiles = {})
+    {
+        App::profiles.clear();
+
+        // If nothing changes before the next Save, it will serialize these exact bytes (when we
+        // wrote them), and can skip the write.
+        s_lastFile = file;
+
+        // The binary snapshot, when it was built from exactly this ini, saves parsing it.
+        if (!LoadBinarySnapshot(s_lastFile))
         {
-            FinalizeProfile(currentProfile);
+            ParsedConfig parsed;
+            ParseConfigText(contents, parsed);
+
+            // Have the saver write a snapshot of this parse, so the next start can skip it.
+            if (s_lastFile.valid)
+            {
+                const ConfigSnapshot::IniStamp stamp = MakeIniStamp(s_lastFile);
+                std::lock_guard<std::mutex> saverLock(s_saver.mutex);
+                BuildBinarySnapshot(parsed, stamp, s_saver.binary);
+                s_saver.binaryStamp = stamp;
+                s_saver.binaryPending = true;
+            }
+
+            ApplyParsedConfig(parsed);
         }
 
+        // Changes saved since the ini was last written in full.
+        ReplayJournal(contents);
+        App::profileNames.Rebuild();
+        ProfileManager::AssignIds(previousProfiles);
+
         // Clamp simple-mode values in case the config was hand-edited or corrupted.
         ClampProfileValues(App::simpleProfile);
 
@@ -343,92 +779,574 @@ namespace ConfigManager
         if (App::selectedProfileIndex < -1)
             App::selectedProfileIndex = -1;
 
-        return true;
+        // Journal mode diffs the next save against what was just loaded.
+        if (App::journalSave)
+            CaptureJournalBase(contents.size());
+        else
+            s_journalBase.valid = false;
     }
-    
-    bool Save()
+
+    bool Load()
     {
         std::lock_guard<std::mutex> lock(configMutex);
         
-        const std::filesystem::path finalPath = PathUtils::GetConfigPath();
-        const std::filesystem::path tempPath = std::filesystem::path(finalPath).concat(L".tmp");
+        App::profiles.clear();
 
-        // Build the file content as wide text, then encode to UTF-8. This preserves
-        // non-ASCII profile names, which a wide file stream with the default locale
-        // could not encode (silently failing the whole save).
-        std::wostringstream out;
+        // The file is stored as UTF-8. Read it once and let ConfigParser walk it in place, with no
+        // per-line copies; only profile names are ever converted to wide strings.
+        const std::filesystem::path path = PathUtils::GetConfigPath();
+        std::string contents;
+        if (!ReadConfigFile(path, contents))
+        {
+            App::profileNames.Rebuild();
 
-        // Write configuration file header.
-        out << L"; Configuration file for GammaHotkey application.\n";
-        out << L"; Hotkey values are virtual-key codes (0 = none).\n\n";
+            // A journal without its ini can never be replayed; note it so the first save deletes it.
+            std::error_code error;
+            s_journalOnDisk = std::filesystem::exists(GetJournalPath(), error);
+            s_journalBase.valid = false;
+            return false; // Config file doesn't exist or can't be opened.
+        }
 
-        // Save global hotkeys and settings.
-        out << L"[" << Keys::SECTION_GLOBALHOTKEYS << L"]\n";
-        out << Keys::TOGGLE_HOTKEY << L"=" << App::toggleHotkey << L"\n";
-        out << Keys::NEXTPROFILE_HOTKEY << L"=" << App::nextProfileHotkey << L"\n";
-        out << Keys::PREVIOUSPROFILE_HOTKEY << L"=" << App::previousProfileHotkey << L"\n";
-        out << Keys::LOOP_PROFILES << L"=" << (App::loopProfiles ? 1 : 0) << L"\n";
-        out << Keys::START_MINIMIZED << L"=" << (App::startMinimized ? 1 : 0) << L"\n";
-        out << Keys::MINIMIZE_TO_TRAY << L"=" << (App::minimizeToTray ? 1 : 0) << L"\n";
-        out << Keys::LAUNCH_ON_STARTUP << L"=" << (App::launchOnStartup ? 1 : 0) << L"\n";
-        out << Keys::SELECTED_DISPLAY << L"=" << App::selectedDisplayIndex << L"\n";
-        out << Keys::APPLY_ON_LAUNCH << L"=" << (App::applyProfileOnLaunch ? 1 : 0) << L"\n";
-        out << Keys::SELECTED_PROFILE_INDEX << L"=" << App::selectedProfileIndex << L"\n";
-        out << Keys::ADVANCED_MODE << L"=" << (App::state.IsAdvancedModeEnabled() ? 1 : 0) << L"\n\n";
+        LoadContents(MakeFileRecord(path, contents), contents);
+        return true;
+    }
 
-        // Save simple profile.
-        out << L"[" << Keys::SECTION_SIMPLEPROFILE << L"]\n";
-        out << Keys::PROFILE_BRIGHTNESS << L"=" << App::simpleProfile.brightness << L"\n";
-        out << Keys::PROFILE_CONTRAST << L"=" << App::simpleProfile.contrast << L"\n";
-        out << Keys::PROFILE_GAMMA << L"=" << App::simpleProfile.gamma << L"\n\n";
+    // The values a profile applies, whatever it is called or bound to.
+    static bool SameAdjustment(const Profile& a, const Profile& b)
+    {
+        return a.brightness == b.brightness && a.contrast == b.contrast && a.gamma == b.gamma;
+    }
 
-        // Save profiles.
-        for (const auto& profile : App::profiles)
+    ReloadResult Reload()
+    {
+        ReloadResult result;
+        std::lock_guard<std::mutex> lock(configMutex);
+
+        // Changes from here on need a new notification.
+        s_reloadPosted = false;
+
+        // A file the script is still writing (or has just deleted) is left alone; the write it is in
+        // the middle of will notify again.
+        const std::filesystem::path path = PathUtils::GetConfigPath();
+        std::string contents;
+        if (!ReadConfigFile(path, contents))
+            return result;
+
+        // Our own write, or someone rewrote the same bytes: nothing to apply. Keep the new time, so
+        // save elision still recognizes the file.
+        const FileRecord file = MakeFileRecord(path, contents);
+        if (s_lastFile.valid && file.hash == s_lastFile.hash && file.size == s_lastFile.size)
         {
-            out << L"[" << Keys::SECTION_PROFILE << L"]\n";
-            out << Keys::PROFILE_NAME << L"=" << profile.name << L"\n";
-            out << Keys::PROFILE_BRIGHTNESS << L"=" << profile.brightness << L"\n";
-            out << Keys::PROFILE_CONTRAST << L"=" << profile.contrast << L"\n";
-            out << Keys::PROFILE_GAMMA << L"=" << profile.gamma << L"\n";
-            out << Keys::PROFILE_HOTKEY << L"=" << profile.hotkey << L"\n\n";
+            s_lastFile = file;
+            return result;
         }
 
-        const std::string utf8 = StringUtils::WideToUTF8(out.str());
+        // The file on disk wins over saves still waiting on the saver thread: drop them, and number
+        // this load like a save so one the saver has already picked up is dropped as well.
+        {
+            std::lock_guard<std::mutex> saverLock(s_saver.mutex);
+            if (s_saver.pending || s_saver.journalPending)
+                ++s_coalescedSaves;
+            s_saver.pending = false;
+            s_saver.journalPending = false;
+            s_saver.journal.clear();
+            s_writtenSequence = ++s_saver.nextSequence;
+        }
+
+        // What is applied now, to tell whether it has to be applied again.
+        const bool wasAdvanced = App::state.IsAdvancedModeEnabled();
+        const Profile previousSimple = App::simpleProfile;
+        const bool hadSelected = App::selectedProfileIndex >= 0 && App::selectedProfileIndex < (int)App::profiles.size();
+        const Profile previousSelected = hadSelected ? App::profiles[App::selectedProfileIndex] : Profile();
+        result.previousDisplayIndex = App::selectedDisplayIndex;
+
+        const std::vector<Profile> previousProfiles = std::move(App::profiles);
+        LoadContents(file, contents, previousProfiles);
+
+        const bool hasSelected = App::selectedProfileIndex >= 0 && App::selectedProfileIndex < (int)App::profiles.size();
+        result.reloaded = true;
+        result.modeChanged = wasAdvanced != App::state.IsAdvancedModeEnabled();
+        result.displayChanged = result.previousDisplayIndex != App::selectedDisplayIndex;
+        if (App::state.IsAdvancedModeEnabled())
+        {
+            result.activeChanged = hadSelected != hasSelected ||
+                (hasSelected && (previousSelected.name != App::profiles[App::selectedProfileIndex].name ||
+                                 !SameAdjustment(previousSelected, App::profiles[App::selectedProfileIndex])));
+        }
+        else
+        {
+            result.activeChanged = !SameAdjustment(previousSimple, App::simpleProfile);
+        }
+        result.activeChanged = result.activeChanged || result.modeChanged || result.displayChanged;
+        return result;
+    }
+    
+    // Write the buffer to a temporary file, then rename it over the config. With durable set, the
+    // data is flushed to the disk before the rename and the rename itself is written through, so a
+    // power loss leaves either the old or the new file; without it both are left to the OS cache.
+    static bool WriteConfigFile(const std::wstring& finalPath, const std::string& contents, const bool durable)
+    {
+        const std::wstring tempPath = finalPath + L".tmp";
 
-        // Write to a temporary file first. Text mode translates '\n' to Windows CRLF; this
-        // is safe for UTF-8 because 0x0A never appears inside a multibyte UTF-8 sequence.
-        std::ofstream ofs(tempPath, std::ios::trunc);
-        if (!ofs)
+        const HANDLE file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
         {
             return false;
         }
-        ofs.write(utf8.data(), (std::streamsize)utf8.size());
+
+        DWORD written = 0;
+        bool success = WriteFile(file, contents.data(), (DWORD)contents.size(), &written, NULL) &&
+                       written == (DWORD)contents.size();
+        if (success && durable)
+        {
+            success = FlushFileBuffers(file) != FALSE;
+        }
 
         // Close the file before attempting to rename.
-        ofs.close();
+        success = (CloseHandle(file) != FALSE) && success;
 
         // Check if write was successful.
-        if (ofs.fail())
+        if (!success)
         {
-            std::filesystem::remove(tempPath);
+            DeleteFileW(tempPath.c_str());
             return false;
         }
-        
-        // Atomic replacement: rename temp file over the final file.
-        // std::filesystem::rename replaces an existing destination on Windows, so we do
-        // not remove the original first (doing so would leave a window where a crash loses
-        // the config entirely).
-        try
-        {
-            std::filesystem::rename(tempPath, finalPath);
-        }
-        catch (const std::filesystem::filesystem_error&)
+
+        // Atomic replacement: rename temp file over the final file. We do not remove the original
+        // first (doing so would leave a window where a crash loses the config entirely).
+        const DWORD flags = MOVEFILE_REPLACE_EXISTING | (durable ? MOVEFILE_WRITE_THROUGH : 0);
+        if (!MoveFileExW(tempPath.c_str(), finalPath.c_str(), flags))
         {
             // Failed to rename.
             // Leave the temp file so the user can recover their settings from it.
             return false;
         }
-        
+
+        return true;
+    }
+
+    // Write one serialized snapshot, unless a newer one has already been written. Either thread.
+    static bool WriteSnapshot(const std::string& contents, const uint64_t sequence, const bool durable)
+    {
+        std::lock_guard<std::mutex> lock(configMutex);
+
+        if (sequence < s_writtenSequence)
+        {
+            ++s_coalescedSaves;
+            return true;
+        }
+        s_writtenSequence = sequence;
+
+        const std::wstring finalPath = PathUtils::GetConfigPath();
+
+        // Most saves (a checkbox flipped back, a slider released where it started, a reorder undone)
+        // produce the bytes already on disk. Skip those, as long as nothing else has touched the file
+        // and no journal changes it on load.
+        const FileRecord current = MakeFileRecord(finalPath, contents);
+        if (s_lastFile.valid && current.hash == s_lastFile.hash && current.size == s_lastFile.size &&
+            current.writeTime == s_lastFile.writeTime && !s_journalOnDisk)
+        {
+            ++s_skippedSaves;
+            return true;
+        }
+
+        if (!WriteConfigFile(finalPath, contents, durable))
+        {
+            return false;
+        }
+
+        ++s_writtenSaves;
+        s_lastFile = MakeFileRecord(finalPath, contents);
+
+        // The ini now holds everything the journal did. Should the delete not happen (a crash right
+        // here, or a failure), the journal's header no longer matches the new ini, so Load ignores it.
+        if (s_journalOnDisk && DeleteFileW(GetJournalPath().c_str()))
+            s_journalOnDisk = false;
+        return true;
+    }
+
+    // Write a binary snapshot, as long as the ini it was built from is still the one on disk. Either thread.
+    static bool WriteBinarySnapshot(const std::string& bytes, const ConfigSnapshot::IniStamp& stamp)
+    {
+        std::lock_guard<std::mutex> lock(configMutex);
+
+        if (!StampMatches(stamp, s_lastFile))
+        {
+            return false;
+        }
+
+        // Never flushed: losing it only costs the next start a text parse.
+        if (!WriteConfigFile(GetSnapshotPath(), bytes, false))
+        {
+            return false;
+        }
+
+        s_snapshotValid = true;
+        s_snapshotStamp = stamp;
         return true;
     }
+
+    // After a full write, parse what was written and store the result as the binary snapshot. The parse
+    // runs outside configMutex; if the ini changes meanwhile, the stale snapshot is simply not written.
+    static void RefreshBinarySnapshot(const std::string& contents)
+    {
+        const uint64_t hash = HashConfigBytes(contents);
+        ConfigSnapshot::IniStamp stamp;
+        {
+            std::lock_guard<std::mutex> lock(configMutex);
+            if (!s_lastFile.valid || s_lastFile.hash != hash || s_lastFile.size != contents.size())
+                return; // These bytes were not written after all (skipped or superseded).
+            if (s_snapshotValid && StampMatches(s_snapshotStamp, s_lastFile))
+                return; // Already current, e.g. the write was elided.
+            stamp = MakeIniStamp(s_lastFile);
+        }
+
+        ParsedConfig parsed;
+        ParseConfigText(contents, parsed);
+
+        std::string bytes;
+        BuildBinarySnapshot(parsed, stamp, bytes);
+        WriteBinarySnapshot(bytes, stamp);
+    }
+
+    // Append to the journal, or start one (header included) if there is none yet.
+    static bool AppendJournalFile(const std::wstring& path, const std::string& contents, const bool create, const bool durable)
+    {
+        const HANDLE file = CreateFileW(path.c_str(), create ? GENERIC_WRITE : FILE_APPEND_DATA, 0, NULL,
+                                        create ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        DWORD written = 0;
+        bool success = WriteFile(file, contents.data(), (DWORD)contents.size(), &written, NULL) &&
+                       written == (DWORD)contents.size();
+        if (success && durable)
+        {
+            success = FlushFileBuffers(file) != FALSE;
+        }
+
+        return (CloseHandle(file) != FALSE) && success;
+    }
+
+    // Append journal records, unless a newer save has already been written. Saver thread.
+    static bool WriteJournal(const std::string& records, const uint64_t sequence, const bool durable)
+    {
+        std::lock_guard<std::mutex> lock(configMutex);
+
+        if (sequence < s_writtenSequence)
+        {
+            ++s_coalescedSaves;
+            return true;
+        }
+        s_writtenSequence = sequence;
+
+        // A journal must name the ini it applies to.
+        if (!s_lastFile.valid)
+        {
+            return false;
+        }
+
+        const bool create = !s_journalOnDisk;
+        std::string header;
+        if (create)
+        {
+            ConfigJournal::WriteHeader(header, s_lastFile.hash, s_lastFile.size);
+            header += records;
+        }
+
+        if (!AppendJournalFile(GetJournalPath(), create ? header : records, create, durable))
+        {
+            return false;
+        }
+
+        ++s_journaledSaves;
+        s_journalOnDisk = true;
+        return true;
+    }
+
+    static void RunSaver()
+    {
+        // The saver's own buffers; swapped with the mailbox, so both keep their capacity.
+        std::string contents;
+        std::string journal;
+        std::string binary;
+
+        std::unique_lock<std::mutex> lock(s_saver.mutex);
+        for (;;)
+        {
+            s_saver.signal.wait(lock, [] { return s_saver.pending || s_saver.journalPending || s_saver.binaryPending || s_saver.stop; });
+
+            // Wait out the quiet period. Each newer schedule moves the deadline; a stop writes at once.
+            while (!s_saver.stop && std::chrono::steady_clock::now() < s_saver.due)
+                s_saver.signal.wait_until(lock, s_saver.due);
+
+            // A synchronous Save may have emptied the mailbox meanwhile. Stop only once it is empty,
+            // so the last scheduled save is always written.
+            if (!s_saver.pending && !s_saver.journalPending && !s_saver.binaryPending)
+            {
+                if (s_saver.stop)
+                    break;
+                continue;
+            }
+
+            const bool writeSnapshot = s_saver.pending;
+            const bool writeJournal = s_saver.journalPending;
+            const bool writeBinary = s_saver.binaryPending;
+            const ConfigSnapshot::IniStamp binaryStamp = s_saver.binaryStamp;
+            binary.swap(s_saver.binary);
+            contents.swap(s_saver.snapshot);
+            journal.swap(s_saver.journal);
+            s_saver.journal.clear();
+            const uint64_t sequence = s_saver.sequence;
+            const uint64_t journalSequence = s_saver.journalSequence;
+            const bool durable = s_saver.durable;
+            s_saver.pending = false;
+            s_saver.journalPending = false;
+            s_saver.binaryPending = false;
+
+            lock.unlock();
+            // Load's snapshot goes first; once a newer ini is written it no longer matches anyway.
+            if (writeBinary)
+                WriteBinarySnapshot(binary, binaryStamp);
+
+            bool success = !writeSnapshot || WriteSnapshot(contents, sequence, durable);
+            if (writeSnapshot && success)
+                RefreshBinarySnapshot(contents);
+            if (writeJournal)
+                success = success && WriteJournal(journal, journalSequence, durable);
+
+            // Journal records describe changes since the last save; after a failure the next save
+            // has to be a full one.
+            if (!success)
+                s_journalBroken = true;
+            lock.lock();
+        }
+    }
+
+    bool Save()
+    {
+        // This save is newer than anything waiting, so drop it.
+        uint64_t sequence;
+        {
+            std::lock_guard<std::mutex> lock(s_saver.mutex);
+            if (s_saver.pending || s_saver.journalPending)
+                ++s_coalescedSaves;
+            s_saver.pending = false;
+            s_saver.journalPending = false;
+            s_saver.journal.clear();
+            sequence = ++s_saver.nextSequence;
+        }
+
+        // Reused across saves, so after the first one serializing never allocates unless the
+        // profile list has grown. UI thread only, as are ScheduleSave and Save.
+        static std::string buffer;
+        SerializeConfig(buffer);
+        const bool success = WriteSnapshot(buffer, sequence, App::durableSave);
+        if (success)
+            RefreshBinarySnapshot(buffer);
+
+        if (App::journalSave)
+        {
+            CaptureJournalBase(buffer.size());
+            s_journalBase.journalSize = 0;
+            s_journalBase.needsCompaction = !success;
+        }
+        if (success)
+            s_journalBroken = false;
+        return success;
+    }
+
+    // Whether the next scheduled save can be a journal record rather than a full rewrite.
+    static bool CanJournal()
+    {
+        if (!App::journalSave || !s_journalBase.valid)
+            return false;
+        if (s_journalBroken.exchange(false))
+            s_journalBase.needsCompaction = true;
+
+        // Compact once the journal outgrows half the ini, so replaying it never costs much more
+        // than loading the ini itself.
+        const uint64_t limit = std::max<uint64_t>(JOURNAL_COMPACT_MIN_BYTES, s_journalBase.iniSize / 2);
+        return !s_journalBase.needsCompaction && s_journalBase.journalSize < limit;
+    }
+
+    void ScheduleSave()
+    {
+        if (!s_saverRunning)
+        {
+            Save();
+            return;
+        }
+
+        // Serialize here, where the settings live, so the saver thread never reads App state. The
+        // bytes go into our own buffer and are then swapped into the mailbox, outside the serialize.
+        static std::string buffer;
+
+        if (CanJournal())
+        {
+            static std::string body;
+            JournalChanges(body);
+            if (body.empty())
+                return; // Nothing changed since the last save.
+
+            buffer.clear();
+            ConfigJournal::WriteRecord(buffer, body);
+            s_journalBase.journalSize += buffer.size();
+
+            {
+                std::lock_guard<std::mutex> lock(s_saver.mutex);
+                s_saver.journal += buffer;
+                s_saver.journalSequence = ++s_saver.nextSequence;
+                s_saver.durable = App::durableSave;
+                s_saver.due = std::chrono::steady_clock::now() + std::chrono::milliseconds(SAVE_DELAY_MS);
+                s_saver.journalPending = true;
+            }
+            s_saver.signal.notify_all();
+            return;
+        }
+
+        SerializeConfig(buffer);
+        if (App::journalSave)
+        {
+            // This full save compacts the journal: it starts again empty, on top of these bytes.
+            CaptureJournalBase(buffer.size());
+            s_journalBase.journalSize = 0;
+            s_journalBase.needsCompaction = false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_saver.mutex);
+            if (s_saver.pending || s_saver.journalPending)
+                ++s_coalescedSaves;
+            s_saver.snapshot.swap(buffer);
+            s_saver.sequence = ++s_saver.nextSequence;
+            s_saver.journalPending = false;
+            s_saver.journal.clear();
+            s_saver.durable = App::durableSave;
+            s_saver.due = std::chrono::steady_clock::now() + std::chrono::milliseconds(SAVE_DELAY_MS);
+            s_saver.pending = true;
+        }
+        s_saver.signal.notify_all();
+    }
+
+    void StartSaver()
+    {
+        if (s_saverRunning)
+            return;
+
+        s_saver.stop = false;
+        s_saver.thread = std::thread(RunSaver);
+        s_saverRunning = true;
+    }
+
+    void StopSaver()
+    {
+        if (!s_saverRunning)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(s_saver.mutex);
+            s_saver.stop = true;
+        }
+        s_saver.signal.notify_all();
+        s_saver.thread.join();
+        s_saverRunning = false;
+    }
+
+    // Whether the config on disk differs in size or time from what we last wrote or read. Watcher thread.
+    static bool ConfigFileChanged(const std::filesystem::path& path)
+    {
+        std::error_code error;
+        const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+        if (error)
+            return false; // Gone, e.g. between a delete and a create; creating it notifies again.
+        const uintmax_t size = std::filesystem::file_size(path, error);
+        if (error)
+            return false;
+
+        // Our own writes update s_lastFile under the lock, together with the rename, so they never
+        // look changed here.
+        std::lock_guard<std::mutex> lock(configMutex);
+        return !s_lastFile.valid || writeTime != s_lastFile.writeTime || size != s_lastFile.size;
+    }
+
+    static void RunWatcher(const HWND window)
+    {
+        const std::filesystem::path path = PathUtils::GetConfigPath();
+        const HANDLE handles[2] = { s_watcher.stop, s_watcher.change };
+
+        for (;;)
+        {
+            if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+                return; // Stopped, or the wait failed.
+
+            // Anything in the folder notifies, and one save is several changes (a temp file, a rename,
+            // perhaps a journal or snapshot). Wait until the folder has been quiet for a moment.
+            DWORD wait;
+            do
+            {
+                if (!FindNextChangeNotification(s_watcher.change))
+                    return;
+                wait = WaitForMultipleObjects(2, handles, FALSE, RELOAD_SETTLE_MS);
+            } while (wait == WAIT_OBJECT_0 + 1);
+
+            if (wait != WAIT_TIMEOUT)
+                return;
+
+            if (ConfigFileChanged(path) && !s_reloadPosted.exchange(true))
+                PostMessage(window, ConfigIDs::WM_CONFIG_CHANGED, 0, 0);
+        }
+    }
+
+    void StartWatcher(const HWND window)
+    {
+        if (s_watcher.thread.joinable())
+            return;
+
+        // Watch the folder rather than the file: replacing the file (as Save and most editors do)
+        // would end a watch on the file itself.
+        const std::wstring folder = std::filesystem::path(PathUtils::GetConfigPath()).parent_path().wstring();
+        s_watcher.change = FindFirstChangeNotificationW(folder.c_str(), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+        if (s_watcher.change == INVALID_HANDLE_VALUE)
+        {
+            return; // No hot reload, e.g. a network folder that does not support notifications.
+        }
+
+        s_watcher.stop = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (!s_watcher.stop)
+        {
+            FindCloseChangeNotification(s_watcher.change);
+            s_watcher.change = INVALID_HANDLE_VALUE;
+            return;
+        }
+
+        s_reloadPosted = false;
+        s_watcher.thread = std::thread(RunWatcher, window);
+    }
+
+    void StopWatcher()
+    {
+        if (!s_watcher.thread.joinable())
+            return;
+
+        SetEvent(s_watcher.stop);
+        s_watcher.thread.join();
+        CloseHandle(s_watcher.stop);
+        FindCloseChangeNotification(s_watcher.change);
+        s_watcher.stop = NULL;
+        s_watcher.change = INVALID_HANDLE_VALUE;
+    }
+
+    SaveStats GetSaveStats()
+    {
+        SaveStats stats;
+        stats.written = s_writtenSaves;
+        stats.skipped = s_skippedSaves;
+        stats.coalesced = s_coalescedSaves;
+        stats.journaled = s_journaledSaves;
+        return stats;
+    }
 }
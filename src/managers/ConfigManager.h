@@ -2,12 +2,74 @@
 
 // Configuration file loading and saving.
 
+/**
+ * SAVING:
+ * UI handlers call ScheduleSave, which serializes the config on the calling thread (a few microseconds
+ * for a typical profile list) and hands the bytes to a background saver thread. The saver writes them
+ * once no newer snapshot has arrived for SAVE_DELAY_MS, so a run of changes (dragging through the
+ * display list, toggling several checkboxes) costs one write, and a slow or redirected profile folder
+ * never stalls a frame. Save writes synchronously and supersedes anything still scheduled; the window
+ * uses it on WM_ENDSESSION and WM_DESTROY, where the process may end as soon as the handler returns.
+ *
+ * JOURNAL MODE:
+ * With App::journalSave (JournalSave=1 in the ini), a scheduled save appends only what changed since
+ * the last one to "<config>.journal" (see ConfigJournal), and Load replays that on top of the ini. For
+ * thousands of profiles this turns a slider edit or a reorder into a record of a few hundred bytes
+ * instead of a full rewrite. Once the journal outgrows half the ini, the next scheduled save is a full
+ * one, which folds the journal back in and deletes it; so is every Save, including the one on exit.
+ *
+ * BINARY SNAPSHOT:
+ * After each full write the saver parses the bytes it wrote and stores the result as
+ * "<config>.snapshot" (see ConfigSnapshot). Load memory-maps that instead of parsing the ini, but only
+ * when it was built from exactly the ini on disk (same size, modification time and content hash); on
+ * any mismatch it parses the text as before and has the saver write a fresh snapshot. A journal is
+ * replayed on top either way.
+ *
+ * HOT RELOAD:
+ * A watcher thread waits on change notifications for the config's folder. Once the folder has been
+ * quiet for RELOAD_SETTLE_MS and the ini's size or modification time differs from what the app last
+ * wrote or read, it posts ConfigIDs::WM_CONFIG_CHANGED to the window, which calls Reload. The app's
+ * own saves record the file they wrote before the watcher can look at it, so they never trigger a
+ * reload. An external change replaces any save still waiting on the saver thread.
+ */
+
 #pragma once
 
+#include <windows.h>
+#include <cstdint>
 #include <string>
 
 namespace ConfigManager
 {
+    // Quiet period before a scheduled save is written; each newer ScheduleSave restarts it.
+    constexpr int SAVE_DELAY_MS = 500;
+
+    // How long the config's folder must be quiet before the watcher checks the config file.
+    constexpr int RELOAD_SETTLE_MS = 200;
+
+    /**
+     * @brief Counters for Save and ScheduleSave.
+     */
+    struct SaveStats
+    {
+        uint64_t written = 0;   // Saves that wrote the file.
+        uint64_t skipped = 0;   // Saves skipped because the file already held exactly those bytes.
+        uint64_t coalesced = 0; // Scheduled saves replaced by a newer one before they were written.
+        uint64_t journaled = 0; // Scheduled saves appended to the journal (journal mode).
+    };
+
+    /**
+     * @brief What Reload changed, so the caller only re-applies what it has to.
+     */
+    struct ReloadResult
+    {
+        bool reloaded = false;       // The file held changes from outside the app, and was loaded.
+        bool modeChanged = false;    // Simple/advanced mode switched.
+        bool displayChanged = false; // The selected display changed; previousDisplayIndex was selected before.
+        bool activeChanged = false;  // What gamma applies changed: the mode, the display, or the selected/simple profile.
+        int previousDisplayIndex = 0;
+    };
+
     /**
      * @brief Strip characters that would corrupt the ini round-trip from a profile name.
      *
@@ -23,6 +85,7 @@ namespace ConfigManager
      * @brief Load configuration from ini file.
      * 
      * Loads profiles, hotkeys, and settings, primarily into AppGlobals and AppState.
+     * Reads them from the binary snapshot when it matches the ini, otherwise parses the ini.
      * 
      * @return true if the configuration was loaded successfully.
      */
@@ -31,10 +94,61 @@ namespace ConfigManager
     /**
      * @brief Save configuration to ini file.
      * 
-     * Saves all profiles, hotkeys, and settings.
-     * Writes to a temp file first, then replaces existing config with the new config.
+     * Saves all profiles, hotkeys, and settings, on the calling thread. Any save still waiting on the
+     * saver thread is dropped, as this one is newer; a write already in progress finishes first.
+     * Always rewrites the ini in full, folding in and deleting any journal.
+     * Writes to a temp file first, then replaces existing config with the new config; with
+     * App::durableSave the temp file is flushed to disk before the rename.
+     * Skips the write when the serialized config matches what was last written (or loaded) and the
+     * file has not been modified since.
      * 
      * @return true if the configuration was saved successfully.
      */
     bool Save();
+
+    /**
+     * @brief Mark the configuration changed and save it in the background shortly.
+     *
+     * Snapshots the current settings now (later changes are picked up by a later call), then leaves
+     * the write to the saver thread after SAVE_DELAY_MS without a newer call. Saves synchronously
+     * instead if the saver is not running. UI thread only.
+     */
+    void ScheduleSave();
+
+    /**
+     * @brief Start the background saver thread. Call once the configuration has been loaded.
+     */
+    void StartSaver();
+
+    /**
+     * @brief Write any scheduled save at once, then stop and join the saver thread.
+     */
+    void StopSaver();
+
+    /**
+     * @brief Load the config again after it changed on disk, in response to WM_CONFIG_CHANGED.
+     *
+     * Does nothing if the file cannot be read or holds the bytes last written or read. Otherwise
+     * drops any save still scheduled and loads the file as Load does. Applying the result (hotkeys,
+     * gamma, the working profile) is up to the caller. UI thread only.
+     *
+     * @return which parts of the running state changed.
+     */
+    ReloadResult Reload();
+
+    /**
+     * @brief Start watching the config file for changes made outside the app.
+     * @param window Receives ConfigIDs::WM_CONFIG_CHANGED.
+     */
+    void StartWatcher(const HWND window);
+
+    /**
+     * @brief Stop and join the watcher thread.
+     */
+    void StopWatcher();
+
+    /**
+     * @brief Saves written and skipped since launch.
+     */
+    SaveStats GetSaveStats();
 }
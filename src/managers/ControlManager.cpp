@@ -0,0 +1,478 @@
+// Copyright (c) 2025 Max Godman
+
+#include "framework.h"
+#include "ControlManager.h"
+#include "ControlProtocol.h"
+#include "AppGlobals.h"
+#include "UIGlobals.h"
+#include "UI_Shared.h"
+#include "CommandLineManager.h"
+#include "ConfigManager.h"
+#include "GammaManager.h"
+#include "HotkeyManager.h"
+#include "ProfileManager.h"
+#include "RampCache.h"
+#include "RedrawPolicy.h"
+#include "StartupTrace.h"
+#include "StringUtils.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace ControlManager
+{
+    using ControlProtocol::Op;
+
+    // Pipe buffer size each way, and the most a client thread reads at once.
+    static constexpr DWORD BUFFER_SIZE = 4096;
+
+    struct Client
+    {
+        std::unique_ptr<Session> session;
+        std::thread thread;
+        std::atomic<bool> finished = false; // Set by the thread as it returns; it is joined next accept.
+    };
+
+    struct Server
+    {
+        std::thread acceptor;
+        HANDLE stop = NULL;       // Manual-reset event, set by StopServer.
+        HANDLE clientLeft = NULL; // Auto-reset event, set as a client thread returns.
+        std::mutex mutex;         // Guards clients.
+        std::vector<std::unique_ptr<Client>> clients;
+    };
+
+    static Server s_server;
+
+    static std::wstring GetPipeName()
+    {
+        return L"\\\\.\\pipe\\" + CommandLineManager::GetInstanceName() + L"_control";
+    }
+
+    // Wait for an overlapped operation on the pipe, or for StopServer. Cancels it on stop.
+    // @return true if the operation completed successfully.
+    static bool WaitForPipe(const HANDLE pipe, OVERLAPPED& overlapped, DWORD& transferred)
+    {
+        const HANDLE handles[2] = { s_server.stop, overlapped.hEvent };
+        if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+            CancelIo(pipe); // The OVERLAPPED must outlive the operation: wait for the cancel below.
+        return GetOverlappedResult(pipe, &overlapped, &transferred, TRUE) != FALSE;
+    }
+
+    static bool ReadPipe(const HANDLE pipe, OVERLAPPED& overlapped, char* buffer, DWORD& read)
+    {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadFile(pipe, buffer, BUFFER_SIZE, NULL, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+            return false;
+        return WaitForPipe(pipe, overlapped, read);
+    }
+
+    static bool WritePipe(const HANDLE pipe, OVERLAPPED& overlapped, const std::string& data)
+    {
+        DWORD written = 0;
+        ResetEvent(overlapped.hEvent);
+        if (!WriteFile(pipe, data.data(), (DWORD)data.size(), NULL, &overlapped) && GetLastError() != ERROR_IO_PENDING)
+            return false;
+        return WaitForPipe(pipe, overlapped, written) && written == data.size();
+    }
+
+    // Have the UI thread carry out every line, a batch at a time: each sync ends one, and is
+    // answered here once the writes before it are done. The replies pile up in session.replies.
+    // @return false if stopped.
+    static bool RunBatches(Session& session, const HWND window)
+    {
+        while (!session.lines.empty())
+        {
+            if (!PostMessage(window, ControlIDs::WM_CONTROL_BATCH, 0, (LPARAM)&session))
+                return false;
+
+            // Stopping while the batch is posted: the window is being destroyed and never runs it.
+            const HANDLE handles[2] = { s_server.stop, session.done };
+            if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+                return false;
+
+            if (session.syncing)
+            {
+                session.syncing = false;
+                const HANDLE syncHandles[2] = { s_server.stop, session.written };
+                if (WaitForMultipleObjects(2, syncHandles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+                    return false;
+                session.replies += App::state.gammaRampFailed ? "err apply failed\n" : "ok\n";
+            }
+        }
+        return true;
+    }
+
+    static void RunClient(Client* client, const HWND window)
+    {
+        Session& session = *client->session;
+
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+        std::string pending; // An incomplete last line, completed by a later read.
+        char buffer[BUFFER_SIZE];
+        DWORD read = 0;
+        while (overlapped.hEvent && ReadPipe(session.pipe, overlapped, buffer, read))
+        {
+            // A line too long to be a request is not worth waiting out: drop the client.
+            pending.append(buffer, read);
+            if (!ControlProtocol::TakeLines(pending, session.lines))
+                break;
+            if (session.lines.empty())
+                continue;
+
+            if (!RunBatches(session, window))
+                break;
+
+            const bool written = WritePipe(session.pipe, overlapped, session.replies);
+            session.replies.clear();
+            if (!written)
+                break;
+        }
+
+        if (overlapped.hEvent)
+            CloseHandle(overlapped.hEvent);
+        CloseHandle(session.pipe);
+        session.pipe = INVALID_HANDLE_VALUE;
+
+        client->finished = true;
+        SetEvent(s_server.clientLeft);
+    }
+
+    // Join the threads of clients that left. Acceptor thread (or StopServer, once it has stopped).
+    // @return How many clients are still connected.
+    static size_t ReapClients()
+    {
+        std::lock_guard<std::mutex> lock(s_server.mutex);
+        for (size_t index = 0; index < s_server.clients.size();)
+        {
+            Client& client = *s_server.clients[index];
+            if (client.finished)
+            {
+                client.thread.join();
+                CloseHandle(client.session->done);
+                CloseHandle(client.session->written);
+                s_server.clients.erase(s_server.clients.begin() + index);
+            }
+            else
+            {
+                ++index;
+            }
+        }
+        return s_server.clients.size();
+    }
+
+    static void RunAcceptor(const HWND window)
+    {
+        const std::wstring pipeName = GetPipeName();
+
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (!overlapped.hEvent)
+            return;
+
+        while (WaitForSingleObject(s_server.stop, 0) != WAIT_OBJECT_0)
+        {
+            // Full: wait for someone to leave. Meanwhile connecting clients see the pipe busy.
+            if (ReapClients() >= MAX_CLIENTS)
+            {
+                const HANDLE handles[2] = { s_server.stop, s_server.clientLeft };
+                WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+                continue;
+            }
+
+            const HANDLE pipe = CreateNamedPipeW(pipeName.c_str(), PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+                PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                MAX_CLIENTS, BUFFER_SIZE, BUFFER_SIZE, 0, NULL);
+            if (pipe == INVALID_HANDLE_VALUE)
+                break;
+
+            DWORD transferred = 0;
+            ResetEvent(overlapped.hEvent);
+            bool connected = ConnectNamedPipe(pipe, &overlapped) != FALSE;
+            if (!connected)
+            {
+                const DWORD error = GetLastError();
+                connected = error == ERROR_PIPE_CONNECTED ||
+                    (error == ERROR_IO_PENDING && WaitForPipe(pipe, overlapped, transferred));
+            }
+
+            const HANDLE done = connected ? CreateEventW(NULL, FALSE, FALSE, NULL) : NULL;
+            const HANDLE written = done ? CreateEventW(NULL, FALSE, FALSE, NULL) : NULL;
+            if (!written)
+            {
+                if (done)
+                    CloseHandle(done);
+                CloseHandle(pipe);
+                continue;
+            }
+
+            std::unique_ptr<Client> client = std::make_unique<Client>();
+            client->session = std::make_unique<Session>();
+            client->session->pipe = pipe;
+            client->session->done = done;
+            client->session->written = written;
+            client->thread = std::thread(RunClient, client.get(), window);
+
+            std::lock_guard<std::mutex> lock(s_server.mutex);
+            s_server.clients.push_back(std::move(client));
+        }
+
+        CloseHandle(overlapped.hEvent);
+    }
+
+    void StartServer(const HWND window)
+    {
+        if (s_server.acceptor.joinable())
+            return;
+
+        s_server.stop = CreateEventW(NULL, TRUE, FALSE, NULL);
+        s_server.clientLeft = CreateEventW(NULL, FALSE, FALSE, NULL);
+        if (!s_server.stop || !s_server.clientLeft)
+        {
+            if (s_server.stop)
+                CloseHandle(s_server.stop);
+            if (s_server.clientLeft)
+                CloseHandle(s_server.clientLeft);
+            s_server.stop = s_server.clientLeft = NULL;
+            return; // No control pipe; everything else works without it.
+        }
+
+        s_server.acceptor = std::thread(RunAcceptor, window);
+    }
+
+    void StopServer()
+    {
+        if (!s_server.acceptor.joinable())
+            return;
+
+        // Every client thread waits on stop too, so all of them return.
+        SetEvent(s_server.stop);
+        s_server.acceptor.join();
+        {
+            std::lock_guard<std::mutex> lock(s_server.mutex);
+            for (const std::unique_ptr<Client>& client : s_server.clients)
+                client->thread.join();
+        }
+        ReapClients();
+
+        CloseHandle(s_server.stop);
+        CloseHandle(s_server.clientLeft);
+        s_server.stop = s_server.clientLeft = NULL;
+    }
+
+    // The profile the current mode applies, which "set" changes (as the step hotkeys do).
+    static Profile& ActiveProfile()
+    {
+        return App::state.IsAdvancedModeEnabled() ? App::workingProfile : App::simpleProfile;
+    }
+
+    static int FindProfileById(const int id)
+    {
+        if (id <= 0 || id > HotkeyIDs::MAX - HotkeyIDs::PROFILE_BASE)
+            return -1;
+        return HotkeyManager::ProfileIndex(HotkeyIDs::PROFILE_BASE + id); // Profile IDs double as hotkey IDs.
+    }
+
+    static std::string FormatState()
+    {
+        const Profile& profile = ActiveProfile();
+        const bool hasProfile = App::state.IsAdvancedModeEnabled() && App::HasSelectedProfile();
+
+        char fields[160];
+        snprintf(fields, sizeof(fields), "ok on=%d mode=%s display=%d b=%d c=%.2f g=%.2f id=%d failed=%d name=",
+            App::state.IsGammaEnabled() ? 1 : 0, App::state.IsAdvancedModeEnabled() ? "advanced" : "simple",
+            App::selectedDisplayIndex, profile.brightness, profile.contrast, profile.gamma,
+            hasProfile ? App::profiles[App::selectedProfileIndex].id : 0, App::state.gammaRampFailed ? 1 : 0);
+
+        std::string reply = fields;
+        if (hasProfile)
+            reply += StringUtils::WideToUTF8(profile.name);
+        return reply;
+    }
+
+    static std::string FormatList()
+    {
+        std::string reply = "ok ";
+        for (size_t index = 0; index < App::profiles.size(); ++index)
+        {
+            if (index > 0)
+                reply += ';';
+            reply += std::to_string(App::profiles[index].id);
+            reply += '=';
+            reply += StringUtils::WideToUTF8(App::profiles[index].name);
+        }
+        return reply;
+    }
+
+    static std::string FormatStats()
+    {
+        const RedrawPolicy::Stats redraw = RedrawPolicy::GetStats(GetTickCount64());
+        const GammaManager::ApplyStats apply = GammaManager::GetApplyStats();
+        const RampCache::Stats cache = RampCache::GetStats();
+
+        char reply[512];
+        snprintf(reply, sizeof(reply), "ok frames=%llu idle_frames=%llu idle_s=%.1f idle_fpm=%.1f"
+            " driver_calls=%llu skipped_calls=%llu coalesced_calls=%llu clamped=%llu"
+            " transitions=%llu cancelled=%llu transition_writes=%llu last_transition_writes=%d"
+            " cache_hits=%llu cache_misses=%llu cache_evictions=%llu cache_size=%zu",
+            (unsigned long long)redraw.frames, (unsigned long long)redraw.idleFrames, redraw.idleMs / 1000.0,
+            redraw.idleFramesPerMinute, (unsigned long long)apply.driverCalls, (unsigned long long)apply.skippedCalls,
+            (unsigned long long)apply.coalescedCalls, (unsigned long long)apply.clampedApplies,
+            (unsigned long long)apply.transitions, (unsigned long long)apply.transitionsCancelled,
+            (unsigned long long)apply.transitionWrites, apply.lastTransitionWrites,
+            (unsigned long long)cache.hits, (unsigned long long)cache.misses, (unsigned long long)cache.evictions,
+            cache.size);
+        return reply;
+    }
+
+    // What a batch leaves to do once all its requests have run.
+    struct BatchEffects
+    {
+        bool changed = false;     // The UI needs syncing.
+        bool simpleSet = false;   // A set changed the simple profile, which needs saving.
+        bool sync = false;        // A sync ended the batch; the client thread replies to it.
+    };
+
+    // Carry out one request, noting in effects what the batch has to do afterwards.
+    static std::string Execute(Session& session, const std::string& line, BatchEffects& effects)
+    {
+        const ControlProtocol::Request request = ControlProtocol::ParseRequest(line);
+        switch (request.op)
+        {
+        case Op::Invalid:
+            return std::string("err ") + request.error;
+
+        case Op::Apply:
+        case Op::ApplyId:
+        {
+            const int index = (request.op == Op::Apply)
+                ? ProfileManager::FindByName(StringUtils::UTF8ToWide(std::string(request.name)))
+                : FindProfileById(request.value);
+            if (index < 0)
+                return "err no such profile";
+
+            // As a profile hotkey does, with this connection's fade.
+            App::state.SetGammaEnabled(true);
+            ProfileManager::ApplyByIndex(index, session.transitionMs);
+            SyncUIWithCurrentProfile();
+            effects.changed = true;
+            return "ok";
+        }
+
+        case Op::Set:
+        {
+            // Negated comparisons, so NaN is out of range too.
+            if (request.hasBrightness && (request.brightness < ProfileRange::BRIGHTNESS_MIN || request.brightness > ProfileRange::BRIGHTNESS_MAX))
+                return "err brightness out of range";
+            if (request.hasContrast && !(request.contrast >= ProfileRange::CONTRAST_MIN && request.contrast <= ProfileRange::CONTRAST_MAX))
+                return "err contrast out of range";
+            if (request.hasGamma && !(request.gamma >= ProfileRange::GAMMA_MIN && request.gamma <= ProfileRange::GAMMA_MAX))
+                return "err gamma out of range";
+
+            Profile& profile = ActiveProfile();
+            if (request.hasBrightness)
+                profile.brightness = request.brightness;
+            if (request.hasContrast)
+                profile.contrast = request.contrast;
+            if (request.hasGamma)
+                profile.gamma = request.gamma;
+
+            App::state.SetGammaEnabled(true);
+            GammaManager::ApplyProfile(profile, App::selectedDisplayIndex, session.transitionMs);
+            // Only the simple profile is saved; advanced mode's working profile has its own Save button.
+            if (!App::state.IsAdvancedModeEnabled())
+                effects.simpleSet = true;
+            effects.changed = true;
+            return "ok";
+        }
+
+        case Op::Transition:
+            if (request.value < TransitionRange::MS_MIN || request.value > TransitionRange::MS_MAX)
+                return "err transition out of range";
+            session.transitionMs = request.value;
+            return "ok";
+
+        case Op::On:
+        case Op::Off:
+        case Op::Toggle:
+        {
+            // App::ToggleGamma, but the UI is synced once for the whole batch.
+            const bool enabled = (request.op == Op::Toggle) ? !App::state.IsGammaEnabled() : (request.op == Op::On);
+            App::state.SetGammaEnabled(enabled);
+            App::SyncGammaToState();
+            effects.changed = true;
+            return "ok";
+        }
+
+        case Op::Get:
+            return FormatState();
+
+        case Op::List:
+            return FormatList();
+
+        case Op::Sync:
+            effects.sync = true;
+            return std::string(); // See OnBatch.
+
+        case Op::Trace:
+            return "ok " + StartupTrace::Format();
+
+        case Op::Stats:
+            return FormatStats();
+        }
+        return "err unknown request";
+    }
+
+    // Have session->written set once the ramps posted so far are written. The worker that finishes
+    // them sets it, through a handle of its own: the session may be gone by then.
+    static void StartSync(Session* session)
+    {
+        HANDLE written = NULL;
+        if (DuplicateHandle(GetCurrentProcess(), session->written, GetCurrentProcess(), &written, 0, FALSE,
+                            DUPLICATE_SAME_ACCESS))
+        {
+            GammaManager::NotifyWhenFlushed([written]()
+            {
+                SetEvent(written);
+                CloseHandle(written);
+            });
+            return;
+        }
+
+        // Out of handles: wait here after all, as the reply must not come early.
+        GammaManager::Flush();
+        SetEvent(session->written);
+    }
+
+    void OnBatch(Session* session)
+    {
+        BatchEffects effects;
+        size_t count = 0;
+        while (count < session->lines.size())
+        {
+            const std::string reply = Execute(*session, session->lines[count++], effects);
+            if (effects.sync)
+                break;
+            session->replies += reply;
+            session->replies += '\n';
+        }
+
+        // A sync ends the batch: the lines after it wait for its reply, and come back as the next.
+        session->lines.erase(session->lines.begin(), session->lines.begin() + count);
+
+        // One save for the batch however many sets it held, as for a hold of a step hotkey.
+        if (effects.simpleSet)
+            ConfigManager::ScheduleSave();
+        if (effects.changed)
+            UI::SyncUIToState();
+        if (effects.sync)
+        {
+            StartSync(session);
+            session->syncing = true;
+        }
+        SetEvent(session->done);
+    }
+}
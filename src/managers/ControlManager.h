@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Max Godman
+
+// Local control pipe: a persistent, pipelined line protocol for driving gamma from automation.
+
+/**
+ * The command-line verbs (see CommandLineManager) cost a process launch per change, far too slow for
+ * a stream deck or a launcher that switches many times a second. The control pipe stays open instead:
+ * a client connects once to \\.\pipe\<instance name>_control (see CommandLineManager::GetInstanceName)
+ * and sends requests in the line protocol described in ControlProtocol.h.
+ *
+ * THREADS:
+ * One thread accepts connections, and each client gets a thread of its own (up to MAX_CLIENTS at
+ * once), so a slow client never holds up another. A client thread reads whatever has arrived, posts
+ * every complete line to the window as one batch (ControlIDs::WM_CONTROL_BATCH), waits for the UI
+ * thread to carry them out, and writes all the replies at once. Requests sent meanwhile pile up in
+ * the pipe and make the next batch; the client is never read from faster than the UI thread keeps up.
+ *
+ * APPLY PATH:
+ * The UI thread carries out requests through the same calls as the hotkeys (ProfileManager,
+ * App::SyncGammaToState, GammaManager::ApplyProfile), so the apply workers coalesce them the same
+ * way, latest wins, and the UI is synced once per batch. Only "sync" waits for the workers, and not
+ * on the UI thread, which a fade would hold for seconds: the batch ends at the sync, the client
+ * thread waits until the workers report the ramps posted so far written, replies, and posts the
+ * lines after the sync as the next batch.
+ *
+ * The pipe refuses remote clients and, like the command pipe, takes requests from any process
+ * of the same user.
+ */
+
+#pragma once
+
+#include <windows.h>
+#include <string>
+#include <vector>
+
+namespace ControlManager
+{
+    // Clients connected at once; further connections wait until one leaves.
+    constexpr int MAX_CLIENTS = 8;
+
+    /**
+     * @brief One client connection, shared by its thread and, during a batch, the UI thread.
+     *
+     * The client thread fills lines and posts the batch; the UI thread removes the lines it carried
+     * out, fills replies and sets done. Neither touches them while the other has them.
+     */
+    struct Session
+    {
+        HANDLE pipe = INVALID_HANDLE_VALUE;
+        HANDLE done = NULL;               // Auto-reset event: the UI thread finished the batch.
+        HANDLE written = NULL;            // Auto-reset event: the writes a sync waits for are done.
+        std::vector<std::string> lines;   // Requests of the current batch.
+        std::string replies;              // Their replies, one line each.
+        bool syncing = false;             // The batch ended at a sync; its reply waits for written.
+        int transitionMs = 0;             // Fade length set by "transition"; UI thread only.
+    };
+
+    /**
+     * @brief Start accepting clients on the control pipe.
+     */
+    void StartServer(const HWND window);
+
+    /**
+     * @brief Disconnect every client and stop accepting new ones.
+     * @note Call from WM_DESTROY: a batch a client posted before it was stopped then never reaches
+     *       OnBatch, as the window is gone by the time the message loop runs again.
+     */
+    void StopServer();
+
+    /**
+     * @brief Carry out a batch (ControlIDs::WM_CONTROL_BATCH), up to and including its first sync,
+     *        and hand the replies back. UI thread.
+     */
+    void OnBatch(Session* session);
+}
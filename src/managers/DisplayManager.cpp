@@ -3,35 +3,51 @@
 #include "framework.h"
 #include "DisplayManager.h"
 #include "AppGlobals.h"
+#include "GammaManager.h"
+#include "Win32GammaBackend.h"
 
 namespace DisplayManager
 {
+    static std::unique_ptr<GammaBackend> s_backend = std::make_unique<Win32GammaBackend>();
+
     void EnumerateDisplays()
     {
-        App::displays.clear();
-        
-        DISPLAY_DEVICE ddAdapter = {};
-        ddAdapter.cb = sizeof(ddAdapter);
-        DISPLAY_DEVICE ddDisplay = {};
-        ddDisplay.cb = sizeof(ddDisplay);
+        // The apply workers are tied to the current indices and handles; finish their writes first.
+        GammaManager::StopWorkers();
+        SetDisplays(s_backend->Enumerate());
+    }
+
+    void SetDisplays(const std::vector<GammaDisplayInfo>& displays)
+    {
+        GammaManager::StopWorkers();
 
-        for (DWORD adapterIndex = 0; EnumDisplayDevices(NULL, adapterIndex, &ddAdapter, 0); ++adapterIndex)
+        App::displays.clear();
+        for (const GammaDisplayInfo& info : displays)
         {
-            if (!(ddAdapter.StateFlags & DISPLAY_DEVICE_ACTIVE))
-                continue;
-
-            for (DWORD displayIndex = 0; EnumDisplayDevices(ddAdapter.DeviceName, displayIndex, &ddDisplay, 0); ++displayIndex)
-            {
-                if (!(ddDisplay.StateFlags & DISPLAY_DEVICE_ACTIVE))
-                    continue;
-
-                DisplayEntry entry;
-                entry.deviceName = ddAdapter.DeviceName;
-                // Display first, then GPU, separated by |
-                entry.friendlyName = std::wstring(ddDisplay.DeviceString) + L" | " +
-                                    std::wstring(ddAdapter.DeviceString);
-                App::displays.push_back(entry);
-            }
+            DisplayEntry entry;
+            entry.deviceName = info.deviceName;
+            entry.friendlyName = info.friendlyName;
+            App::displays.push_back(entry);
         }
+
+        GammaManager::StartWorkers();
+    }
+
+    GammaBackend& GetBackend()
+    {
+        return *s_backend;
+    }
+
+    void SetBackend(std::unique_ptr<GammaBackend> backend)
+    {
+        GammaManager::StopWorkers();
+
+        s_backend->Release();
+        s_backend = backend ? std::move(backend) : std::make_unique<Win32GammaBackend>();
+    }
+
+    void ReleaseDisplays()
+    {
+        s_backend->Release();
     }
 }
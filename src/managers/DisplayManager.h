@@ -4,10 +4,40 @@
 
 #pragma once
 
+#include "GammaBackend.h"
+#include <memory>
+#include <vector>
+
 namespace DisplayManager
 {
     /**
-     * @brief Enumerate all displays and populate App::displays.
+     * @brief Enumerate all displays through the active backend and populate App::displays.
+     * @note Stops the apply workers first and starts a fresh set afterwards, since indices may change.
      */
     void EnumerateDisplays();
+
+    /**
+     * @brief Populate App::displays from an enumeration already made, and start the apply workers.
+     * @param[in] displays What GetBackend().Enumerate() returned, e.g. on another thread at launch.
+     * @note UI thread. Stops the apply workers first and starts a fresh set afterwards, as EnumerateDisplays.
+     */
+    void SetDisplays(const std::vector<GammaDisplayInfo>& displays);
+
+    /**
+     * @brief The backend every display read and write goes through (Win32GammaBackend by default).
+     * @note Safe to use from the apply workers: it is only replaced by SetBackend, which stops them first.
+     */
+    GammaBackend& GetBackend();
+
+    /**
+     * @brief Replace the active backend, e.g. with a FakeGammaBackend for headless runs.
+     * @param[in] backend The new backend; nullptr restores a Win32GammaBackend.
+     * @note Stops the apply workers and releases the old backend. Call EnumerateDisplays afterwards.
+     */
+    void SetBackend(std::unique_ptr<GammaBackend> backend);
+
+    /**
+     * @brief Release the backend's per-display handles. Called on exit, after the apply workers stop.
+     */
+    void ReleaseDisplays();
 }
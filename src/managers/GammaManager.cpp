@@ -3,125 +3,289 @@
 #include "framework.h"
 #include "GammaManager.h"
 #include "AppGlobals.h"
-#include <algorithm>
-#include <math.h>
-
-// Windows.h defines these as macros, conflicts with std::max/min.
-#undef max
-#undef min
+#include "ApplyOutcome.h"
+#include "RampEngine.h"
+#include "RampCache.h"
+#include "RampPreflight.h"
+#include "GammaWorker.h"
+#include "DisplayManager.h"
+#include "RedrawPolicy.h"
+#include <atomic>
+#include <mutex>
 
 namespace GammaManager
 {
-    void BuildRamp(const Profile& profile)
-    {
-        // We should probably clamp to safer values here, but SetDeviceGammaRamp() has a bunch of safety
-        // built into it to prevent the screen from becoming unreadable, so we will rely on that instead.
-        const float gamma = profile.gamma;
-        const float contrast = profile.contrast;
-        const int brightness = profile.brightness;
+    // WORD and uint16_t are the same type on Windows, so the engine writes straight into the
+    // WORD[3][256] ramps that GammaBackend reads and writes.
+    static_assert(GammaConstants::RAMP_SIZE == RampEngine::RAMP_SIZE, "Ramp size must match RampEngine.");
+    static_assert(GammaConstants::RAMP_MAX == RampEngine::RAMP_MAX, "Ramp range must match RampEngine.");
+    static_assert(sizeof(WORD) == sizeof(uint16_t), "WORD must be 16-bit.");
 
-        // Remap brightness from (-50 to +50) to (-0.25 to +0.25).
-        const float brightnessOffset = brightness / 200.0f;
+    static RampEngine::Params MakeParams(const Profile& profile)
+    {
+        RampEngine::Params params;
+        params.brightness = profile.brightness;
+        params.contrast = profile.contrast;
+        params.gamma = profile.gamma;
+        return params;
+    }
 
+    void BuildRamp(const Profile& profile)
+    {
+        // No clamping here: this is the curve the user asked for, and the preview shows it as such.
+        // SetDeviceGammaRamp() refuses ramps extreme enough to make the screen unreadable; SetRamp
+        // predicts that with RampPreflight and clamps the applied ramp before the driver sees it.
+        //
         // Compute the normalized (0.0 to 1.0) curve for all 256 possible input values and cache it.
         // This is the construction step, kept separate from application so callers can refresh the
         // preview from pending settings without touching the display (see ApplyProfile for the apply
-        // step and BuildGammaRamp for the applyable 16-bit conversion).
-        for (int i = 0; i < GammaConstants::RAMP_SIZE; ++i)
-        {
-            // Start with normalized input (0.0 to 1.0).
-            float v = i / 255.0f;
+        // step and BuildGammaRamp for the applyable 16-bit conversion). The math itself lives in
+        // RampEngine; RampCache skips it entirely for parameters built recently.
+        RampCache::GetCurve(MakeParams(profile), App::state.lastRamp);
+    }
 
-            // 1. Apply brightness (linear offset).
-            v += brightnessOffset;
+    void BuildGammaRamp(const Profile& profile, WORD ramp[3][256])
+    {
+        // Fetch the normalized curve (also updates the cached preview) and its Windows 16-bit gamma
+        // ramp in one lookup, without applying it to any display. Switching back to a recent profile
+        // is a table copy.
+        RampCache::GetRamp(MakeParams(profile), App::state.lastRamp, ramp);
+    }
+    
+    // What each display was last successfully given, indexed like App::displays. Lets an apply
+    // that would push the exact ramp a display already has skip the DC and the driver call: a
+    // resync after WM_DISPLAYCHANGE, a double-click reset to the current value, or re-selecting
+    // the active profile. The hash makes the common mismatch a single compare; a hash match is
+    // confirmed against the stored contents so a collision can never skip a real change.
+    struct AppliedRamp
+    {
+        bool valid = false;
+        uint64_t hash = 0;
+        WORD ramp[3][GammaConstants::RAMP_SIZE] = {};
+    };
 
-            // 2. Apply contrast (scale around midpoint 0.5).
-            // Formula: output = (input - 0.5) * contrast + 0.5
-            // This keeps midpoint unchanged while expanding/compressing range.
-            v = (v - 0.5f) * contrast + 0.5f;
+    // Per-display state used from the worker threads. Sized by StartWorkers while no worker runs,
+    // and each worker only touches its own display's entries, so none of it needs a lock.
+    static std::vector<AppliedRamp> s_appliedRamps;
 
-            // 3. Clamp to valid range [0, 1].
-            v = std::max(0.0f, std::min(1.0f, v));
+    static int s_displayCount = 0; // App::displays.size() when the workers started; UI thread only.
 
-            // 4. Apply gamma curve (power function).
-            v = powf(v, 1.0f / gamma);
+    // What each display accepts, read from the backend when the workers started; UI thread only.
+    static std::vector<RampPreflight::Limits> s_rampLimits;
 
-            // Cache for external use, such as the gamma curve preview.
-            App::state.lastRamp[i] = v;
-        }
+    // Outcome of the last profile apply on each display, and which displays the latest ApplyProfile
+    // targeted. Updated under this lock by whichever thread changes an input, so concurrent workers
+    // cannot publish a stale answer.
+    static std::mutex s_resultMutex;
+    static ApplyOutcome s_outcome;
+
+    static std::atomic<uint64_t> s_driverCalls = 0;
+    static std::atomic<uint64_t> s_skippedCalls = 0;
+    static std::atomic<uint64_t> s_clampedApplies = 0;
+
+    // Caller holds s_resultMutex. A change usually comes from a worker, after the apply's own redraw,
+    // so the window is told to draw the warning (or clear it) rather than left idle showing the old one.
+    static void PublishResult(const bool changed)
+    {
+        App::state.gammaRampFailed = s_outcome.Failed();
+        if (changed && App::mainWindow)
+            PostMessage(App::mainWindow, GammaIDs::WM_APPLY_RESULT, 0, 0);
     }
 
-    void BuildGammaRamp(const Profile& profile, WORD ramp[3][256])
+    // Push a ramp to one display, unless that display already has it.
+    // @return true if the display now has the ramp (applied, or already applied).
+    static bool SetDisplayRamp(const int displayIndex, const WORD ramp[3][GammaConstants::RAMP_SIZE])
     {
-        // Construct the normalized curve (also updates the cached preview), then convert it to the
-        // Windows 16-bit gamma ramp format without applying it to any display.
-        BuildRamp(profile);
+        AppliedRamp& applied = s_appliedRamps[displayIndex];
+        const uint64_t hash = RampEngine::HashRamp(ramp);
+        if (applied.valid && applied.hash == hash && memcmp(applied.ramp, ramp, sizeof(applied.ramp)) == 0)
+        {
+            ++s_skippedCalls;
+            return true;
+        }
+
+        ++s_driverCalls;
+        const bool success = DisplayManager::GetBackend().WriteRamp(displayIndex, ramp);
 
-        for (int index = 0; index < GammaConstants::RAMP_SIZE; ++index)
+        // Only remember a ramp the driver accepted; after a failure the display's state is unknown,
+        // so the next apply must reach the driver again.
+        applied.valid = success;
+        if (applied.valid)
         {
-            // Convert to Windows gamma ramp format (16-bit integer, 0-65535).
-            const WORD val = (WORD)(App::state.lastRamp[index] * GammaConstants::RAMP_MAX + 0.5f);
-
-            // Apply same value to all three color channels.
-            // Could be extended to support per-channel adjustments for color tinting.
-            ramp[0][index] = val;  // Red.
-            ramp[1][index] = val;  // Green.
-            ramp[2][index] = val;  // Blue.
+            applied.hash = hash;
+            memcpy(applied.ramp, ramp, sizeof(applied.ramp));
         }
+        return applied.valid;
     }
-    
-    void ApplyProfile(const Profile& profile, const int displayIndex)
+
+    // GammaWorker::WriteFunc: runs on the display's worker thread (or inline, see SetRamp).
+    static bool WriteRamp(const int displayIndex, const WORD ramp[3][GammaConstants::RAMP_SIZE], const bool report)
     {
-        if (App::displays.empty()) return;
+        const bool success = SetDisplayRamp(displayIndex, ramp);
+        if (!report)
+            return success; // Resets never drove the failure warning.
+
+        std::lock_guard<std::mutex> lock(s_resultMutex);
+        PublishResult(s_outcome.Report(displayIndex, success));
+        return success;
+    }
+
+    // GammaWorker::ReadFunc: the ramp a display shows as its worker starts, which the first fade on
+    // it starts from (the one left by an earlier run, another app, or before a display change).
+    static bool ReadRamp(const int displayIndex, WORD ramp[3][GammaConstants::RAMP_SIZE])
+    {
+        return DisplayManager::GetBackend().ReadRamp(displayIndex, ramp);
+    }
 
-        if (displayIndex == -1)
+    // Hand a ramp to one display's worker, or to every display's for -1, so the writes run in
+    // parallel off the UI thread. Falls back to writing inline (and without a transition) when no
+    // worker serves the display.
+    //
+    // Each display first gets the ramp checked against what it accepts. One the driver would refuse
+    // is clamped to the nearest ramp it accepts instead of being sent as is: a refused ramp would
+    // cost a driver round-trip per slider frame and leave the display on its old ramp anyway.
+    static void SetRamp(const int displayIndex, const WORD ramp[3][GammaConstants::RAMP_SIZE], const bool report,
+                        const int transitionMs)
+    {
+        const int first = (displayIndex == -1) ? 0 : displayIndex;
+        const int last = (displayIndex == -1) ? s_displayCount - 1 : displayIndex;
+        bool clamped = false;
+
+        if (report)
         {
-            for (int index = 0; index < (int)App::displays.size(); ++index)
-                ApplyProfile(profile, index);
-            return;
+            std::lock_guard<std::mutex> lock(s_resultMutex);
+            PublishResult(s_outcome.SetTargets(first, last));
         }
 
-        if (displayIndex < 0 || displayIndex >= (int)App::displays.size())
+        for (int index = first; index <= last; ++index)
+        {
+            const WORD(*accepted)[GammaConstants::RAMP_SIZE] = ramp;
+            WORD clampedRamp[3][GammaConstants::RAMP_SIZE];
+            if (!RampPreflight::Check(ramp, s_rampLimits[index]).accepted)
+            {
+                memcpy(clampedRamp, ramp, sizeof(clampedRamp));
+                RampPreflight::Clamp(clampedRamp, s_rampLimits[index]);
+                accepted = clampedRamp;
+                clamped = true;
+                ++s_clampedApplies;
+            }
+
+            if (!GammaWorker::Post(index, accepted, report, transitionMs))
+                WriteRamp(index, accepted, report);
+        }
+
+        if (report)
+            App::state.gammaRampClamped = clamped;
+
+        // The curve preview and the clamp warning may have changed; the window renders on demand.
+        RedrawPolicy::RequestFrames();
+    }
+
+    void ApplyProfile(const Profile& profile, const int displayIndex, const int transitionMs)
+    {
+        if (s_displayCount == 0) return;
+
+        if (displayIndex != -1 && (displayIndex < 0 || displayIndex >= s_displayCount))
             return; // Invalid displayIndex.
 
-        // Create device context for the target display, for the SetDeviceGammaRamp() call.
-        const HDC hdc = CreateDC(NULL, App::displays[displayIndex].deviceName.c_str(), NULL, NULL);
-        if (!hdc) return;
+        // Built here on the UI thread, which also refreshes App::state.lastRamp; only the finished
+        // ramp crosses to the workers, so the preview curve is never written concurrently.
         WORD ramp[3][GammaConstants::RAMP_SIZE];
         BuildGammaRamp(profile, ramp);
-        const BOOL success = SetDeviceGammaRamp(hdc, ramp);
-        App::state.gammaRampFailed = !success;
-        DeleteDC(hdc);
+        SetRamp(displayIndex, ramp, true, transitionMs);
     }
 
-    void ResetDisplay(const int displayIndex)
+    void ApplyBlend(const Profile& from, const Profile& to, const int step, const int steps, const int displayIndex)
     {
-        if (App::displays.empty()) return;
+        if (s_displayCount == 0) return;
 
-        if (displayIndex == -1)
-        {
-            for (int index = 0; index < (int)App::displays.size(); ++index)
-                ResetDisplay(index);
-            return;
-        }
+        if (displayIndex != -1 && (displayIndex < 0 || displayIndex >= s_displayCount))
+            return; // Invalid displayIndex.
+
+        float fromCurve[GammaConstants::RAMP_SIZE];
+        float toCurve[GammaConstants::RAMP_SIZE];
+        WORD fromRamp[3][GammaConstants::RAMP_SIZE];
+        WORD toRamp[3][GammaConstants::RAMP_SIZE];
+        RampCache::GetRamp(MakeParams(from), fromCurve, fromRamp);
+        RampCache::GetRamp(MakeParams(to), toCurve, toRamp);
 
-        if (displayIndex < 0 || displayIndex >= (int)App::displays.size())
+        WORD ramp[3][GammaConstants::RAMP_SIZE];
+        RampEngine::LerpRamp(fromRamp, toRamp, step, steps, ramp);
+
+        // The preview follows the blend too, so the curve moves with the screen during a hold.
+        const float weight = (float)step / (float)steps;
+        for (int i = 0; i < GammaConstants::RAMP_SIZE; ++i)
+            App::state.lastRamp[i] = fromCurve[i] + (toCurve[i] - fromCurve[i]) * weight;
+
+        SetRamp(displayIndex, ramp, true, 0);
+    }
+
+    void ResetDisplay(const int displayIndex)
+    {
+        if (s_displayCount == 0) return;
+
+        if (displayIndex != -1 && (displayIndex < 0 || displayIndex >= s_displayCount))
             return; // Invalid displayIndex.
 
         WORD defaultRamp[3][GammaConstants::RAMP_SIZE];
-        for (int i = 0; i < GammaConstants::RAMP_SIZE; ++i)
-        {
-            const WORD val = (WORD)(i * 257);
-            defaultRamp[0][i] = val;
-            defaultRamp[1][i] = val;
-            defaultRamp[2][i] = val;
-        }
+        RampEngine::BuildIdentityRamp(defaultRamp);
+        SetRamp(displayIndex, defaultRamp, false, 0);
+    }
+
+    void StartWorkers()
+    {
+        StopWorkers();
+
+        const size_t count = App::displays.size();
+        s_displayCount = (int)count;
+
+        // Indices were just reassigned, and a display change may have reset ramps behind our back,
+        // so nothing recorded as applied before can be trusted.
+        s_appliedRamps.assign(count, AppliedRamp());
 
-        const HDC hDC = CreateDC(NULL, App::displays[displayIndex].deviceName.c_str(), NULL, NULL);
-        if (hDC)
+        s_rampLimits.clear();
+        for (int index = 0; index < (int)count; ++index)
+            s_rampLimits.push_back(DisplayManager::GetBackend().GetRampLimits(index));
+        App::state.gammaRampClamped = false;
         {
-            SetDeviceGammaRamp(hDC, defaultRamp);
-            DeleteDC(hDC);
+            std::lock_guard<std::mutex> lock(s_resultMutex);
+            PublishResult(s_outcome.Reset(count));
         }
+
+        std::vector<int> refreshRates;
+        for (int index = 0; index < (int)count; ++index)
+            refreshRates.push_back(DisplayManager::GetBackend().GetRefreshRate(index));
+
+        GammaWorker::Start(refreshRates, WriteRamp, ReadRamp);
+    }
+
+    void StopWorkers()
+    {
+        GammaWorker::Stop();
+    }
+
+    void Flush()
+    {
+        GammaWorker::Flush();
+    }
+
+    void NotifyWhenFlushed(std::function<void()> done)
+    {
+        GammaWorker::NotifyWhenWritten(std::move(done));
+    }
+
+    ApplyStats GetApplyStats()
+    {
+        ApplyStats stats;
+        stats.driverCalls = s_driverCalls;
+        stats.skippedCalls = s_skippedCalls;
+        stats.clampedApplies = s_clampedApplies;
+        const GammaWorker::Stats workerStats = GammaWorker::GetStats();
+        stats.coalescedCalls = workerStats.coalesced;
+        stats.transitions = workerStats.transitions;
+        stats.transitionsCancelled = workerStats.transitionsCancelled;
+        stats.transitionWrites = workerStats.transitionWrites;
+        stats.lastTransitionWrites = workerStats.lastTransitionWrites;
+        return stats;
     }
 }
@@ -22,26 +22,96 @@
  * 1. Brightness: Linear offset (-50 to +50), shifts all values up/down.
  * 2. Contrast: Multiplier around midpoint (0.5 to 1.5), expands/compresses range.
  * 3. Gamma: Power curve (0.1 to 3.0), non-linear adjustment.
+ * The math itself lives in RampEngine (portable, no Windows dependency); this namespace owns the
+ * Windows side: the WORD ramp, the cached preview curve and the driver calls.
  */
 
 #pragma once
 
 #include "GammaHotkeyTypes.h"
+#include <cstdint>
+#include <functional>
 
 namespace GammaManager
 {
+    /**
+     * @brief Counters for the apply layer.
+     */
+    struct ApplyStats
+    {
+        uint64_t driverCalls = 0;          // SetDeviceGammaRamp calls actually made.
+        uint64_t skippedCalls = 0;         // Applies skipped because the display already had that exact ramp.
+        uint64_t coalescedCalls = 0;       // Posted ramps replaced by a newer one before they were written.
+        uint64_t clampedApplies = 0;       // Ramps clamped before posting because the display would have refused them.
+        uint64_t transitions = 0;          // Timed transitions started.
+        uint64_t transitionsCancelled = 0; // Transitions cut short by a newer apply.
+        uint64_t transitionWrites = 0;     // Writes made by transitions, all steps included.
+        int lastTransitionWrites = 0;      // Writes made by the latest transition (capped, see GammaWorker).
+    };
+
     /**
      * @brief Apply gamma settings from a profile to a specific display, or all displays.
      * @param[in] profile Profile containing brightness, contrast, and gamma settings.
      * @param[in] displayIndex Index into App::displays vector, or -1 to apply to all displays.
+     * @param[in] transitionMs Fade from each display's current ramp over this many milliseconds, paced to
+     *            its refresh rate; 0 (the default) applies at once. A later apply cancels a fade in progress.
+     * @note Asynchronous: the ramp is built here (refreshing App::state.lastRamp) and written by the
+     *       display's worker; App::state.gammaRampFailed updates once the driver answers. A display
+     *       that already has the resulting ramp is skipped (see GetApplyStats). A ramp the display
+     *       would refuse (see RampPreflight) is clamped first, and App::state.gammaRampClamped is set
+     *       before this returns.
      */
-    void ApplyProfile(const Profile& profile, const int displayIndex);
+    void ApplyProfile(const Profile& profile, const int displayIndex, const int transitionMs = 0);
+
+    /**
+     * @brief Apply a blend of two profiles' ramps: from's at step 0, to's at step == steps.
+     * @param[in] from, to Profiles whose ramps bound the blend, typically served from RampCache.
+     * @param[in] step, steps Position in the blend (see RampEngine::LerpRamp); steps at least 1.
+     * @param[in] displayIndex Index into App::displays vector, or -1 to apply to all displays.
+     * @note For the in-between frames of a held step hotkey: two cached ramps and an integer blend
+     *       stand in for a curve build per frame. Close to, but not exactly, the ramp of the values in
+     *       between (gamma is not linear), so the value the user lands on is applied with ApplyProfile.
+     *       Otherwise behaves as ApplyProfile without a transition, preview curve included.
+     */
+    void ApplyBlend(const Profile& from, const Profile& to, const int step, const int steps, const int displayIndex);
     
     /**
      * @brief Reset gamma to default (linear) on a specific display, or all displays.
      * @param[in] displayIndex Index into App::displays vector, or -1 to apply to all displays.
+     * @note Asynchronous like ApplyProfile; call Flush() when the reset must land before continuing.
      */
     void ResetDisplay(const int displayIndex);
+
+    /**
+     * @brief Start one apply worker per entry in App::displays, replacing any running set.
+     * @note Called after every enumeration. Also forgets which ramp each display was last given, so
+     *       the next apply always reaches the driver: indices may have shifted, and a mode change can
+     *       reset a display's ramp behind our back.
+     */
+    void StartWorkers();
+
+    /**
+     * @brief Write any pending ramps, then stop the apply workers.
+     * @note Called before App::displays changes and on exit.
+     */
+    void StopWorkers();
+
+    /**
+     * @brief Block until every ramp posted so far has been written.
+     */
+    void Flush();
+
+    /**
+     * @brief Call done once every ramp posted so far has been written, without blocking.
+     * @note done runs here if nothing is pending, otherwise on an apply worker (see
+     *       GammaWorker::NotifyWhenWritten); App::state.gammaRampFailed is up to date by then.
+     */
+    void NotifyWhenFlushed(std::function<void()> done);
+
+    /**
+     * @brief Driver calls made, skipped and coalesced, clamped applies, and transition counts, since launch.
+     */
+    ApplyStats GetApplyStats();
     
     /**
      * @brief Compute the normalized gamma curve from profile settings and cache it (App::state.lastRamp),
@@ -55,7 +125,8 @@ namespace GammaManager
      * @brief Build a gamma ramp from profile settings, without applying it to any display.
      * @param[in] profile Profile containing brightness, contrast, and gamma values.
      * @param[out] ramp Output array [3][256] for R, G, B channels.
-     * @note Also refreshes the cached curve preview via BuildRamp().
+     * @note Also refreshes the cached curve preview, like BuildRamp(). Both are served from RampCache
+     *       when the same brightness/contrast/gamma was built recently.
      */
     void BuildGammaRamp(const Profile& profile, WORD ramp[3][256]);
 }
@@ -0,0 +1,296 @@
+// Copyright (c) 2025 Max Godman
+
+#include "GammaWorker.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace GammaWorker
+{
+    using Ramp = uint16_t[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE];
+
+    // One NotifyWhenWritten call, shared by the workers it waits for; the last one to finish calls done.
+    struct Notification
+    {
+        std::atomic<int> remaining = 0;
+        std::function<void()> done;
+    };
+
+    struct Waiter
+    {
+        uint64_t sequence = 0; // Called back once the worker has written this post.
+        std::shared_ptr<Notification> notification;
+    };
+
+    struct Worker
+    {
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable signal; // Wakes the worker on a post or stop, and Flush when it goes idle.
+        bool pending = false;           // A ramp is waiting in the mailbox.
+        bool busy = false;              // The worker is writing (or fading to) a ramp it took from the mailbox.
+        bool stop = false;
+        bool report = false;
+        int transitionMs = 0;
+        Ramp ramp = {};
+        uint64_t posted = 0;            // Sequence number of the latest post.
+        uint64_t written = 0;           // Sequence number of the latest post written (or replaced, then written).
+        std::vector<Waiter> waiters;    // NotifyWhenWritten calls waiting for a post not yet written.
+
+        // Worker thread only: the refresh rate pacing transitions, and the ramp the display shows,
+        // which is where the next transition starts from. Read from the display when the worker
+        // starts, then the last ramp written; unknown if that read or write failed.
+        int refreshRate = DEFAULT_REFRESH_RATE;
+        bool hasCurrent = false;
+        Ramp current = {};
+    };
+
+    // Workers are only added or removed by Start/Stop on the UI thread, never while anything else
+    // reads this vector, so it needs no lock of its own; each worker's mailbox has its own.
+    static std::vector<std::unique_ptr<Worker>> s_workers;
+    static WriteFunc s_write = nullptr;
+    static ReadFunc s_read = nullptr;
+
+    static std::atomic<uint64_t> s_coalesced = 0;
+    static std::atomic<uint64_t> s_transitions = 0;
+    static std::atomic<uint64_t> s_transitionsCancelled = 0;
+    static std::atomic<uint64_t> s_transitionWrites = 0;
+    static std::atomic<int> s_lastTransitionWrites = 0;
+
+    // Drop one reference to a notification, calling it if that was the last.
+    static void Release(Notification& notification)
+    {
+        if (--notification.remaining == 0)
+            notification.done();
+    }
+
+    // One write per frame, bounded by MAX_TRANSITION_WRITES, and always at least one (the target).
+    static int GetTransitionSteps(const int transitionMs, const int refreshRate)
+    {
+        const int frames = (int)((int64_t)transitionMs * refreshRate / 1000);
+        if (frames < 1)
+            return 1;
+        return frames < MAX_TRANSITION_WRITES ? frames : MAX_TRANSITION_WRITES;
+    }
+
+    // Write one ramp without holding the mailbox, so the UI can post the next one meanwhile.
+    // Caller holds lock.
+    static void WriteUnlocked(std::unique_lock<std::mutex>& lock, const int displayIndex, Worker& worker,
+                              const Ramp ramp, const bool report)
+    {
+        lock.unlock();
+        const bool success = s_write(displayIndex, ramp, report);
+        lock.lock();
+
+        // A failed write leaves the display on some earlier ramp; don't fade from one it never got.
+        worker.hasCurrent = success;
+        if (success)
+            std::memcpy(worker.current, ramp, sizeof(worker.current));
+    }
+
+    static void Run(const int displayIndex, Worker& worker)
+    {
+        Ramp target;
+        Ramp from;
+        Ramp step;
+
+        // Before taking the mailbox, so a post made meanwhile just waits for this one read.
+        if (s_read)
+            worker.hasCurrent = s_read(displayIndex, worker.current);
+
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        for (;;)
+        {
+            worker.signal.wait(lock, [&worker] { return worker.pending || worker.stop; });
+
+            // Stop only once the mailbox is empty, so the last posted ramp (e.g. the reset on exit)
+            // is always written.
+            if (!worker.pending)
+                break;
+
+            std::memcpy(target, worker.ramp, sizeof(target));
+            const bool report = worker.report;
+            const int transitionMs = worker.transitionMs;
+            const uint64_t sequence = worker.posted;
+            worker.pending = false;
+            worker.busy = true;
+
+            // Fade only from a known ramp, and only if there is somewhere to go.
+            const bool fade = transitionMs > 0 && worker.hasCurrent &&
+                              std::memcmp(worker.current, target, sizeof(target)) != 0;
+            if (!fade)
+            {
+                WriteUnlocked(lock, displayIndex, worker, target, report);
+            }
+            else
+            {
+                std::memcpy(from, worker.current, sizeof(from));
+                const int steps = GetTransitionSteps(transitionMs, worker.refreshRate);
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                const std::chrono::microseconds duration = std::chrono::milliseconds(transitionMs);
+                ++s_transitions;
+
+                int writes = 0;
+                for (int index = 1; index <= steps; ++index)
+                {
+                    RampEngine::LerpRamp(from, target, index, steps, step);
+                    WriteUnlocked(lock, displayIndex, worker, step, report);
+                    ++writes;
+                    if (index == steps)
+                        break;
+
+                    // Steps are spread evenly over the duration, so the fade keeps its length even if
+                    // a write runs long; a new target or a stop ends the wait early.
+                    const std::chrono::steady_clock::time_point next = start + duration * index / steps;
+                    worker.signal.wait_until(lock, next, [&worker] { return worker.pending || worker.stop; });
+
+                    if (worker.pending)
+                    {
+                        // Superseded: the outer loop takes the new target and fades from here.
+                        ++s_transitionsCancelled;
+                        break;
+                    }
+                    if (worker.stop)
+                    {
+                        // Shutting down: land on the target now rather than stall the exit.
+                        WriteUnlocked(lock, displayIndex, worker, target, report);
+                        ++writes;
+                        break;
+                    }
+                }
+
+                s_transitionWrites += writes;
+                s_lastTransitionWrites = writes;
+            }
+
+            worker.busy = false;
+            worker.signal.notify_all();
+
+            // Every post up to this one has been written or replaced by it. Call back outside the
+            // mailbox, so a callback may post again.
+            worker.written = sequence;
+            std::vector<Waiter> finished;
+            for (size_t index = 0; index < worker.waiters.size();)
+            {
+                if (worker.waiters[index].sequence <= sequence)
+                {
+                    finished.push_back(std::move(worker.waiters[index]));
+                    worker.waiters.erase(worker.waiters.begin() + index);
+                }
+                else
+                {
+                    ++index;
+                }
+            }
+            if (!finished.empty())
+            {
+                lock.unlock();
+                for (const Waiter& waiter : finished)
+                    Release(*waiter.notification);
+                lock.lock();
+            }
+        }
+    }
+
+    void Start(const std::vector<int>& refreshRates, const WriteFunc write, const ReadFunc read)
+    {
+        Stop();
+
+        s_write = write;
+        s_read = read;
+        for (int index = 0; index < (int)refreshRates.size(); ++index)
+        {
+            s_workers.push_back(std::make_unique<Worker>());
+            Worker& worker = *s_workers.back();
+            if (refreshRates[index] > 0)
+                worker.refreshRate = refreshRates[index];
+            worker.thread = std::thread(Run, index, std::ref(worker));
+        }
+    }
+
+    void Stop()
+    {
+        for (const std::unique_ptr<Worker>& worker : s_workers)
+        {
+            {
+                std::lock_guard<std::mutex> lock(worker->mutex);
+                worker->stop = true;
+            }
+            worker->signal.notify_all();
+        }
+
+        for (const std::unique_ptr<Worker>& worker : s_workers)
+            worker->thread.join();
+
+        s_workers.clear();
+    }
+
+    bool IsRunning()
+    {
+        return !s_workers.empty();
+    }
+
+    bool Post(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE],
+              const bool report, const int transitionMs)
+    {
+        if (displayIndex < 0 || displayIndex >= (int)s_workers.size())
+            return false;
+
+        Worker& worker = *s_workers[displayIndex];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.pending)
+                ++s_coalesced;
+            std::memcpy(worker.ramp, ramp, sizeof(worker.ramp));
+            ++worker.posted;
+            worker.report = report;
+            worker.transitionMs = transitionMs > 0 ? transitionMs : 0;
+            worker.pending = true;
+        }
+        worker.signal.notify_all();
+        return true;
+    }
+
+    void Flush()
+    {
+        for (const std::unique_ptr<Worker>& worker : s_workers)
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->signal.wait(lock, [&worker] { return !worker->pending && !worker->busy; });
+        }
+    }
+
+    void NotifyWhenWritten(std::function<void()> done)
+    {
+        // One reference of our own until every worker has been asked, so done cannot run early.
+        const std::shared_ptr<Notification> notification = std::make_shared<Notification>();
+        notification->done = std::move(done);
+        notification->remaining = 1;
+
+        for (const std::unique_ptr<Worker>& worker : s_workers)
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            if (worker->written < worker->posted)
+            {
+                ++notification->remaining;
+                worker->waiters.push_back({ worker->posted, notification });
+            }
+        }
+        Release(*notification);
+    }
+
+    Stats GetStats()
+    {
+        Stats stats;
+        stats.coalesced = s_coalesced;
+        stats.transitions = s_transitions;
+        stats.transitionsCancelled = s_transitionsCancelled;
+        stats.transitionWrites = s_transitionWrites;
+        stats.lastTransitionWrites = s_lastTransitionWrites;
+        return stats;
+    }
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Max Godman
+
+// Background threads that push gamma ramps to displays, one per display.
+
+/**
+ * CreateDC + SetDeviceGammaRamp can take milliseconds on some drivers, and the UI applies a ramp on
+ * every slider frame and every hotkey press. Doing that on the UI thread stalls the ImGui frame, so
+ * the driver calls happen here instead.
+ *
+ * MAILBOXES:
+ * Each display has a single-slot "latest wins" mailbox and its own thread. Posting a ramp overwrites
+ * whatever is still waiting, so a slider drag or a burst of hotkeys collapses to the final ramp
+ * rather than queueing every intermediate one. Writes to different displays run in parallel, which
+ * is how "all displays" (-1) fans out.
+ *
+ * TRANSITIONS:
+ * A ramp posted with a duration fades in from whatever the display currently shows: the ramp it read
+ * from the display when it started, then the last one it wrote successfully. The worker blends
+ * the two finished 16-bit ramps (RampEngine::LerpRamp, no curve math), one write per frame at the
+ * display's refresh rate, capped at MAX_TRANSITION_WRITES. A new post mid-fade cancels it: the next
+ * target starts from the partly faded ramp, so nothing ever jumps back. Stopping mid-fade writes the
+ * final ramp at once. After a failed write the display's ramp is unknown, so the next post is
+ * written directly rather than faded from a guess.
+ *
+ * The worker set is fixed for one enumeration of App::displays: DisplayManager stops it before
+ * re-enumerating and starts a new one afterwards, so a worker never sees indices shift under it.
+ *
+ * Portable (no <windows.h>): what a write does is entirely up to the WriteFunc.
+ */
+
+#pragma once
+
+#include "RampEngine.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace GammaWorker
+{
+    // Most writes one transition may make, however long or high the refresh rate; a long fade then
+    // spaces its steps further apart instead of hammering the driver.
+    constexpr int MAX_TRANSITION_WRITES = 120;
+
+    // Refresh rate assumed when a display does not report one.
+    constexpr int DEFAULT_REFRESH_RATE = 60;
+
+    /**
+     * @brief Writes a ramp to one display; runs on that display's worker thread.
+     * @param[in] displayIndex Index of the display the ramp was posted to.
+     * @param[in] ramp The latest ramp posted for it, or a step of a transition towards it.
+     * @param[in] report The report flag it was posted with.
+     * @return true if the display now shows the ramp.
+     */
+    using WriteFunc = bool (*)(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const bool report);
+
+    /**
+     * @brief Reads the ramp a display shows now; runs on that display's worker thread as it starts.
+     * @param[in] displayIndex Index of the display.
+     * @param[out] ramp The display's current ramp.
+     * @return false if it could not be read; the first post to the display is then written directly.
+     */
+    using ReadFunc = bool (*)(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]);
+
+    /**
+     * @brief Counters across all workers since launch.
+     */
+    struct Stats
+    {
+        uint64_t coalesced = 0;             // Posted ramps replaced by a newer one before they were written.
+        uint64_t transitions = 0;           // Transitions started.
+        uint64_t transitionsCancelled = 0;  // Transitions cut short by a newer post.
+        uint64_t transitionWrites = 0;      // Writes made by transitions, all steps included.
+        int lastTransitionWrites = 0;       // Writes made by the most recently finished or cancelled transition.
+    };
+
+    /**
+     * @brief Start one worker per display. Stops any running set first.
+     * @param[in] refreshRates Refresh rate of each display in Hz (0 = unknown); one worker per entry.
+     * @param[in] write Called on the worker thread for every ramp it writes.
+     * @param[in] read Called once on each worker thread before anything is written, so the first
+     *                 transition fades from what the display shows; nullptr to skip.
+     */
+    void Start(const std::vector<int>& refreshRates, const WriteFunc write, const ReadFunc read);
+
+    /**
+     * @brief Write whatever is still pending, then stop and join every worker.
+     * @note A transition in progress finishes at once, with its final ramp.
+     */
+    void Stop();
+
+    /**
+     * @brief Whether a worker set is running (and Post will accept ramps).
+     */
+    bool IsRunning();
+
+    /**
+     * @brief Post a ramp to a display's mailbox, replacing any ramp still waiting there.
+     * @param[in] displayIndex Index of the display, 0 to displayCount - 1.
+     * @param[in] ramp The ramp to write; copied, so the caller's buffer can be reused immediately.
+     * @param[in] report Passed through to the write function.
+     * @param[in] transitionMs Fade in over this many milliseconds; 0 writes the ramp directly.
+     * @return false if no worker serves that display; the caller should write it itself.
+     */
+    bool Post(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE],
+              const bool report, const int transitionMs = 0);
+
+    /**
+     * @brief Block until every posted ramp has been written, transitions included.
+     */
+    void Flush();
+
+    /**
+     * @brief Flush without blocking: call done once every ramp posted so far has been written.
+     * @param[in] done Called exactly once: here if nothing is pending, otherwise on the worker thread
+     *            that finishes the last of those ramps, after its write function has returned.
+     * @note Ramps posted later are not waited for, though one that replaces a pending ramp is (it
+     *       is written in its place). Stop writes everything pending, so done is never dropped.
+     */
+    void NotifyWhenWritten(std::function<void()> done);
+
+    /**
+     * @brief Current counters.
+     */
+    Stats GetStats();
+}
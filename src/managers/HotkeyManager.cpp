@@ -6,55 +6,261 @@
 #include "UIGlobals.h"
 #include "GammaHotkeyTypes.h"
 #include "ProfileManager.h"
+#include "ConfigManager.h"
+#include "GammaManager.h"
+#include "GammaWorker.h"
+#include "DisplayManager.h"
 #include "UI_Shared.h"
+#include <array>
 #include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 namespace HotkeyManager
 {
-    // IDs currently registered with Windows, tracked so we can unregister exactly
-    // what we registered even if the profile list changes between calls.
-    static std::vector<int> s_registeredIds;
+    // A hotkey ID and the key combination bound to it.
+    struct Binding
+    {
+        int id;
+        UINT hotkey; // HotkeyCode: key plus modifiers.
+    };
 
-    // Register a single hotkey, tracking it on success. vk == 0 means "unbound", skip.
-    // Registration can fail if another application already owns the global hotkey; we
-    // tolerate that silently (the binding simply won't fire) rather than stealing the
-    // key system-wide, which is the cooperative behavior RegisterHotKey is designed for.
-    static void RegisterOne(const HWND hwnd, const int id, const UINT vk)
+    // What a hotkey ID does when it fires: a handler and the argument it was registered with.
+    struct Action
     {
-        if (vk == 0)
-            return;
+        void (*handler)(int argument);
+        int argument;
+    };
+
+    // Hotkeys currently registered with Windows, sorted by ID, tracked so we can unregister
+    // exactly what we registered even if the profile list changes between calls.
+    static std::vector<Binding> s_registered;
+
+    // The hotkey ID bound to each key and modifier combination, 0 if none. Reflects the bindings
+    // of the last Refresh (or FindAction rebuild), whether or not they are registered right now.
+    static std::array<int, HotkeyCode::COUNT> s_index = {};
+
+    // Flat dispatch table indexed by hotkey ID; IDs without a binding have no handler.
+    static std::vector<Action> s_actions;
+
+    // Where each profile hotkey ID's profile sits in App::profiles, -1 for none. Indexed by hotkey ID.
+    static std::vector<int> s_profileSlots;
+
+    static void ToggleAction(int);
+    static void CycleAction(const int direction);
+    static void StepAction(const int hotkeyId);
+    static void ApplyProfileAction(const int hotkeyId);
+    static void EndStepHold();
+
+    // The bindings the current settings ask for, sorted by ID. Unbound (0) and invalid codes are skipped.
+    static void CollectBindings(std::vector<Binding>& bindings)
+    {
+        bindings.clear();
+        const auto add = [&bindings](const int id, const UINT hotkey)
+        {
+            if (HotkeyCode::IsValid(hotkey))
+                bindings.push_back({ id, hotkey });
+        };
 
-        // MOD_NOREPEAT: holding the key fires once, not repeatedly.
-        if (RegisterHotKey(hwnd, id, MOD_NOREPEAT, vk))
-            s_registeredIds.push_back(id);
+        add(HotkeyIDs::TOGGLE, App::toggleHotkey);
+        add(HotkeyIDs::PREVIOUS_PROFILE, App::previousProfileHotkey);
+        add(HotkeyIDs::NEXT_PROFILE, App::nextProfileHotkey);
+        add(HotkeyIDs::BRIGHTNESS_UP, App::brightnessUpHotkey);
+        add(HotkeyIDs::BRIGHTNESS_DOWN, App::brightnessDownHotkey);
+        add(HotkeyIDs::CONTRAST_UP, App::contrastUpHotkey);
+        add(HotkeyIDs::CONTRAST_DOWN, App::contrastDownHotkey);
+        add(HotkeyIDs::GAMMA_UP, App::gammaUpHotkey);
+        add(HotkeyIDs::GAMMA_DOWN, App::gammaDownHotkey);
+
+        for (const Profile& profile : App::profiles)
+        {
+            if (profile.id > 0)
+                add(HotkeyIDs::PROFILE_BASE + profile.id, profile.hotkey);
+        }
+
+        // Profile IDs follow the order profiles were added, not the list order.
+        std::sort(bindings.begin(), bindings.end(),
+            [](const Binding& a, const Binding& b) { return a.id < b.id; });
+    }
+
+    // The binding with this ID in a sorted list, or nullptr.
+    static const Binding* FindBinding(const std::vector<Binding>& bindings, const int id)
+    {
+        const auto it = std::lower_bound(bindings.begin(), bindings.end(), id,
+            [](const Binding& binding, const int value) { return binding.id < value; });
+        return (it != bindings.end() && it->id == id) ? &*it : nullptr;
+    }
+
+    // Rebuild the key index, the dispatch table and the profile slots from the settings and a
+    // sorted list of the bindings they ask for.
+    static void BuildTables(const std::vector<Binding>& bindings)
+    {
+        s_index.fill(0);
+        s_actions.assign(bindings.empty() ? 0 : bindings.back().id + 1, Action{ nullptr, 0 });
+
+        for (const Binding& binding : bindings)
+        {
+            // Of two actions sharing a key (only a hand-edited config does that), the lower ID wins.
+            if (s_index[binding.hotkey] == 0)
+                s_index[binding.hotkey] = binding.id;
+
+            Action& action = s_actions[binding.id];
+            switch (binding.id)
+            {
+            case HotkeyIDs::TOGGLE: action = { ToggleAction, 0 }; break;
+            case HotkeyIDs::PREVIOUS_PROFILE: action = { CycleAction, -1 }; break;
+            case HotkeyIDs::NEXT_PROFILE: action = { CycleAction, 1 }; break;
+            case HotkeyIDs::BRIGHTNESS_UP:
+            case HotkeyIDs::BRIGHTNESS_DOWN:
+            case HotkeyIDs::CONTRAST_UP:
+            case HotkeyIDs::CONTRAST_DOWN:
+            case HotkeyIDs::GAMMA_UP:
+            case HotkeyIDs::GAMMA_DOWN:
+                action = { StepAction, binding.id };
+                break;
+            default: action = { ApplyProfileAction, binding.id }; break;
+            }
+        }
+
+        s_profileSlots.clear();
+        for (size_t slot = 0; slot < App::profiles.size(); ++slot)
+        {
+            const int id = HotkeyIDs::PROFILE_BASE + App::profiles[slot].id;
+            if (id >= (int)s_profileSlots.size())
+                s_profileSlots.resize(id + 1, -1);
+            s_profileSlots[id] = (int)slot;
+        }
+    }
+
+    // Rebuild the tables from the settings as they are now, after they changed without a Refresh.
+    static void RebuildTables()
+    {
+        std::vector<Binding> bindings;
+        CollectBindings(bindings);
+        BuildTables(bindings);
+    }
+
+    // The key currently bound to a hotkey ID in the settings, 0 if none.
+    static UINT BoundKey(const int id)
+    {
+        switch (id)
+        {
+        case HotkeyIDs::TOGGLE: return App::toggleHotkey;
+        case HotkeyIDs::PREVIOUS_PROFILE: return App::previousProfileHotkey;
+        case HotkeyIDs::NEXT_PROFILE: return App::nextProfileHotkey;
+        case HotkeyIDs::BRIGHTNESS_UP: return App::brightnessUpHotkey;
+        case HotkeyIDs::BRIGHTNESS_DOWN: return App::brightnessDownHotkey;
+        case HotkeyIDs::CONTRAST_UP: return App::contrastUpHotkey;
+        case HotkeyIDs::CONTRAST_DOWN: return App::contrastDownHotkey;
+        case HotkeyIDs::GAMMA_UP: return App::gammaUpHotkey;
+        case HotkeyIDs::GAMMA_DOWN: return App::gammaDownHotkey;
+        }
+
+        const int slot = ProfileIndex(id);
+        return slot >= 0 ? App::profiles[slot].hotkey : 0;
     }
 
     void UnregisterAll(const HWND hwnd)
     {
-        for (const int id : s_registeredIds)
-            UnregisterHotKey(hwnd, id);
-        s_registeredIds.clear();
+        // Nothing fires while unregistered, so a hold in progress ends here, as a release would end
+        // it: on the exact ramp of where it stands, saved.
+        EndStepHold();
+
+        for (const Binding& binding : s_registered)
+            UnregisterHotKey(hwnd, binding.id);
+        s_registered.clear();
     }
 
     void RegisterAll(const HWND hwnd)
     {
         // Start from a clean slate: unregister whatever is currently registered before
-        // registering the current set. Callers that change bindings can therefore just call
-        // RegisterAll; they do not need to UnregisterAll first (it tracks s_registeredIds, not
-        // the profiles vector, so it unregisters exactly what was registered regardless of order).
+        // registering the current set, so keys another app held last time are tried again.
+        // Callers that change bindings can therefore just call RegisterAll (or Refresh).
         UnregisterAll(hwnd);
+        Refresh(hwnd);
+    }
+
+    void Refresh(const HWND hwnd)
+    {
+        static std::vector<Binding> wanted;
+        CollectBindings(wanted);
+        BuildTables(wanted);
+
+        // Unregister everything that is no longer bound as it is, first: a key moving from one
+        // binding to another has to be free before it can be registered again.
+        size_t kept = 0;
+        for (const Binding& binding : s_registered)
+        {
+            const Binding* const want = FindBinding(wanted, binding.id);
+            if (want && want->hotkey == binding.hotkey)
+                s_registered[kept++] = binding;
+            else
+                UnregisterHotKey(hwnd, binding.id);
+        }
+        s_registered.resize(kept);
+
+        // Registration can fail if another application already owns the global hotkey; we
+        // tolerate that silently (the binding simply won't fire) rather than stealing the
+        // key system-wide, which is the cooperative behavior RegisterHotKey is designed for.
+        // Both lists are sorted by ID, so one pass finds what is missing.
+        size_t next = 0;
+        for (const Binding& binding : wanted)
+        {
+            while (next < kept && s_registered[next].id < binding.id)
+                ++next;
+            if (next < kept && s_registered[next].id == binding.id)
+                continue;
+
+            // MOD_NOREPEAT: holding the key fires once, not repeatedly.
+            const UINT modifiers = MOD_NOREPEAT | HotkeyCode::Modifiers(binding.hotkey);
+            if (RegisterHotKey(hwnd, binding.id, modifiers, HotkeyCode::Vk(binding.hotkey)))
+                s_registered.push_back(binding);
+        }
+
+        // The new registrations were appended in ID order; merge them into the kept ones.
+        std::inplace_merge(s_registered.begin(), s_registered.begin() + kept, s_registered.end(),
+            [](const Binding& a, const Binding& b) { return a.id < b.id; });
+    }
+
+    int FindAction(const UINT hotkey)
+    {
+        if (!HotkeyCode::IsValid(hotkey))
+            return 0;
 
-        RegisterOne(hwnd, HotkeyIDs::TOGGLE, App::toggleHotkey);
-        RegisterOne(hwnd, HotkeyIDs::PREVIOUS_PROFILE, App::previousProfileHotkey);
-        RegisterOne(hwnd, HotkeyIDs::NEXT_PROFILE, App::nextProfileHotkey);
+        // An entry is trusted only while the settings still bind its ID to this key. One that
+        // went stale (a binding cleared or moved since the last Refresh) triggers a rebuild.
+        const int id = s_index[hotkey];
+        if (id == 0 || BoundKey(id) == hotkey)
+            return id;
 
-        for (size_t index = 0; index < App::profiles.size(); ++index)
-            RegisterOne(hwnd, HotkeyIDs::PROFILE_BASE + (int)index, App::profiles[index].hotkey);
+        RebuildTables();
+        return s_index[hotkey];
     }
 
-    bool IsBindableKey(const UINT vk, const char** reasonForRejection)
+    int ProfileIndex(const int hotkeyId)
     {
-        switch (vk)
+        const int profileId = hotkeyId - HotkeyIDs::PROFILE_BASE;
+        if (profileId <= 0)
+            return -1;
+
+        const auto lookup = [hotkeyId, profileId]()
+        {
+            const int slot = hotkeyId < (int)s_profileSlots.size() ? s_profileSlots[hotkeyId] : -1;
+            return (slot >= 0 && slot < (int)App::profiles.size() && App::profiles[slot].id == profileId) ? slot : -1;
+        };
+
+        // The slots move whenever the list changes; a stale one makes the tables rebuild.
+        const int slot = lookup();
+        if (slot >= 0)
+            return slot;
+        RebuildTables();
+        return lookup();
+    }
+
+    bool IsBindableKey(const UINT hotkey, const char** reasonForRejection)
+    {
+        switch (HotkeyCode::Vk(hotkey))
         {
         // Bare modifier keys cannot be fired on their own by RegisterHotKey.
         case VK_SHIFT:   case VK_LSHIFT:   case VK_RSHIFT:
@@ -62,7 +268,7 @@ namespace HotkeyManager
         case VK_MENU:    case VK_LMENU:    case VK_RMENU:
         case VK_LWIN:    case VK_RWIN:
             if (reasonForRejection)
-                *reasonForRejection = "Modifier keys (Shift, Ctrl, Alt, Win) can't be used on their own.";
+                *reasonForRejection = "Modifier keys (Shift, Ctrl, Alt, Win) can't be used on their own; hold them and press another key.";
             return false;
 
         // F12 is reserved by Windows for the debugger.
@@ -76,45 +282,272 @@ namespace HotkeyManager
         }
     }
 
-    void HandleHotkey(const int hotkeyId)
+    static void ToggleAction(int)
     {
-        // Close any open context menus (e.g. the system tray menu) so a hotkey press
-        // while the menu is open doesn't leave it stuck open.
-        if (App::mainWindow)
+        App::ToggleGamma();
+    }
+
+    static void CycleAction(const int direction)
+    {
+        // If gamma is disabled, just enable it (don't cycle to a different profile).
+        if (!App::state.IsGammaEnabled())
         {
-            SendMessage(App::mainWindow, WM_CANCELMODE, 0, 0);
+            App::state.SetGammaEnabled(true);
+            App::SyncGammaToState();
         }
+        else
+        {
+            // Gamma is already enabled, cycle to the previous/next profile.
+            ProfileManager::CycleProfile(direction);
+            SyncUIWithCurrentProfile();
+        }
+        UI::SyncUIToState();
+    }
+
+    // STEP HOTKEYS:
+    // Each field moves on a fixed grid (see StepGrid). A press moves one grid step at once; held past
+    // HOLD_DELAY_MS, it keeps moving, from HOLD_START_RATE steps per second up to HOLD_MAX_RATE over
+    // HOLD_ACCEL_MS. A timer on the main window, set to the display's frame time, polls the key and
+    // applies at most once per frame: WM_HOTKEY cannot report a release, and MOD_NOREPEAT would
+    // swallow auto-repeat anyway. Values in between are shown as a blend of the two nearest anchor
+    // ramps (every STEP_ANCHOR grid steps), which RampCache keeps, so a hold builds a handful of
+    // curves instead of one per frame. Releasing applies the exact ramp and saves, once.
+
+    // The profile field a step hotkey moves; also its index into STEP_GRIDS.
+    enum StepField
+    {
+        STEP_BRIGHTNESS,
+        STEP_CONTRAST,
+        STEP_GAMMA,
+    };
+
+    // A field's grid: value = origin + index * unit, index 0 to count.
+    struct StepGrid
+    {
+        float origin;
+        float unit;
+        int count;
+    };
+
+    static constexpr StepGrid STEP_GRIDS[] = {
+        { (float)ProfileRange::BRIGHTNESS_MIN, 1.0f, ProfileRange::BRIGHTNESS_MAX - ProfileRange::BRIGHTNESS_MIN },
+        { ProfileRange::CONTRAST_MIN, 0.01f, 100 },  // 0.5 to 1.5.
+        { ProfileRange::GAMMA_MIN, 0.01f, 290 },     // 0.1 to 3.0.
+    };
 
-        if (hotkeyId == HotkeyIDs::TOGGLE)
+    static constexpr int STEP_ANCHOR = 10;       // Grid steps between exactly built ramps.
+    static constexpr int HOLD_DELAY_MS = 300;    // Held this long before the value keeps moving.
+    static constexpr float HOLD_START_RATE = 10.0f;
+    static constexpr float HOLD_MAX_RATE = 100.0f;
+    static constexpr float HOLD_ACCEL_MS = 1500.0f;
+
+    using StepClock = std::chrono::steady_clock;
+
+    struct StepHold
+    {
+        bool active = false;
+        int hotkeyId = 0;
+        UINT vk = 0;
+        StepField field = STEP_BRIGHTNESS;
+        int direction = 0;   // +1 or -1.
+        int startIndex = 0;  // Grid index after the first step.
+        int index = 0;       // Grid index applied last.
+        StepClock::time_point pressed;
+        StepClock::time_point lastApply;
+        StepClock::duration frame = {};
+    };
+
+    static StepHold s_hold;
+
+    // The profile step hotkeys adjust: the one the current mode applies (see App::SyncGammaToState).
+    static Profile& StepProfile()
+    {
+        return App::state.IsAdvancedModeEnabled() ? App::workingProfile : App::simpleProfile;
+    }
+
+    static float GetStepValue(const Profile& profile, const StepField field)
+    {
+        switch (field)
         {
-            App::ToggleGamma();
+        case STEP_BRIGHTNESS: return (float)profile.brightness;
+        case STEP_CONTRAST: return profile.contrast;
+        case STEP_GAMMA: return profile.gamma;
         }
-        else if (hotkeyId == HotkeyIDs::PREVIOUS_PROFILE || hotkeyId == HotkeyIDs::NEXT_PROFILE)
+        return 0.0f;
+    }
+
+    static void SetStepValue(Profile& profile, const StepField field, const int index)
+    {
+        const StepGrid& grid = STEP_GRIDS[field];
+        const float value = grid.origin + index * grid.unit;
+        switch (field)
         {
-            const int direction = (hotkeyId == HotkeyIDs::NEXT_PROFILE) ? 1 : -1;
+        case STEP_BRIGHTNESS: profile.brightness = (int)std::lround(value); break;
+        case STEP_CONTRAST: profile.contrast = std::clamp(value, ProfileRange::CONTRAST_MIN, ProfileRange::CONTRAST_MAX); break;
+        case STEP_GAMMA: profile.gamma = std::clamp(value, ProfileRange::GAMMA_MIN, ProfileRange::GAMMA_MAX); break;
+        }
+    }
 
-            // If gamma is disabled, just enable it (don't cycle to a different profile).
-            if (!App::state.IsGammaEnabled())
-            {
-                App::state.SetGammaEnabled(true);
-                App::SyncGammaToState();
-            }
-            else
-            {
-                // Gamma is already enabled, cycle to the previous/next profile.
-                ProfileManager::CycleProfile(direction);
-                SyncUIWithCurrentProfile();
-            }
-            UI::SyncUIToState();
+    // Apply the profile at a grid index: an anchor's ramp as is, anything else blended between the
+    // anchors either side.
+    static void ApplyStepIndex(const Profile& profile, const StepField field, const int index)
+    {
+        const int lower = index - index % STEP_ANCHOR;
+        if (lower == index)
+        {
+            GammaManager::ApplyProfile(profile, App::selectedDisplayIndex);
+            return;
         }
-        else if (hotkeyId >= HotkeyIDs::PROFILE_BASE &&
-                 hotkeyId < HotkeyIDs::PROFILE_BASE + (int)App::profiles.size())
+
+        const int upper = std::min(lower + STEP_ANCHOR, STEP_GRIDS[field].count);
+        Profile from = profile;
+        Profile to = profile;
+        SetStepValue(from, field, lower);
+        SetStepValue(to, field, upper);
+        GammaManager::ApplyBlend(from, to, index - lower, upper - lower, App::selectedDisplayIndex);
+    }
+
+    // One frame of the displays the step applies to; the fastest of them for all displays.
+    static StepClock::duration StepFrameTime()
+    {
+        int refreshRate = 0;
+        const int first = (App::selectedDisplayIndex == -1) ? 0 : App::selectedDisplayIndex;
+        const int last = (App::selectedDisplayIndex == -1) ? (int)App::displays.size() - 1 : App::selectedDisplayIndex;
+        for (int index = first; index <= last; ++index)
+            refreshRate = std::max(refreshRate, DisplayManager::GetBackend().GetRefreshRate(index));
+        if (refreshRate <= 0)
+            refreshRate = GammaWorker::DEFAULT_REFRESH_RATE;
+        return std::chrono::duration_cast<StepClock::duration>(std::chrono::seconds(1)) / refreshRate;
+    }
+
+    // Grid steps moved since the hold started repeating: the integral of the accelerating rate.
+    static int HeldSteps(const float heldMs)
+    {
+        if (heldMs <= 0.0f)
+            return 0;
+
+        const float rampMs = std::min(heldMs, HOLD_ACCEL_MS);
+        const float acceleration = (HOLD_MAX_RATE - HOLD_START_RATE) / HOLD_ACCEL_MS;
+        float steps = (HOLD_START_RATE * rampMs + 0.5f * acceleration * rampMs * rampMs) / 1000.0f;
+        if (heldMs > HOLD_ACCEL_MS)
+            steps += HOLD_MAX_RATE * (heldMs - HOLD_ACCEL_MS) / 1000.0f;
+        return (int)steps;
+    }
+
+    // Stop the hold timer, apply the exact ramp of where the hold ended and save it.
+    static void EndStepHold()
+    {
+        if (!s_hold.active)
+            return;
+
+        s_hold.active = false;
+        if (App::mainWindow)
+            KillTimer(App::mainWindow, TimerIDs::STEP_HOLD);
+
+        App::SyncGammaToState();
+        // Only the simple profile is saved; advanced mode's working profile has its own Save button.
+        if (!App::state.IsAdvancedModeEnabled())
+            ConfigManager::ScheduleSave();
+        UI::SyncUIToState();
+    }
+
+    static void StepAction(const int hotkeyId)
+    {
+        // A different step key pressed mid-hold ends that hold first.
+        EndStepHold();
+
+        // IDs come in up/down pairs, brightness first (see HotkeyIDs).
+        const int offset = hotkeyId - HotkeyIDs::BRIGHTNESS_UP;
+        s_hold.hotkeyId = hotkeyId;
+        s_hold.vk = HotkeyCode::Vk(BoundKey(hotkeyId));
+        s_hold.field = (StepField)(offset / 2);
+        s_hold.direction = (offset % 2 == 0) ? 1 : -1;
+
+        // Start from the grid point nearest the current value, which a slider may have left off-grid.
+        Profile& profile = StepProfile();
+        const StepGrid& grid = STEP_GRIDS[s_hold.field];
+        const int nearest = (int)std::lround((GetStepValue(profile, s_hold.field) - grid.origin) / grid.unit);
+        s_hold.startIndex = std::clamp(nearest + s_hold.direction, 0, grid.count);
+        s_hold.index = s_hold.startIndex;
+
+        App::state.SetGammaEnabled(true);
+        SetStepValue(profile, s_hold.field, s_hold.index);
+        ApplyStepIndex(profile, s_hold.field, s_hold.index);
+        UI::SyncUIToState();
+
+        s_hold.pressed = StepClock::now();
+        s_hold.lastApply = s_hold.pressed;
+        s_hold.frame = StepFrameTime();
+        s_hold.active = true;
+
+        // The timer's own minimum (USER_TIMER_MINIMUM) caps very high refresh rates for us.
+        const UINT intervalMs = (UINT)std::max<long long>(1,
+            std::chrono::duration_cast<std::chrono::milliseconds>(s_hold.frame).count());
+        if (!App::mainWindow || !SetTimer(App::mainWindow, TimerIDs::STEP_HOLD, intervalMs, nullptr))
+            EndStepHold(); // No timer to see the release: behave as a single press.
+    }
+
+    void OnStepTimer()
+    {
+        if (!s_hold.active)
         {
-            const int profileIndex = hotkeyId - HotkeyIDs::PROFILE_BASE;
-            App::state.SetGammaEnabled(true); // Ensure enabled when profile triggered.
-            ProfileManager::ApplyByIndex(profileIndex);
-            SyncUIWithCurrentProfile();
-            UI::SyncUIToState();
+            if (App::mainWindow)
+                KillTimer(App::mainWindow, TimerIDs::STEP_HOLD);
+            return;
+        }
+
+        // The binding may have been cleared or moved while held; treat that as a release too.
+        if (HotkeyCode::Vk(BoundKey(s_hold.hotkeyId)) != s_hold.vk || !(GetAsyncKeyState((int)s_hold.vk) & 0x8000))
+        {
+            EndStepHold();
+            return;
+        }
+
+        // Rate limit: timer messages can arrive late and back to back, but a display cannot show
+        // more than one ramp per frame.
+        const StepClock::time_point now = StepClock::now();
+        if (now - s_hold.lastApply < s_hold.frame)
+            return;
+
+        const float heldMs = std::chrono::duration<float, std::milli>(now - s_hold.pressed).count() - HOLD_DELAY_MS;
+        const int index = std::clamp(s_hold.startIndex + s_hold.direction * HeldSteps(heldMs), 0,
+                                     STEP_GRIDS[s_hold.field].count);
+        if (index == s_hold.index)
+            return;
+
+        s_hold.index = index;
+        s_hold.lastApply = now;
+        Profile& profile = StepProfile();
+        SetStepValue(profile, s_hold.field, index);
+        ApplyStepIndex(profile, s_hold.field, index);
+    }
+
+    static void ApplyProfileAction(const int hotkeyId)
+    {
+        const int profileIndex = ProfileIndex(hotkeyId);
+        if (profileIndex < 0)
+            return;
+
+        App::state.SetGammaEnabled(true); // Ensure enabled when profile triggered.
+        ProfileManager::ApplyByIndex(profileIndex);
+        SyncUIWithCurrentProfile();
+        UI::SyncUIToState();
+    }
+
+    void HandleHotkey(const int hotkeyId)
+    {
+        // Close any open context menus (e.g. the system tray menu) so a hotkey press
+        // while the menu is open doesn't leave it stuck open.
+        if (App::mainWindow)
+        {
+            SendMessage(App::mainWindow, WM_CANCELMODE, 0, 0);
         }
+
+        if (hotkeyId <= 0 || hotkeyId >= (int)s_actions.size())
+            return;
+
+        const Action action = s_actions[hotkeyId]; // A copy: the handler may rebuild the table.
+        if (action.handler)
+            action.handler(action.argument);
     }
 }
@@ -6,10 +6,29 @@
  * Hotkeys use the Win32 RegisterHotKey() API.
  *
  * HOW IT WORKS:
- * - RegisterHotKey() registers each bound key as a system-wide hotkey.
+ * - RegisterHotKey() registers each bound key, with any Ctrl/Alt/Shift/Win modifiers, as a
+ *   system-wide hotkey. A binding is a HotkeyCode (see GammaHotkeyTypes.h).
  * - When pressed, Windows posts a WM_HOTKEY message to our window, which WndProc dispatches.
  * - Registrations use MOD_NOREPEAT so holding a key does not fire repeatedly.
  *
+ * PROFILE IDS:
+ * A profile's hotkey ID comes from Profile::id, which ProfileManager assigns once and which does
+ * not change when profiles are reordered or others are deleted. Refresh compares the bindings
+ * with what is registered by ID, so reordering a list of bound profiles makes no Win32 calls, and
+ * deleting one makes a single UnregisterHotKey.
+ *
+ * STEP HOTKEYS:
+ * Six global hotkeys nudge the brightness, contrast or gamma of the profile the current mode applies
+ * (Advanced: the working profile, Simple: the simple profile), speeding up while held. WM_HOTKEY
+ * only reports the press, so a timer on the main window (TimerIDs::STEP_HOLD) watches for the
+ * release, paced to the display's refresh rate so a hold never applies more than once a frame.
+ * The config is saved once, on release.
+ *
+ * BINDING INDEX:
+ * Refresh also rebuilds two tables from the bindings: one from key combination to hotkey ID
+ * (FindAction, used by the capture dialog to spot conflicts) and one from hotkey ID to the action
+ * it runs (HandleHotkey). Both are a single array lookup, however many profiles there are.
+ *
  * WHY NOT A LOW-LEVEL KEYBOARD HOOK:
  * - A WH_KEYBOARD_LL hook sees every keystroke system-wide, which is the classic keylogger
  *   signature and a common cause of antivirus false positives.
@@ -26,13 +45,28 @@
 namespace HotkeyManager
 {
     /**
-     * @brief Register all hotkeys with Windows.
+     * @brief Register all hotkeys with Windows, unregistering any registered first.
+     *
+     * For start-up and for resuming after UnregisterAll. After a change to the bindings, Refresh
+     * does the same work with only the calls the change needs.
+     *
      * @param hwnd Window handle that will receive WM_HOTKEY messages.
      */
     void RegisterAll(const HWND hwnd);
 
+    /**
+     * @brief Bring the registered hotkeys in line with the current bindings.
+     *
+     * Unregisters and registers only the hotkeys whose key changed (or that were added or
+     * removed), leaving the rest registered. A key that failed to register earlier is tried again.
+     *
+     * @param hwnd Window handle that will receive WM_HOTKEY messages.
+     */
+    void Refresh(const HWND hwnd);
+
     /**
      * @brief Unregister all hotkeys.
+     * @note Also stops a step hotkey hold in progress, leaving the value where it got to.
      * @param hwnd Window handle that registered the hotkeys.
      */
     void UnregisterAll(const HWND hwnd);
@@ -44,14 +78,40 @@ namespace HotkeyManager
     void HandleHotkey(const int hotkeyId);
 
     /**
-     * @brief Whether a virtual-key can be bound as a hotkey.
+     * @brief Advance a held step hotkey, dispatched from WM_TIMER for TimerIDs::STEP_HOLD.
+     *
+     * Moves the value on at most once per display frame, and finishes the hold (exact apply, one
+     * save) once the key is released.
+     */
+    void OnStepTimer();
+
+    /**
+     * @brief The hotkey ID a key combination is bound to. O(1).
+     *
+     * Reflects the settings as of the last Refresh; an entry that no longer matches them makes the
+     * index rebuild itself. Of two actions bound to the same combination, returns the lower ID.
+     *
+     * @param hotkey HotkeyCode to look up.
+     * @return The hotkey ID (see HotkeyIDs), or 0 if nothing is bound to it.
+     */
+    int FindAction(const UINT hotkey);
+
+    /**
+     * @brief Where the profile a hotkey ID belongs to sits in App::profiles. O(1).
+     * @param hotkeyId A profile hotkey ID (PROFILE_BASE + Profile::id).
+     * @return Index in App::profiles, or -1 if no profile has that ID (or hotkeyId is not a profile's).
+     */
+    int ProfileIndex(const int hotkeyId);
+
+    /**
+     * @brief Whether a key combination can be bound as a hotkey.
      *
      * Rejects bare modifier keys (which RegisterHotKey cannot fire on) and F12
      * (reserved by Windows). Use reasonForRejection to show the user why, if non-null.
      *
-     * @param vk Virtual-key code to validate.
+     * @param hotkey HotkeyCode to validate.
      * @param[out] reasonForRejection Optional. Set to a short explanation when the key is not bindable.
      * @return true if the key can be bound as a hotkey.
      */
-    bool IsBindableKey(const UINT vk, const char** reasonForRejection = nullptr);
+    bool IsBindableKey(const UINT hotkey, const char** reasonForRejection = nullptr);
 }
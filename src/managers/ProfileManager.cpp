@@ -4,26 +4,95 @@
 #include "ProfileManager.h"
 #include "AppGlobals.h"
 #include "GammaManager.h"
+#include "ProfileNameIndex.h"
 
 namespace ProfileManager
 {
+    // Last profile ID handed out. Profile IDs become hotkey IDs, which RegisterHotKey caps.
+    static int s_lastId = 0;
+    static constexpr int MAX_ID = HotkeyIDs::MAX - HotkeyIDs::PROFILE_BASE;
+
+    static int NextId()
+    {
+        // Out of IDs after a long session of adds and reloads: number the list again from 1. Every
+        // profile hotkey is registered afresh once, instead of new ones failing to register.
+        if (s_lastId >= MAX_ID && (int)App::profiles.size() < MAX_ID)
+        {
+            s_lastId = 0;
+            for (Profile& profile : App::profiles)
+                profile.id = ++s_lastId;
+        }
+        return ++s_lastId;
+    }
+
     int FindByName(const std::wstring& name)
     {
-        for (size_t i = 0; i < App::profiles.size(); ++i)
+        return App::profileNames.Find(name);
+    }
+
+    int AddProfile(const Profile& profile)
+    {
+        App::profiles.push_back(profile);
+        const int index = (int)App::profiles.size() - 1;
+        App::profiles[index].id = NextId(); // profile may be a copy of another (e.g. workingProfile).
+        App::profileNames.Add(index);
+        return index;
+    }
+
+    void AssignIds(const std::vector<Profile>& previous)
+    {
+        if (!previous.empty())
+        {
+            ProfileNameIndex previousNames(previous);
+            previousNames.Rebuild();
+            for (Profile& profile : App::profiles)
+            {
+                const int slot = profile.id == 0 ? previousNames.Find(profile.name) : -1;
+                if (slot >= 0)
+                    profile.id = previous[slot].id;
+            }
+        }
+
+        for (Profile& profile : App::profiles)
         {
-            if (_wcsicmp(App::profiles[i].name.c_str(), name.c_str()) == 0)
-                return (int)i;
+            if (profile.id == 0)
+                profile.id = NextId();
         }
-        return -1;
+    }
+
+    void RenameProfile(const int index, const std::wstring& name)
+    {
+        if (index < 0 || index >= (int)App::profiles.size())
+            return;
+
+        const std::wstring oldName = std::move(App::profiles[index].name);
+        App::profiles[index].name = name;
+        App::profileNames.Rename(index, oldName);
+    }
+
+    void SwapProfiles(const int a, const int b)
+    {
+        if (a < 0 || b < 0 || a >= (int)App::profiles.size() || b >= (int)App::profiles.size() || a == b)
+            return;
+
+        std::swap(App::profiles[a], App::profiles[b]);
+        App::profileNames.Swap(a, b);
+
+        if (App::selectedProfileIndex == a)
+            App::selectedProfileIndex = b;
+        else if (App::selectedProfileIndex == b)
+            App::selectedProfileIndex = a;
     }
     
-    void ApplyByIndex(const int index)
+    void ApplyByIndex(const int index, const int transitionMs)
     {
         if (index < 0 || index >= (int)App::profiles.size()) return;
 
         App::workingProfile = App::profiles[index];
         App::selectedProfileIndex = index;
-        GammaManager::ApplyProfile(App::workingProfile, App::selectedDisplayIndex);
+
+        // Switching profiles (hotkeys, cycling) fades when the user asked for it; slider edits elsewhere stay instant.
+        GammaManager::ApplyProfile(App::workingProfile, App::selectedDisplayIndex, transitionMs >= 0 ? transitionMs : App::transitionMs);
     }
     
     bool ApplyByName(const std::wstring& name)
@@ -72,6 +141,7 @@ namespace ProfileManager
             return;
         
         App::profiles.erase(App::profiles.begin() + index);
+        App::profileNames.Rebuild(); // Every later slot moved down; as cheap as the erase itself.
         
         // Update selected profile index if needed.
         if (App::selectedProfileIndex == index)
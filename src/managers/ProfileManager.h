@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include "GammaHotkeyTypes.h"
 #include <string>
+#include <vector>
 
 namespace ProfileManager
 {
@@ -14,12 +16,38 @@ namespace ProfileManager
      * @return Index in App::profiles vector, or -1 if not found.
      */
     int FindByName(const std::wstring& name);
+
+    /**
+     * @brief Append a profile, with a new ID. The caller makes sure its name is not taken (see FindByName).
+     * @return Index of the new profile in App::profiles.
+     */
+    int AddProfile(const Profile& profile);
+
+    /**
+     * @brief Give every profile in App::profiles without an ID (Profile::id == 0) a new one.
+     * @param[in] previous The list App::profiles replaced, if any (a reload). A profile with the
+     *            same name as one in it takes that profile's ID, so its hotkey stays registered.
+     */
+    void AssignIds(const std::vector<Profile>& previous = {});
+
+    /**
+     * @brief Rename a profile. The caller makes sure the new name is not taken by another profile.
+     * @param[in] index Index in App::profiles vector.
+     */
+    void RenameProfile(const int index, const std::wstring& name);
+
+    /**
+     * @brief Swap two profiles in the list (a reorder), keeping the selection on the same profile.
+     * @param[in] a, b Indices in App::profiles vector.
+     */
+    void SwapProfiles(const int a, const int b);
     
     /**
      * @brief Apply a profile by its index.
      * @param[in] index Index in App::profiles vector.
+     * @param[in] transitionMs Fade length, or -1 for App::transitionMs.
      */
-    void ApplyByIndex(const int index);
+    void ApplyByIndex(const int index, const int transitionMs = -1);
     
     /**
      * @brief Apply a profile by its name.
@@ -116,8 +116,9 @@ namespace SystemTrayManager
         // Append hotkey if one is set.
         if (App::toggleHotkey != 0)
         {
-            std::wstring hotkeyName = StringUtils::VkToName(App::toggleHotkey);
-            toggleText += L" (" + hotkeyName + L")";
+            char hotkeyName[StringUtils::HOTKEY_NAME_SIZE];
+            StringUtils::HotkeyToName(App::toggleHotkey, hotkeyName, sizeof(hotkeyName));
+            toggleText += L" (" + StringUtils::UTF8ToWide(hotkeyName) + L")";
         }
 
         AppendMenu(hMenu, MF_STRING, SystemTrayIDs::ID_TOGGLE, toggleText.c_str());
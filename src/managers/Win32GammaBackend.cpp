@@ -0,0 +1,136 @@
+// Copyright (c) 2025 Max Godman
+
+#include "framework.h"
+#include "Win32GammaBackend.h"
+
+static_assert(sizeof(WORD) == sizeof(uint16_t), "WORD must be 16-bit.");
+
+// Windows narrows the ramps SetDeviceGammaRamp accepts by GdiIcmGammaRange (see RampPreflight). It is
+// machine-wide and only changed by hand or by installers, so one read per enumeration is plenty.
+static RampPreflight::Limits ReadRampLimits()
+{
+    RampPreflight::Limits limits;
+
+    DWORD range = 0;
+    DWORD size = sizeof(range);
+    if (RegGetValueW(HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion\\ICM",
+                     L"GdiIcmGammaRange", RRF_RT_REG_DWORD, NULL, &range, &size) == ERROR_SUCCESS)
+    {
+        limits.maxDeviation = (int)std::min<DWORD>(range, RampPreflight::UNLIMITED_DEVIATION);
+    }
+    return limits;
+}
+
+Win32GammaBackend::~Win32GammaBackend()
+{
+    Release();
+}
+
+std::vector<GammaDisplayInfo> Win32GammaBackend::Enumerate()
+{
+    Release();
+
+    std::vector<GammaDisplayInfo> displays;
+    m_rampLimits = ReadRampLimits();
+
+    DISPLAY_DEVICE ddAdapter = {};
+    ddAdapter.cb = sizeof(ddAdapter);
+    DISPLAY_DEVICE ddDisplay = {};
+    ddDisplay.cb = sizeof(ddDisplay);
+
+    for (DWORD adapterIndex = 0; EnumDisplayDevices(NULL, adapterIndex, &ddAdapter, 0); ++adapterIndex)
+    {
+        if (!(ddAdapter.StateFlags & DISPLAY_DEVICE_ACTIVE))
+            continue;
+
+        for (DWORD displayIndex = 0; EnumDisplayDevices(ddAdapter.DeviceName, displayIndex, &ddDisplay, 0); ++displayIndex)
+        {
+            if (!(ddDisplay.StateFlags & DISPLAY_DEVICE_ACTIVE))
+                continue;
+
+            GammaDisplayInfo info;
+            info.deviceName = ddAdapter.DeviceName;
+            // Display first, then GPU, separated by |
+            info.friendlyName = std::wstring(ddDisplay.DeviceString) + L" | " +
+                                std::wstring(ddAdapter.DeviceString);
+            displays.push_back(info);
+
+            // May be NULL; writes to this display then fail as they did when CreateDC failed per call.
+            m_deviceContexts.push_back(CreateDC(NULL, info.deviceName.c_str(), NULL, NULL));
+            m_deviceNames.push_back(info.deviceName);
+
+            // A mode change that alters the rate arrives as WM_DISPLAYCHANGE, which re-enumerates.
+            // 0 and 1 both mean "hardware default", i.e. unknown.
+            DEVMODE mode = {};
+            mode.dmSize = sizeof(mode);
+            const bool haveRate = EnumDisplaySettings(ddAdapter.DeviceName, ENUM_CURRENT_SETTINGS, &mode) &&
+                                  mode.dmDisplayFrequency > 1;
+            m_refreshRates.push_back(haveRate ? (int)mode.dmDisplayFrequency : 0);
+        }
+    }
+
+    return displays;
+}
+
+void Win32GammaBackend::Release()
+{
+    for (const HDC hdc : m_deviceContexts)
+    {
+        if (hdc)
+            DeleteDC(hdc);
+    }
+    m_deviceContexts.clear();
+    m_deviceNames.clear();
+    m_refreshRates.clear();
+}
+
+int Win32GammaBackend::GetRampSize(const int displayIndex)
+{
+    // GDI gamma ramps are always 3 x 256 WORDs, whatever the hardware's real LUT depth.
+    if (displayIndex < 0 || displayIndex >= (int)m_deviceNames.size())
+        return 0;
+    return GammaConstants::RAMP_SIZE;
+}
+
+int Win32GammaBackend::GetRefreshRate(const int displayIndex)
+{
+    if (displayIndex < 0 || displayIndex >= (int)m_refreshRates.size())
+        return 0;
+    return m_refreshRates[displayIndex];
+}
+
+RampPreflight::Limits Win32GammaBackend::GetRampLimits(const int displayIndex)
+{
+    if (displayIndex < 0 || displayIndex >= (int)m_deviceNames.size())
+        return RampPreflight::Limits();
+    return m_rampLimits;
+}
+
+bool Win32GammaBackend::ReadRamp(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE])
+{
+    if (displayIndex < 0 || displayIndex >= (int)m_deviceNames.size())
+        return false;
+
+    // Reads come from the UI thread while the display's worker may be writing through the cached
+    // context, so use a context of our own rather than share one across threads. Reads are rare.
+    const HDC hdc = CreateDC(NULL, m_deviceNames[displayIndex].c_str(), NULL, NULL);
+    if (!hdc)
+        return false;
+
+    const BOOL success = GetDeviceGammaRamp(hdc, ramp);
+    DeleteDC(hdc);
+    return success != FALSE;
+}
+
+bool Win32GammaBackend::WriteRamp(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE])
+{
+    if (displayIndex < 0 || displayIndex >= (int)m_deviceContexts.size())
+        return false;
+
+    const HDC hdc = m_deviceContexts[displayIndex];
+    if (!hdc)
+        return false;
+
+    // SetDeviceGammaRamp takes a non-const LPVOID but only reads the ramp.
+    return SetDeviceGammaRamp(hdc, const_cast<uint16_t(*)[RampEngine::RAMP_SIZE]>(ramp)) != FALSE;
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2025 Max Godman
+
+// The real gamma backend: GDI display enumeration and Get/SetDeviceGammaRamp.
+
+#pragma once
+
+#include "GammaBackend.h"
+#include "GammaHotkeyTypes.h"
+
+class Win32GammaBackend : public GammaBackend
+{
+public:
+    ~Win32GammaBackend() override;
+
+    std::vector<GammaDisplayInfo> Enumerate() override;
+    void Release() override;
+    int GetRampSize(const int displayIndex) override;
+    int GetRefreshRate(const int displayIndex) override;
+    RampPreflight::Limits GetRampLimits(const int displayIndex) override;
+    bool ReadRamp(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]) override;
+    bool WriteRamp(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE]) override;
+
+private:
+    // One context per enumerated display, kept until the next enumeration. CreateDC + DeleteDC on
+    // every apply was a large share of its cost, and a display's device name cannot change without
+    // a WM_DISPLAYCHANGE, which re-enumerates and rebuilds these. NULL where CreateDC failed.
+    std::vector<HDC> m_deviceContexts;
+    std::vector<std::wstring> m_deviceNames;
+    std::vector<int> m_refreshRates; // Hz at enumeration time, 0 if unknown.
+    RampPreflight::Limits m_rampLimits; // Machine-wide, read from the registry at enumeration time.
+};
@@ -7,6 +7,7 @@
 #include "imgui.h"
 #include "imgui_impl_win32.h"
 #include "imgui_impl_dx11.h"
+#include <cassert>
 #include <d3d11.h>
 #pragma comment(lib, "d3d11.lib")
 
@@ -111,6 +112,18 @@ void ImGuiRenderer::Render()
     m_pSwapChain->Present(1, 0);
 }
 
+int ImGuiRenderer::GetAnimationDelayMs() const
+{
+    // A focused text field only has its caret to blink; a few frames per blink period is plenty.
+    static constexpr int CARET_FRAME_MS = 200;
+
+    if (ImGui::GetIO().WantTextInput)
+        return CARET_FRAME_MS;
+    if (ImGui::IsAnyItemActive())
+        return 0; // A slider or button is held: keep every frame, as before.
+    return -1;
+}
+
 void ImGuiRenderer::OnResize(const int width, const int height)
 {
     if (m_pd3dDevice == nullptr)
@@ -205,8 +218,24 @@ void ImGuiRenderer::CleanupDeviceD3D()
 {
     CleanupRenderTarget();
     if (m_pSwapChain) { m_pSwapChain->Release(); m_pSwapChain = nullptr; }
-    if (m_pd3dDeviceContext) { m_pd3dDeviceContext->Release(); m_pd3dDeviceContext = nullptr; }
-    if (m_pd3dDevice) { m_pd3dDevice->Release(); m_pd3dDevice = nullptr; }
+    if (m_pd3dDeviceContext)
+    {
+        // Unbind everything and submit what is queued, so the context holds no reference to the
+        // device's objects and its deferred destruction runs now rather than at some later flush.
+        m_pd3dDeviceContext->ClearState();
+        m_pd3dDeviceContext->Flush();
+        m_pd3dDeviceContext->Release();
+        m_pd3dDeviceContext = nullptr;
+    }
+    if (m_pd3dDevice)
+    {
+        // The renderer is released and created again each time the window stays hidden (see main.cpp),
+        // so anything still holding the device now would pile up over a session.
+        const ULONG references = m_pd3dDevice->Release();
+        assert(references == 0); // D3D11 device still referenced after shutdown.
+        (void)references;
+        m_pd3dDevice = nullptr;
+    }
 }
 
 void ImGuiRenderer::CreateRenderTarget()
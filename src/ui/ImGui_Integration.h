@@ -27,6 +27,13 @@ public:
     // Frame management.
     void NewFrame();
     void Render();
+
+    /**
+     * @brief How soon the UI needs another frame without any input, after the frame just rendered.
+     * @return 0 for the next vsync (a widget is held), a delay in ms (a text caret blinking), or -1
+     *         if nothing on screen moves by itself.
+     */
+    int GetAnimationDelayMs() const;
     
     /**
      * @brief Check if initialized.
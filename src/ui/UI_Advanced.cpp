@@ -38,10 +38,8 @@ static void RenderHotkeyDisplay(const char* label, const char* id, UINT hotkey,
     // Input at fixed position from start.
     ImGui::SameLine(labelWidth + ImGui::GetStyle().WindowPadding.x);
 
-    std::string keyName = StringUtils::WideToUTF8(StringUtils::VkToName(hotkey));
-    char buf[64];
-    strncpy_s(buf, keyName.c_str(), sizeof(buf) - 1);
-    buf[sizeof(buf) - 1] = '\0';
+    char buf[StringUtils::HOTKEY_NAME_SIZE];
+    StringUtils::HotkeyToName(hotkey, buf, sizeof(buf));
 
     ImGui::BeginDisabled();
     ImGui::SetNextItemWidth(inputWidth);
@@ -70,9 +68,8 @@ static void SelectProfile(int index)
 
     if (App::profiles[index].hotkey != 0)
     {
-        strncpy_s(UI::state.profileHotkeyBuffer, sizeof(UI::state.profileHotkeyBuffer),
-            StringUtils::WideToUTF8(StringUtils::VkToName(App::profiles[index].hotkey)).c_str(),
-            _TRUNCATE);
+        StringUtils::HotkeyToName(App::profiles[index].hotkey, UI::state.profileHotkeyBuffer,
+            sizeof(UI::state.profileHotkeyBuffer));
     }
     else
     {
@@ -86,30 +83,20 @@ static void MoveProfileUp(int index)
 {
     if (index <= 0) return;
 
-    std::swap(App::profiles[index], App::profiles[index - 1]);
+    ProfileManager::SwapProfiles(index, index - 1);
 
-    if (App::selectedProfileIndex == index)
-        App::selectedProfileIndex = index - 1;
-    else if (App::selectedProfileIndex == index - 1)
-        App::selectedProfileIndex = index;
-
-    ConfigManager::Save();
-    HotkeyManager::RegisterAll(App::mainWindow);
+    ConfigManager::ScheduleSave();
+    HotkeyManager::Refresh(App::mainWindow);
 }
 
 static void MoveProfileDown(int index)
 {
     if (index >= (int)App::profiles.size() - 1) return;
 
-    std::swap(App::profiles[index], App::profiles[index + 1]);
-
-    if (App::selectedProfileIndex == index)
-        App::selectedProfileIndex = index + 1;
-    else if (App::selectedProfileIndex == index + 1)
-        App::selectedProfileIndex = index;
+    ProfileManager::SwapProfiles(index, index + 1);
 
-    ConfigManager::Save();
-    HotkeyManager::RegisterAll(App::mainWindow);
+    ConfigManager::ScheduleSave();
+    HotkeyManager::Refresh(App::mainWindow);
 }
 
 void RenderAdvancedUI()
@@ -249,17 +236,18 @@ void RenderAdvancedUI()
 
                 if (idx >= 0)
                 {
+                    const int id = App::profiles[idx].id; // workingProfile may be a copy of another profile.
                     App::profiles[idx] = App::workingProfile;
+                    App::profiles[idx].id = id;
                     App::selectedProfileIndex = idx;
                 }
                 else
                 {
-                    App::profiles.push_back(App::workingProfile);
-                    App::selectedProfileIndex = (int)App::profiles.size() - 1;
+                    App::selectedProfileIndex = ProfileManager::AddProfile(App::workingProfile);
                 }
 
-                ConfigManager::Save();
-                HotkeyManager::RegisterAll(App::mainWindow);
+                ConfigManager::ScheduleSave();
+                HotkeyManager::Refresh(App::mainWindow);
             }
             ImGui::EndDisabled();
 
@@ -285,158 +273,167 @@ void RenderAdvancedUI()
             // Profile list.
             if (ImGui::BeginChild("ProfileList", ImVec2(0, 200.0f * dpiScale), ImGuiChildFlags_Borders))
             {
-                for (int i = 0; i < (int)App::profiles.size(); ++i)
+                // Only the rows in view are laid out, so a long list costs no more per frame than a
+                // short one. Every row is one line high, which is what the clipper assumes.
+                ImGuiListClipper clipper;
+                clipper.Begin((int)App::profiles.size());
+                while (clipper.Step())
                 {
-                    ImGui::PushID(i);
-
-                    const bool selected = (App::selectedProfileIndex == i);
-                    const bool renaming = (UI::state.renamingProfileIndex == i);
-
-                    if (renaming)
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
                     {
-                        ImGui::SetNextItemWidth(-1);
+                        ImGui::PushID(i);
 
-                        ImGuiInputTextFlags flags = ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll;
+                        const bool selected = (App::selectedProfileIndex == i);
+                        const bool renaming = (UI::state.renamingProfileIndex == i);
 
-                        if (UI::state.renameNeedsFocus)
+                        if (renaming)
                         {
-                            ImGui::SetKeyboardFocusHere();
-                            UI::state.renameNeedsFocus = false;
-                        }
-
-                        const bool commitRename = ImGui::InputText("##rename", UI::state.renameBuffer,
-                            sizeof(UI::state.renameBuffer), flags);
+                            ImGui::SetNextItemWidth(-1);
 
-                        const bool cancelRename = ImGui::IsKeyPressed(ImGuiKey_Escape);
-                        const bool lostFocus = !ImGui::IsItemFocused() && !UI::state.renameNeedsFocus;
+                            ImGuiInputTextFlags flags = ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_AutoSelectAll;
 
-                        if (commitRename || (lostFocus && !cancelRename))
-                        {
-                            if (UI::state.renameBuffer[0] != '\0')
+                            if (UI::state.renameNeedsFocus)
                             {
-                                const std::wstring newName = StringUtils::UTF8ToWide(UI::state.renameBuffer);
-                                const int existing = ProfileManager::FindByName(newName);
+                                ImGui::SetKeyboardFocusHere();
+                                UI::state.renameNeedsFocus = false;
+                            }
 
-                                if (existing >= 0 && existing != i)
+                            const bool commitRename = ImGui::InputText("##rename", UI::state.renameBuffer,
+                                sizeof(UI::state.renameBuffer), flags);
+
+                            const bool cancelRename = ImGui::IsKeyPressed(ImGuiKey_Escape);
+                            const bool lostFocus = !ImGui::IsItemFocused() && !UI::state.renameNeedsFocus;
+
+                            if (commitRename || (lostFocus && !cancelRename))
+                            {
+                                if (UI::state.renameBuffer[0] != '\0')
                                 {
-                                    // Another profile already uses this name. Applying it would
-                                    // create a duplicate that gets silently dropped on next load.
-                                    // On Enter, keep editing so the user can pick another name;
-                                    // on lost focus, abandon the rename and keep the original name.
-                                    if (!commitRename)
+                                    const std::wstring newName = StringUtils::UTF8ToWide(UI::state.renameBuffer);
+                                    const int existing = ProfileManager::FindByName(newName);
+
+                                    if (existing >= 0 && existing != i)
+                                    {
+                                        // Another profile already uses this name. Applying it would
+                                        // create a duplicate that gets silently dropped on next load.
+                                        // On Enter, keep editing so the user can pick another name;
+                                        // on lost focus, abandon the rename and keep the original name.
+                                        if (!commitRename)
+                                            UI::state.renamingProfileIndex = -1;
+                                    }
+                                    else
+                                    {
+                                        ProfileManager::RenameProfile(i, newName);
+                                        if (selected)
+                                        {
+                                            App::workingProfile.name = App::profiles[i].name;
+                                            strncpy_s(UI::state.profileNameBuffer, sizeof(UI::state.profileNameBuffer),
+                                                UI::state.renameBuffer, _TRUNCATE);
+                                        }
+                                        ConfigManager::ScheduleSave();
                                         UI::state.renamingProfileIndex = -1;
+                                    }
                                 }
                                 else
                                 {
-                                    App::profiles[i].name = newName;
-                                    if (selected)
-                                    {
-                                        App::workingProfile.name = App::profiles[i].name;
-                                        strncpy_s(UI::state.profileNameBuffer, sizeof(UI::state.profileNameBuffer),
-                                            UI::state.renameBuffer, _TRUNCATE);
-                                    }
-                                    ConfigManager::Save();
                                     UI::state.renamingProfileIndex = -1;
                                 }
                             }
-                            else
+                            else if (cancelRename)
                             {
                                 UI::state.renamingProfileIndex = -1;
                             }
                         }
-                        else if (cancelRename)
-                        {
-                            UI::state.renamingProfileIndex = -1;
-                        }
-                    }
-                    else
-                    {
-                        std::string display = StringUtils::WideToUTF8(App::profiles[i].name);
-                        if (App::profiles[i].hotkey != 0)
+                        else
                         {
-                            display += "  -  " + StringUtils::WideToUTF8(StringUtils::VkToName(App::profiles[i].hotkey));
-                        }
+                            std::string display = StringUtils::WideToUTF8(App::profiles[i].name);
+                            if (App::profiles[i].hotkey != 0)
+                            {
+                                char hotkeyName[StringUtils::HOTKEY_NAME_SIZE];
+                                StringUtils::HotkeyToName(App::profiles[i].hotkey, hotkeyName, sizeof(hotkeyName));
+                                display.append("  -  ").append(hotkeyName);
+                            }
 
-                        // Store item position before drawing.
-                        const ImVec2 itemPos = ImGui::GetCursorScreenPos();
-                        const float itemHeight = ImGui::GetTextLineHeightWithSpacing();
-                        const float fullWidth = ImGui::GetContentRegionAvail().x;
+                            // Store item position before drawing.
+                            const ImVec2 itemPos = ImGui::GetCursorScreenPos();
+                            const float itemHeight = ImGui::GetTextLineHeightWithSpacing();
+                            const float fullWidth = ImGui::GetContentRegionAvail().x;
 
-                        // Check if row is hovered before drawing anything.
-                        const ImVec2 rowMin = itemPos;
-                        const ImVec2 rowMax = ImVec2(itemPos.x + fullWidth, itemPos.y + itemHeight);
-                        const bool rowHovered = ImGui::IsMouseHoveringRect(rowMin, rowMax);
+                            // Check if row is hovered before drawing anything.
+                            const ImVec2 rowMin = itemPos;
+                            const ImVec2 rowMax = ImVec2(itemPos.x + fullWidth, itemPos.y + itemHeight);
+                            const bool rowHovered = ImGui::IsMouseHoveringRect(rowMin, rowMax);
 
-                        // Draw selectable at full width, but use AllowOverlap so buttons can receive clicks.
-                        const ImGuiSelectableFlags selectableFlags = ImGuiSelectableFlags_AllowDoubleClick | ImGuiSelectableFlags_AllowOverlap;
-                        if (ImGui::Selectable(display.c_str(), selected, selectableFlags, ImVec2(0, 0)))
-                        {
-                            // Handle single click selection.
-                            if (!ImGui::IsMouseDoubleClicked(0))
+                            // Draw selectable at full width, but use AllowOverlap so buttons can receive clicks.
+                            const ImGuiSelectableFlags selectableFlags = ImGuiSelectableFlags_AllowDoubleClick | ImGuiSelectableFlags_AllowOverlap;
+                            if (ImGui::Selectable(display.c_str(), selected, selectableFlags, ImVec2(0, 0)))
                             {
-                                SelectProfile(i);
+                                // Handle single click selection.
+                                if (!ImGui::IsMouseDoubleClicked(0))
+                                {
+                                    SelectProfile(i);
+                                }
                             }
-                        }
 
-                        // Check for double-click to rename.
-                        if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0))
-                        {
-                            UI::state.renamingProfileIndex = i;
-                            strncpy_s(UI::state.renameBuffer, sizeof(UI::state.renameBuffer),
-                                StringUtils::WideToUTF8(App::profiles[i].name).c_str(), _TRUNCATE);
-                            UI::state.renameNeedsFocus = true;
-                        }
-
-                        // Draw overlay buttons when row is hovered.
-                        if (rowHovered)
-                        {
-                            // Right-align the up/down/delete cluster by measuring it rather than
-                            // reserving a fixed width, which under-reserves once the glyphs and
-                            // frame padding scale and pushes the buttons off the row. All three
-                            // labels are single characters in a monospace font, so one measurement
-                            // covers each of them.
-                            const float overlayGap = 2.0f * dpiScale;
-                            const float overlayButtonWidth = ImGui::CalcTextSize("X").x +
-                                ImGui::GetStyle().FramePadding.x * 2.0f;
-                            const float overlayWidth = overlayButtonWidth * 3.0f + overlayGap * 2.0f;
-
-                            ImGui::SameLine(fullWidth - overlayWidth);
-
-                            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.2f, 0.8f));
-                            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.3f, 0.3f, 1.0f));
-                            ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
-
-                            ImGui::BeginDisabled(i == 0);
-                            if (ImGui::SmallButton("^##up"))
+                            // Check for double-click to rename.
+                            if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0))
                             {
-                                MoveProfileUp(i);
+                                UI::state.renamingProfileIndex = i;
+                                strncpy_s(UI::state.renameBuffer, sizeof(UI::state.renameBuffer),
+                                    StringUtils::WideToUTF8(App::profiles[i].name).c_str(), _TRUNCATE);
+                                UI::state.renameNeedsFocus = true;
                             }
-                            ImGui::EndDisabled();
 
-                            ImGui::SameLine(0, overlayGap);
-
-                            ImGui::BeginDisabled(i >= (int)App::profiles.size() - 1);
-                            if (ImGui::SmallButton("v##down"))
+                            // Draw overlay buttons when row is hovered.
+                            if (rowHovered)
                             {
-                                MoveProfileDown(i);
-                            }
-                            ImGui::EndDisabled();
+                                // Right-align the up/down/delete cluster by measuring it rather than
+                                // reserving a fixed width, which under-reserves once the glyphs and
+                                // frame padding scale and pushes the buttons off the row. All three
+                                // labels are single characters in a monospace font, so one measurement
+                                // covers each of them.
+                                const float overlayGap = 2.0f * dpiScale;
+                                const float overlayButtonWidth = ImGui::CalcTextSize("X").x +
+                                    ImGui::GetStyle().FramePadding.x * 2.0f;
+                                const float overlayWidth = overlayButtonWidth * 3.0f + overlayGap * 2.0f;
+
+                                ImGui::SameLine(fullWidth - overlayWidth);
+
+                                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.2f, 0.8f));
+                                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.3f, 0.3f, 1.0f));
+                                ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
+
+                                ImGui::BeginDisabled(i == 0);
+                                if (ImGui::SmallButton("^##up"))
+                                {
+                                    MoveProfileUp(i);
+                                }
+                                ImGui::EndDisabled();
 
-                            ImGui::SameLine(0, overlayGap);
+                                ImGui::SameLine(0, overlayGap);
 
-                            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
-                            if (ImGui::SmallButton("X##delete"))
-                            {
-                                UI::state.deleteProfileIndex = i;
-                                UI::state.showDeleteConfirm = true;
-                            }
-                            ImGui::PopStyleColor(); // Delete button hover color.
+                                ImGui::BeginDisabled(i >= (int)App::profiles.size() - 1);
+                                if (ImGui::SmallButton("v##down"))
+                                {
+                                    MoveProfileDown(i);
+                                }
+                                ImGui::EndDisabled();
 
-                            ImGui::PopStyleColor(3); // Button colors.
+                                ImGui::SameLine(0, overlayGap);
+
+                                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.9f, 0.2f, 0.2f, 1.0f));
+                                if (ImGui::SmallButton("X##delete"))
+                                {
+                                    UI::state.deleteProfileIndex = i;
+                                    UI::state.showDeleteConfirm = true;
+                                }
+                                ImGui::PopStyleColor(); // Delete button hover color.
+
+                                ImGui::PopStyleColor(3); // Button colors.
+                            }
                         }
-                    }
 
-                    ImGui::PopID();
+                        ImGui::PopID();
+                    }
                 }
             }
             ImGui::EndChild(); // ProfileList.
@@ -493,7 +490,40 @@ void RenderAdvancedUI()
             }
             if (ImGui::IsItemDeactivatedAfterEdit())
             {
-                ConfigManager::Save();
+                ConfigManager::ScheduleSave();
+            }
+
+            // Six more rows would crowd out the curve preview, so they start collapsed.
+            if (ImGui::CollapsingHeader("Step Hotkeys"))
+            {
+                struct StepRow
+                {
+                    const char* label;
+                    const char* id;
+                    UINT hotkey;
+                    HotkeyCapture captureType;
+                };
+                const StepRow rows[] = {
+                    { "Brightness Up:", "##BrightnessUpHotkey", App::brightnessUpHotkey, HotkeyCapture::BRIGHTNESS_UP },
+                    { "Brightness Down:", "##BrightnessDownHotkey", App::brightnessDownHotkey, HotkeyCapture::BRIGHTNESS_DOWN },
+                    { "Contrast Up:", "##ContrastUpHotkey", App::contrastUpHotkey, HotkeyCapture::CONTRAST_UP },
+                    { "Contrast Down:", "##ContrastDownHotkey", App::contrastDownHotkey, HotkeyCapture::CONTRAST_DOWN },
+                    { "Gamma Up:", "##GammaUpHotkey", App::gammaUpHotkey, HotkeyCapture::GAMMA_UP },
+                    { "Gamma Down:", "##GammaDownHotkey", App::gammaDownHotkey, HotkeyCapture::GAMMA_DOWN },
+                };
+
+                float stepLabelWidth = hotkeyLabelWidth;
+                for (const StepRow& row : rows)
+                    stepLabelWidth = ImMax(stepLabelWidth, ImGui::CalcTextSize(row.label).x + ImGui::GetStyle().ItemSpacing.x);
+
+                for (const StepRow& row : rows)
+                {
+                    RenderHotkeyDisplay(row.label, row.id, row.hotkey, row.captureType, stepLabelWidth);
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::SetTooltip("Hotkey to nudge the current settings up or down; hold it to keep going, faster the longer it is held");
+                    }
+                }
             }
 
             ImGui::Spacing();
@@ -514,6 +544,10 @@ void RenderAdvancedUI()
             {
                 ImGui::TextColored(ImVec4(0.86f, 0.21f, 0.27f, 1.0f), "Warning: Values too extreme!");
             }
+            else if (App::state.gammaRampClamped)
+            {
+                ImGui::TextColored(ImVec4(0.86f, 0.21f, 0.27f, 1.0f), "Warning: Values too extreme, limited by Windows!");
+            }
 
             DrawGammaCurve();
         }
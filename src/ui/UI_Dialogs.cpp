@@ -70,6 +70,12 @@ void RenderHotkeyCaptureDialog()
             case HotkeyCapture::TOGGLE:           typeStr = "Toggle On/Off"; break;
             case HotkeyCapture::PREVIOUS_PROFILE: typeStr = "Previous Profile"; break;
             case HotkeyCapture::NEXT_PROFILE:     typeStr = "Next Profile"; break;
+            case HotkeyCapture::BRIGHTNESS_UP:    typeStr = "Brightness Up"; break;
+            case HotkeyCapture::BRIGHTNESS_DOWN:  typeStr = "Brightness Down"; break;
+            case HotkeyCapture::CONTRAST_UP:      typeStr = "Contrast Up"; break;
+            case HotkeyCapture::CONTRAST_DOWN:    typeStr = "Contrast Down"; break;
+            case HotkeyCapture::GAMMA_UP:         typeStr = "Gamma Up"; break;
+            case HotkeyCapture::GAMMA_DOWN:       typeStr = "Gamma Down"; break;
             case HotkeyCapture::PROFILE:          typeStr = "Profile Hotkey"; break;
             default:                              typeStr = "Unknown"; break;
         }
@@ -88,11 +94,10 @@ void RenderHotkeyCaptureDialog()
 
         if (ImGui::Button("Clear", ImVec2(GetScaledButtonWidth("Clear", DIALOG_BUTTON_WIDTH), 0)))
         {
-            // 0 clears the binding.
+            // 0 clears the binding. Hotkeys are registered again once the popup has closed, below.
             SetHotkeyForCaptureTarget(0);
 
-            ConfigManager::Save();
-            HotkeyManager::RegisterAll(App::mainWindow);
+            ConfigManager::ScheduleSave();
 
             UI::state.capturingHotkeyType = HotkeyCapture::NONE;
             ImGui::CloseCurrentPopup();
@@ -189,8 +194,8 @@ void RenderHotkeyConflictDialog()
             ClearConflictingHotkey(UI::state.conflictingHotkey);
             SetHotkeyForCaptureTarget(UI::state.conflictingHotkey);
 
-            ConfigManager::Save();
-            HotkeyManager::RegisterAll(App::mainWindow);
+            // Hotkeys are still suspended for the capture; they are registered again as it ends.
+            ConfigManager::ScheduleSave();
 
             UI::state.capturingHotkeyType = HotkeyCapture::NONE;
             ImGui::CloseCurrentPopup();
@@ -235,8 +240,8 @@ void RenderDeleteConfirmDialog()
             if (ImGui::Button("Yes", ImVec2(GetScaledButtonWidth("Yes", DIALOG_BUTTON_WIDTH), 0)))
             {
                 ProfileManager::DeleteProfile(UI::state.deleteProfileIndex);
-                ConfigManager::Save();
-                HotkeyManager::RegisterAll(App::mainWindow);
+                ConfigManager::ScheduleSave();
+                HotkeyManager::Refresh(App::mainWindow);
 
                 SyncUIWithCurrentProfile();
                 ImGui::CloseCurrentPopup();
@@ -31,7 +31,7 @@ void RenderMainUI()
     if (UI::state.modeJustChanged)
     {
         App::state.SetAdvancedModeEnabled(UI::state.targetAdvancedMode);
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
         
         UI::state.modeJustChanged = false;
 
@@ -85,9 +85,38 @@ static void DrawCaptionButton(ImDrawList* dl, const CaptionButton kind, const Im
     }
 }
 
+/**
+ * @brief The hotkey ID of the action being captured, or 0 if it has none yet.
+ *
+ * A brand-new profile (selectedProfileIndex out of range) isn't in the profiles array yet, so it
+ * has no ID of its own.
+ */
+static int CaptureTargetId(const HotkeyCapture captureTarget)
+{
+    switch (captureTarget)
+    {
+    case HotkeyCapture::TOGGLE: return HotkeyIDs::TOGGLE;
+    case HotkeyCapture::PREVIOUS_PROFILE: return HotkeyIDs::PREVIOUS_PROFILE;
+    case HotkeyCapture::NEXT_PROFILE: return HotkeyIDs::NEXT_PROFILE;
+    case HotkeyCapture::BRIGHTNESS_UP: return HotkeyIDs::BRIGHTNESS_UP;
+    case HotkeyCapture::BRIGHTNESS_DOWN: return HotkeyIDs::BRIGHTNESS_DOWN;
+    case HotkeyCapture::CONTRAST_UP: return HotkeyIDs::CONTRAST_UP;
+    case HotkeyCapture::CONTRAST_DOWN: return HotkeyIDs::CONTRAST_DOWN;
+    case HotkeyCapture::GAMMA_UP: return HotkeyIDs::GAMMA_UP;
+    case HotkeyCapture::GAMMA_DOWN: return HotkeyIDs::GAMMA_DOWN;
+    case HotkeyCapture::PROFILE:
+        if (App::selectedProfileIndex >= 0 && App::selectedProfileIndex < (int)App::profiles.size())
+            return HotkeyIDs::PROFILE_BASE + App::profiles[App::selectedProfileIndex].id;
+        return 0;
+    case HotkeyCapture::NONE:
+        break;
+    }
+    return 0;
+}
+
 /**
  * @brief Check whether a key is already bound to an action other than the one being captured.
- * @param vk Virtual key to check.
+ * @param vk Key combination (HotkeyCode) to check.
  * @param captureTarget The action currently being (re)bound; its own existing binding is ignored.
  * @return Friendly name of the conflicting action, or empty if there is no conflict.
  *
@@ -97,30 +126,24 @@ static void DrawCaptionButton(ImDrawList* dl, const CaptionButton kind, const Im
  */
 static std::string CheckHotkeyConflict(const UINT vk, const HotkeyCapture captureTarget)
 {
-    if (vk == 0) return "";
-
-    if (captureTarget != HotkeyCapture::TOGGLE && App::toggleHotkey == vk)
-        return "Toggle On/Off";
-    if (captureTarget != HotkeyCapture::PREVIOUS_PROFILE && App::previousProfileHotkey == vk)
-        return "Previous Profile";
-    if (captureTarget != HotkeyCapture::NEXT_PROFILE && App::nextProfileHotkey == vk)
-        return "Next Profile";
-
-    for (size_t i = 0; i < App::profiles.size(); ++i)
-    {
-        // When rebinding an existing profile's hotkey, that same profile's current binding
-        // is not a conflict. A brand-new profile (selectedProfileIndex out of range) isn't in
-        // this array yet, so nothing is skipped and every profile is checked.
-        if (captureTarget == HotkeyCapture::PROFILE && (int)i == App::selectedProfileIndex)
-            continue;
-
-        if (App::profiles[i].hotkey == vk)
-        {
-            return "Profile: " + StringUtils::WideToUTF8(App::profiles[i].name);
-        }
-    }
-
-    return ""; // No conflict.
+    const int id = HotkeyManager::FindAction(vk);
+    if (id == 0 || id == CaptureTargetId(captureTarget))
+        return ""; // No conflict.
+
+    switch (id)
+    {
+    case HotkeyIDs::TOGGLE: return "Toggle On/Off";
+    case HotkeyIDs::PREVIOUS_PROFILE: return "Previous Profile";
+    case HotkeyIDs::NEXT_PROFILE: return "Next Profile";
+    case HotkeyIDs::BRIGHTNESS_UP: return "Brightness Up";
+    case HotkeyIDs::BRIGHTNESS_DOWN: return "Brightness Down";
+    case HotkeyIDs::CONTRAST_UP: return "Contrast Up";
+    case HotkeyIDs::CONTRAST_DOWN: return "Contrast Down";
+    case HotkeyIDs::GAMMA_UP: return "Gamma Up";
+    case HotkeyIDs::GAMMA_DOWN: return "Gamma Down";
+    }
+    const int profileIndex = HotkeyManager::ProfileIndex(id);
+    return "Profile: " + (profileIndex >= 0 ? StringUtils::WideToUTF8(App::profiles[profileIndex].name) : std::string());
 }
 
 void SetHotkeyForCaptureTarget(const UINT vk)
@@ -136,6 +159,24 @@ void SetHotkeyForCaptureTarget(const UINT vk)
     case HotkeyCapture::NEXT_PROFILE:
         App::nextProfileHotkey = vk;
         break;
+    case HotkeyCapture::BRIGHTNESS_UP:
+        App::brightnessUpHotkey = vk;
+        break;
+    case HotkeyCapture::BRIGHTNESS_DOWN:
+        App::brightnessDownHotkey = vk;
+        break;
+    case HotkeyCapture::CONTRAST_UP:
+        App::contrastUpHotkey = vk;
+        break;
+    case HotkeyCapture::CONTRAST_DOWN:
+        App::contrastDownHotkey = vk;
+        break;
+    case HotkeyCapture::GAMMA_UP:
+        App::gammaUpHotkey = vk;
+        break;
+    case HotkeyCapture::GAMMA_DOWN:
+        App::gammaDownHotkey = vk;
+        break;
     case HotkeyCapture::PROFILE:
         // An existing profile is edited in place in the profiles array; a profile that
         // hasn't been saved yet lives only in workingProfile. Always update workingProfile
@@ -148,8 +189,7 @@ void SetHotkeyForCaptureTarget(const UINT vk)
         if (vk == 0)
             UI::state.profileHotkeyBuffer[0] = '\0';
         else
-            strncpy_s(UI::state.profileHotkeyBuffer, sizeof(UI::state.profileHotkeyBuffer),
-                      StringUtils::WideToUTF8(StringUtils::VkToName(vk)).c_str(), _TRUNCATE);
+            StringUtils::HotkeyToName(vk, UI::state.profileHotkeyBuffer, sizeof(UI::state.profileHotkeyBuffer));
         break;
     case HotkeyCapture::NONE:
         break;
@@ -176,7 +216,7 @@ static void ApplyHotkeyChange(const UINT vk)
     SetHotkeyForCaptureTarget(vk);
 
     // Always save when assigning hotkeys.
-    ConfigManager::Save();
+    ConfigManager::ScheduleSave();
     
     // Mark that we're done capturing, this will trigger hotkey re-registration.
     UI::state.capturingHotkeyType = HotkeyCapture::NONE;
@@ -216,7 +256,7 @@ void RenderDisplayComboBox()
                 }
                 App::selectedDisplayIndex = -1;
                 App::SyncGammaToState();
-                ConfigManager::Save();
+                ConfigManager::ScheduleSave();
             }
             if (selected)
                 ImGui::SetItemDefaultFocus();
@@ -239,7 +279,7 @@ void RenderDisplayComboBox()
                 }
                 App::selectedDisplayIndex = i;
                 App::SyncGammaToState();
-                ConfigManager::Save();
+                ConfigManager::ScheduleSave();
             }
             if (selected)
                 ImGui::SetItemDefaultFocus();
@@ -261,7 +301,7 @@ void RenderOptionsCheckboxes()
         ImVec2(UIConstants::CHECKBOX_INNERSPACING * App::GetDpiScale(), ImGui::GetStyle().ItemInnerSpacing.y));
     if (ImGui::Checkbox("Run in background when closed", &App::minimizeToTray))
     {
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
     }
     if (ImGui::IsItemHovered())
     {
@@ -270,7 +310,7 @@ void RenderOptionsCheckboxes()
     
     if (ImGui::Checkbox("Run in background when launched", &App::startMinimized))
     {
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
     }
     if (ImGui::IsItemHovered())
     {
@@ -279,7 +319,7 @@ void RenderOptionsCheckboxes()
     
     if (ImGui::Checkbox("Toggle on when launched", &App::applyProfileOnLaunch))
     {
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
     }
     if (ImGui::IsItemHovered())
     {
@@ -297,12 +337,26 @@ void RenderOptionsCheckboxes()
             UI::state.startupShortcutErrorDetail = StringUtils::WideToUTF8(detail);
             UI::state.showStartupShortcutError = true;
         }
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
     }
     if (ImGui::IsItemHovered())
     {
         ImGui::SetTooltip("Automatically start GammaHotkey when Windows starts");
     }
+
+    // Fade length for profile hotkeys and next/previous cycling. Saved once the drag finishes.
+    ImGui::Text("Profile switch fade: %d ms", App::transitionMs);
+    ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+    ImGui::SliderInt("##ProfileSwitchFade", &App::transitionMs, TransitionRange::MS_MIN, TransitionRange::MS_MAX, "%d ms",
+                     ImGuiSliderFlags_AlwaysClamp);
+    if (ImGui::IsItemDeactivatedAfterEdit())
+    {
+        ConfigManager::ScheduleSave();
+    }
+    if (ImGui::IsItemHovered())
+    {
+        ImGui::SetTooltip("Fade smoothly when switching profiles with hotkeys (0 = switch instantly)");
+    }
     ImGui::PopStyleVar();
 }
 
@@ -344,7 +398,7 @@ static void RenderProfileSlider(Profile& profile, const bool advancedMode, const
     // Autosave in simple mode, but only once the drag/edit finishes (not every frame).
     if (!advancedMode && ImGui::IsItemDeactivatedAfterEdit())
     {
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
     }
 
     if (ImGui::IsItemHovered())
@@ -366,7 +420,7 @@ static void RenderProfileSlider(Profile& profile, const bool advancedMode, const
         value = defaultValue;
         App::state.SetGammaEnabled(true);
         GammaManager::ApplyProfile(profile, App::selectedDisplayIndex);
-        ConfigManager::Save();
+        ConfigManager::ScheduleSave();
     }
 }
 
@@ -609,15 +663,29 @@ void RenderTitleBar()
 
 void ClearConflictingHotkey(const UINT vk)
 {
-    if (App::toggleHotkey == vk) App::toggleHotkey = 0;
-    if (App::previousProfileHotkey == vk) App::previousProfileHotkey = 0;
-    if (App::nextProfileHotkey == vk) App::nextProfileHotkey = 0;
-    
-    for (size_t i = 0; i < App::profiles.size(); ++i)
+    // Each cleared binding leaves a stale index entry, so the next lookup rebuilds the index and
+    // finds any other action still bound to the same key.
+    for (int id = HotkeyManager::FindAction(vk); id != 0; id = HotkeyManager::FindAction(vk))
     {
-        if (App::profiles[i].hotkey == vk)
+        switch (id)
+        {
+        case HotkeyIDs::TOGGLE: App::toggleHotkey = 0; break;
+        case HotkeyIDs::PREVIOUS_PROFILE: App::previousProfileHotkey = 0; break;
+        case HotkeyIDs::NEXT_PROFILE: App::nextProfileHotkey = 0; break;
+        case HotkeyIDs::BRIGHTNESS_UP: App::brightnessUpHotkey = 0; break;
+        case HotkeyIDs::BRIGHTNESS_DOWN: App::brightnessDownHotkey = 0; break;
+        case HotkeyIDs::CONTRAST_UP: App::contrastUpHotkey = 0; break;
+        case HotkeyIDs::CONTRAST_DOWN: App::contrastDownHotkey = 0; break;
+        case HotkeyIDs::GAMMA_UP: App::gammaUpHotkey = 0; break;
+        case HotkeyIDs::GAMMA_DOWN: App::gammaDownHotkey = 0; break;
+        default:
         {
-            App::profiles[i].hotkey = 0;
+            const int profileIndex = HotkeyManager::ProfileIndex(id);
+            if (profileIndex < 0)
+                return; // Cannot happen: FindAction only returns IDs the settings bind.
+            App::profiles[profileIndex].hotkey = 0;
+            break;
+        }
         }
     }
 }
@@ -729,7 +797,8 @@ void DrawGammaCurve()
     }
 
     // Draw curve.
-    const ImU32 curveColor = App::state.gammaRampFailed ? IM_COL32(220, 53, 69, 255) : IM_COL32(13, 110, 253, 255);
+    const bool curveRejected = App::state.gammaRampFailed || App::state.gammaRampClamped;
+    const ImU32 curveColor = curveRejected ? IM_COL32(220, 53, 69, 255) : IM_COL32(13, 110, 253, 255);
     const float curveThickness = 2.0f * dpiScale;
 
     for (int i = 0; i < 255; ++i)
@@ -755,8 +824,8 @@ void SyncUIWithCurrentProfile()
         
         if (App::workingProfile.hotkey != 0)
         {
-            strncpy_s(UI::state.profileHotkeyBuffer, sizeof(UI::state.profileHotkeyBuffer),
-                StringUtils::WideToUTF8(StringUtils::VkToName(App::workingProfile.hotkey)).c_str(), _TRUNCATE);
+            StringUtils::HotkeyToName(App::workingProfile.hotkey, UI::state.profileHotkeyBuffer,
+                sizeof(UI::state.profileHotkeyBuffer));
         }
         else
         {
@@ -775,15 +844,23 @@ void OnHotkeyCapture(const UINT vk)
     if (UI::state.capturingHotkeyType == HotkeyCapture::NONE)
         return; // Not capturing.
 
+    // The modifiers held along with the key make up the binding (e.g. Ctrl+Shift+F5).
+    UINT modifiers = 0;
+    if (GetKeyState(VK_CONTROL) & 0x8000) modifiers |= MOD_CONTROL;
+    if (GetKeyState(VK_MENU) & 0x8000) modifiers |= MOD_ALT;
+    if (GetKeyState(VK_SHIFT) & 0x8000) modifiers |= MOD_SHIFT;
+    if ((GetKeyState(VK_LWIN) | GetKeyState(VK_RWIN)) & 0x8000) modifiers |= MOD_WIN;
+    const UINT hotkey = HotkeyCode::Make(vk, modifiers);
+
     // Reject keys that can't be used as hotkeys (bare modifiers, F12).
     // Keep the capture dialog open and show the user why, so they can press another key.
     const char* reason = nullptr;
-    if (!HotkeyManager::IsBindableKey(vk, &reason))
+    if (!HotkeyManager::IsBindableKey(hotkey, &reason))
     {
         UI::state.captureRejectReason = reason ? reason : "That key can't be used as a hotkey.";
         return;
     }
 
     UI::state.captureRejectReason.clear();
-    ApplyHotkeyChange(vk);
+    ApplyHotkeyChange(hotkey);
 }
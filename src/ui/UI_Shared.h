@@ -78,19 +78,20 @@ void ApplyImGuiStyle();
 void SyncUIWithCurrentProfile();
 
 /**
- * @brief Handle key capture for the "set hotkey" popup (from WM_KEYDOWN).
+ * @brief Handle key capture for the "set hotkey" popup (from WM_KEYDOWN / WM_SYSKEYDOWN).
+ * @param vk The key pressed; the Ctrl/Alt/Shift/Win keys held at the time are bound with it.
  */
 void OnHotkeyCapture(const UINT vk);
 
 /**
- * @brief Clear any hotkeys that match the given virtual key.
- * @param vk Virtual-key code (e.g. VK_F1, VK_CONTROL).
+ * @brief Clear any hotkeys bound to the given key combination.
+ * @param vk HotkeyCode (key plus modifiers, see GammaHotkeyTypes.h).
  */
 void ClearConflictingHotkey(const UINT vk);
 
 /**
  * @brief Bind the action currently being captured (UI::state.capturingHotkeyType) to a key.
- * @param vk Virtual-key code, or 0 to clear the binding.
+ * @param vk HotkeyCode (key plus modifiers), or 0 to clear the binding.
  *
  * Writes only the matching binding plus the profile-hotkey display buffer. The caller is
  * still responsible for saving config, re-registering hotkeys and closing the capture popup.
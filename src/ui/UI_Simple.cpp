@@ -70,16 +70,13 @@ void RenderSimpleUI()
         // Toggle hotkey.
         ImGui::Text("Toggle On/Off Hotkey");
 
-        const std::string toggleKeyName = StringUtils::WideToUTF8(StringUtils::VkToName(App::toggleHotkey));
-
         const float buttonWidth = GetScaledButtonWidth("Set", 50.0f);
         const float spacing = ImGui::GetStyle().ItemSpacing.x;
 
         // Display as text in a frame.
         ImGui::BeginDisabled();
-        char buf[64];
-        strncpy_s(buf, toggleKeyName.c_str(), sizeof(buf) - 1);
-        buf[sizeof(buf) - 1] = '\0';
+        char buf[StringUtils::HOTKEY_NAME_SIZE];
+        StringUtils::HotkeyToName(App::toggleHotkey, buf, sizeof(buf));
         ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x - buttonWidth - spacing);
         ImGui::InputText("##ToggleHotkey", buf, sizeof(buf), ImGuiInputTextFlags_ReadOnly);
         ImGui::EndDisabled();
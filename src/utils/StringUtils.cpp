@@ -2,7 +2,8 @@
 
 #include "framework.h"
 #include "StringUtils.h"
-#include <sstream>
+#include "GammaHotkeyTypes.h"
+#include <array>
 
 namespace StringUtils
 {
@@ -30,83 +31,134 @@ namespace StringUtils
         return result;
     }
     
-    std::wstring VkToName(const UINT vk)
+    // A key name, stored inline so the whole table is one constant array.
+    struct KeyName
     {
-        if (vk == 0)
-            return L"None";
-        
-        // Function keys.
-        if (vk >= VK_F1 && vk <= VK_F24)
+        char text[16];
+    };
+
+    static constexpr KeyName MakeKeyName(const char* prefix, const int number = -1)
+    {
+        KeyName name = {};
+        size_t length = 0;
+        while (prefix[length] != '\0')
         {
-            std::wstringstream ss;
-            ss << L"F" << (vk - VK_F1 + 1);
-            return ss.str();
+            name.text[length] = prefix[length];
+            ++length;
         }
-        
+
+        if (number >= 100)
+            name.text[length++] = (char)('0' + number / 100);
+        if (number >= 10)
+            name.text[length++] = (char)('0' + number / 10 % 10);
+        if (number >= 0)
+            name.text[length++] = (char)('0' + number % 10);
+        return name;
+    }
+
+    // Name of every virtual key, indexed by code.
+    static constexpr std::array<KeyName, 256> BuildKeyNames()
+    {
+        std::array<KeyName, 256> names = {};
+
+        // Unknown keys.
+        for (int vk = 0; vk < 256; ++vk)
+            names[vk] = MakeKeyName("Key ", vk);
+        names[0] = MakeKeyName("None");
+
+        // Function keys.
+        for (int vk = VK_F1; vk <= VK_F24; ++vk)
+            names[vk] = MakeKeyName("F", vk - VK_F1 + 1);
+
         // Numpad keys.
-        if (vk >= VK_NUMPAD0 && vk <= VK_NUMPAD9)
-        {
-            std::wstringstream ss;
-            ss << L"Numpad " << (vk - VK_NUMPAD0);
-            return ss.str();
-        }
-        
+        for (int vk = VK_NUMPAD0; vk <= VK_NUMPAD9; ++vk)
+            names[vk] = MakeKeyName("Numpad ", vk - VK_NUMPAD0);
+
+        // Letter or number keys.
+        for (int vk = '0'; vk <= '9'; ++vk)
+            names[vk] = KeyName{ { (char)vk } };
+        for (int vk = 'A'; vk <= 'Z'; ++vk)
+            names[vk] = KeyName{ { (char)vk } };
+
         // Special keys.
-        switch (vk)
+        names[VK_BACK] = MakeKeyName("Backspace");
+        names[VK_TAB] = MakeKeyName("Tab");
+        names[VK_RETURN] = MakeKeyName("Enter");
+        names[VK_SHIFT] = MakeKeyName("Shift");
+        names[VK_CONTROL] = MakeKeyName("Ctrl");
+        names[VK_MENU] = MakeKeyName("Alt");
+        names[VK_PAUSE] = MakeKeyName("Pause");
+        names[VK_CAPITAL] = MakeKeyName("Caps Lock");
+        names[VK_ESCAPE] = MakeKeyName("Esc");
+        names[VK_SPACE] = MakeKeyName("Space");
+        names[VK_PRIOR] = MakeKeyName("Page Up");
+        names[VK_NEXT] = MakeKeyName("Page Down");
+        names[VK_END] = MakeKeyName("End");
+        names[VK_HOME] = MakeKeyName("Home");
+        names[VK_LEFT] = MakeKeyName("Left");
+        names[VK_UP] = MakeKeyName("Up");
+        names[VK_RIGHT] = MakeKeyName("Right");
+        names[VK_DOWN] = MakeKeyName("Down");
+        names[VK_SNAPSHOT] = MakeKeyName("Print Screen");
+        names[VK_INSERT] = MakeKeyName("Insert");
+        names[VK_DELETE] = MakeKeyName("Delete");
+        names[VK_LWIN] = MakeKeyName("Left Win");
+        names[VK_RWIN] = MakeKeyName("Right Win");
+        names[VK_MULTIPLY] = MakeKeyName("Numpad *");
+        names[VK_ADD] = MakeKeyName("Numpad +");
+        names[VK_SUBTRACT] = MakeKeyName("Numpad -");
+        names[VK_DECIMAL] = MakeKeyName("Numpad .");
+        names[VK_DIVIDE] = MakeKeyName("Numpad /");
+        names[VK_NUMLOCK] = MakeKeyName("Num Lock");
+        names[VK_SCROLL] = MakeKeyName("Scroll Lock");
+        names[VK_OEM_1] = MakeKeyName(";");
+        names[VK_OEM_PLUS] = MakeKeyName("=");
+        names[VK_OEM_COMMA] = MakeKeyName(",");
+        names[VK_OEM_MINUS] = MakeKeyName("-");
+        names[VK_OEM_PERIOD] = MakeKeyName(".");
+        names[VK_OEM_2] = MakeKeyName("/");
+        names[VK_OEM_3] = MakeKeyName("`");
+        names[VK_OEM_4] = MakeKeyName("[");
+        names[VK_OEM_5] = MakeKeyName("\\");
+        names[VK_OEM_6] = MakeKeyName("]");
+        names[VK_OEM_7] = MakeKeyName("'");
+        return names;
+    }
+
+    static constexpr std::array<KeyName, 256> KEY_NAMES = BuildKeyNames();
+
+    const char* VkToName(const UINT vk)
+    {
+        return vk < KEY_NAMES.size() ? KEY_NAMES[vk].text : "Unknown";
+    }
+
+    void HotkeyToName(const UINT hotkey, char* out, const size_t outSize)
+    {
+        if (outSize == 0)
+            return;
+
+        size_t length = 0;
+        const auto append = [out, outSize, &length](const char* text)
         {
-        case VK_BACK: return L"Backspace";
-        case VK_TAB: return L"Tab";
-        case VK_RETURN: return L"Enter";
-        case VK_SHIFT: return L"Shift";
-        case VK_CONTROL: return L"Ctrl";
-        case VK_MENU: return L"Alt";
-        case VK_PAUSE: return L"Pause";
-        case VK_CAPITAL: return L"Caps Lock";
-        case VK_ESCAPE: return L"Esc";
-        case VK_SPACE: return L"Space";
-        case VK_PRIOR: return L"Page Up";
-        case VK_NEXT: return L"Page Down";
-        case VK_END: return L"End";
-        case VK_HOME: return L"Home";
-        case VK_LEFT: return L"Left";
-        case VK_UP: return L"Up";
-        case VK_RIGHT: return L"Right";
-        case VK_DOWN: return L"Down";
-        case VK_SNAPSHOT: return L"Print Screen";
-        case VK_INSERT: return L"Insert";
-        case VK_DELETE: return L"Delete";
-        case VK_LWIN: return L"Left Win";
-        case VK_RWIN: return L"Right Win";
-        case VK_MULTIPLY: return L"Numpad *";
-        case VK_ADD: return L"Numpad +";
-        case VK_SUBTRACT: return L"Numpad -";
-        case VK_DECIMAL: return L"Numpad .";
-        case VK_DIVIDE: return L"Numpad /";
-        case VK_NUMLOCK: return L"Num Lock";
-        case VK_SCROLL: return L"Scroll Lock";
-        case VK_OEM_1: return L";";
-        case VK_OEM_PLUS: return L"=";
-        case VK_OEM_COMMA: return L",";
-        case VK_OEM_MINUS: return L"-";
-        case VK_OEM_PERIOD: return L".";
-        case VK_OEM_2: return L"/";
-        case VK_OEM_3: return L"`";
-        case VK_OEM_4: return L"[";
-        case VK_OEM_5: return L"\\";
-        case VK_OEM_6: return L"]";
-        case VK_OEM_7: return L"'";
-        }
-        
-        // Letter or number keys.
-        if ((vk >= '0' && vk <= '9') || (vk >= 'A' && vk <= 'Z'))
+            for (; *text != '\0' && length + 1 < outSize; ++text)
+                out[length++] = *text;
+        };
+
+        if (!HotkeyCode::IsValid(hotkey))
         {
-            return std::wstring(1, (wchar_t)vk);
+            append(hotkey == 0 ? "None" : "Unknown");
+            out[length] = '\0';
+            return;
         }
-        
-        // Unknown key.
-        std::wstringstream ss;
-        ss << L"Key " << vk;
-        return ss.str();
+
+        // Modifiers in the order Windows itself lists them.
+        const UINT modifiers = HotkeyCode::Modifiers(hotkey);
+        if (modifiers & MOD_CONTROL) append("Ctrl+");
+        if (modifiers & MOD_ALT) append("Alt+");
+        if (modifiers & MOD_SHIFT) append("Shift+");
+        if (modifiers & MOD_WIN) append("Win+");
+        append(KEY_NAMES[HotkeyCode::Vk(hotkey)].text);
+        out[length] = '\0';
     }
 
     void Trim(std::wstring& s)
@@ -26,9 +26,20 @@ namespace StringUtils
     /**
      * @brief Convert virtual key code to human-readable name.
      * @param[in] vk Virtual key code (VK_*).
-     * @return String representation (e.g. "F1", "Numpad 5").
+     * @return UTF-8 name (e.g. "F1", "Numpad 5") from a table built at compile time; never null.
      */
-    std::wstring VkToName(const UINT vk);
+    const char* VkToName(const UINT vk);
+
+    // Room for the longest hotkey name, "Ctrl+Alt+Shift+Win+Print Screen", and its terminator.
+    constexpr size_t HOTKEY_NAME_SIZE = 32;
+
+    /**
+     * @brief Write the name of a hotkey, modifiers first (e.g. "Ctrl+Shift+F5"), without allocating.
+     * @param[in] hotkey HotkeyCode to name; 0 gives "None".
+     * @param[out] out Buffer for the UTF-8 name, truncated to fit and always terminated.
+     * @param[in] outSize Size of out in bytes; HOTKEY_NAME_SIZE always fits.
+     */
+    void HotkeyToName(const UINT hotkey, char* out, const size_t outSize);
 
     /**
      * @brief Helper function to trim whitespace.
@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Max Godman
+
+// Timing helpers shared by the benchmarks (see tests/CMakeLists.txt).
+
+/**
+ * A benchmark is a plain main() that prints one line per measurement. Samples are collected in
+ * microseconds and reported as mean, p50 and p99, so a run can be compared with another by eye.
+ * The benchmarks are built with the tests but not run by ctest: their numbers depend on the machine.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline double ElapsedUs(const Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Print "label  mean X us  p50 X us  p99 X us" for the samples (which are sorted in place).
+     */
+    inline void Report(const char* label, std::vector<double>& samples)
+    {
+        if (samples.empty())
+            return;
+
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (const double sample : samples)
+            total += sample;
+
+        const auto percentile = [&samples](const double p)
+        {
+            return samples[std::min(samples.size() - 1, (size_t)(samples.size() * p))];
+        };
+        printf("%-28s mean %10.2f us   p50 %10.2f us   p99 %10.2f us   (%zu runs)\n",
+               label, total / samples.size(), percentile(0.50), percentile(0.99), samples.size());
+    }
+
+    /**
+     * @brief Time f() runs times and report it under label.
+     */
+    template <typename F>
+    void Measure(const char* label, const int runs, F&& f)
+    {
+        std::vector<double> samples;
+        samples.reserve(runs);
+        for (int run = 0; run < runs; ++run)
+        {
+            const Clock::time_point start = Clock::now();
+            f();
+            samples.push_back(ElapsedUs(start));
+        }
+        Report(label, samples);
+    }
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2025 Max Godman
+
+// Assertions shared by the core tests (see tests/CMakeLists.txt).
+
+/**
+ * A test is a plain main() that runs its checks and returns Check::Result(). A failed check prints
+ * where it failed and carries on, so one run reports every failure; Result() is nonzero if any did.
+ * Kept to a few macros so the tests build anywhere the core does, with nothing to install.
+ */
+
+#pragma once
+
+#include <cstdio>
+
+namespace Check
+{
+    // Exit code ctest treats as "skipped" (SKIP_RETURN_CODE), e.g. a kernel the CPU cannot run.
+    constexpr int SKIPPED = 77;
+
+    inline int failures = 0;
+
+    inline bool Report(const bool ok, const char* expression, const char* file, const int line)
+    {
+        if (!ok)
+        {
+            ++failures;
+            fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        }
+        return ok;
+    }
+
+    inline int Result()
+    {
+        if (failures != 0)
+            fprintf(stderr, "%d check(s) failed.\n", failures);
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+// Record a failure if cond is false. Evaluates to cond, so a test can stop early on it.
+#define CHECK(cond) Check::Report(static_cast<bool>(cond), #cond, __FILE__, __LINE__)
+
+// Like CHECK, for context a bare expression cannot carry (the inputs of a failing case).
+#define CHECK_MSG(cond, ...) \
+    (CHECK(cond) ? true : (fprintf(stderr, "    " __VA_ARGS__), fprintf(stderr, "\n"), false))
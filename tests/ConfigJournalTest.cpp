@@ -0,0 +1,272 @@
+// Copyright (c) 2025 Max Godman
+
+// ConfigJournal crash consistency: a journal cut off anywhere replays as a prefix of whole records.
+
+#include "Check.h"
+#include "ConfigJournal.h"
+#include "ConfigParser.h"
+#include "ConfigWriter.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using ConfigParser::Key;
+using ConfigParser::Section;
+
+namespace
+{
+    // What replaying a journal leaves behind: the last value each (section, key) was given. Enough
+    // to tell one prefix of records from another, which is all crash consistency is about.
+    using State = std::map<std::pair<Section, Key>, std::string>;
+
+    void Apply(const std::string_view body, State& state)
+    {
+        ConfigParser::Parse(body, [&](const ConfigParser::Entry& entry)
+        {
+            if (!entry.IsSectionHeader())
+                state[{ entry.section, entry.key }] = std::string(entry.value);
+        });
+    }
+
+    std::string MakeIni()
+    {
+        std::string ini;
+        ConfigWriter out(ini);
+        out.Section(Section::GlobalHotkeys);
+        out.Int(Key::TransitionMs, 0);
+        out.Bool(Key::JournalSave, true);
+        out.BlankLine();
+        out.Section(Section::Profile);
+        out.String(Key::Name, L"Night");
+        out.Int(Key::Brightness, -20);
+        return ini;
+    }
+
+    // Record bodies as ConfigManager writes them: one save's changes each.
+    std::vector<std::string> MakeBodies()
+    {
+        std::vector<std::string> bodies(3);
+        {
+            ConfigWriter out(bodies[0]);
+            out.Section(Section::GlobalHotkeys);
+            out.Int(Key::TransitionMs, 300);
+        }
+        {
+            ConfigWriter out(bodies[1]);
+            out.Section(Section::Profile);
+            out.Int(Key::Index, 0);
+            out.Int(Key::Brightness, -35);
+            out.Float(Key::Gamma, 0.8f);
+        }
+        {
+            ConfigWriter out(bodies[2]);
+            out.Section(Section::Profile);
+            out.Int(Key::InsertAt, 1);
+            out.String(Key::Name, L"Reading \u00e9t\u00e9");
+            out.Int(Key::Brightness, 10);
+            out.Float(Key::Contrast, 1.25f);
+        }
+        return bodies;
+    }
+
+    struct Journal
+    {
+        std::string text;
+        size_t headerEnd = 0;
+        std::vector<size_t> recordEnds; // Offset just past each record.
+    };
+
+    Journal MakeJournal(const std::string& ini, const std::vector<std::string>& bodies)
+    {
+        Journal journal;
+        ConfigJournal::WriteHeader(journal.text, HashConfigBytes(ini), ini.size());
+        journal.headerEnd = journal.text.size();
+        for (const std::string& body : bodies)
+        {
+            ConfigJournal::WriteRecord(journal.text, body);
+            journal.recordEnds.push_back(journal.text.size());
+        }
+        return journal;
+    }
+
+    // Truncate at every byte offset, the header and every record included: the replay is always the
+    // records that were complete at that length, and anything past them is reported as torn.
+    void TestEveryTruncation()
+    {
+        const std::string ini = MakeIni();
+        const std::vector<std::string> bodies = MakeBodies();
+        const Journal journal = MakeJournal(ini, bodies);
+
+        // The state after each whole prefix of records.
+        std::vector<State> expectedStates(bodies.size() + 1);
+        for (size_t count = 1; count <= bodies.size(); ++count)
+        {
+            expectedStates[count] = expectedStates[count - 1];
+            Apply(bodies[count - 1], expectedStates[count]);
+        }
+
+        int failures = 0;
+        for (size_t length = 0; length <= journal.text.size(); ++length)
+        {
+            State state;
+            std::vector<std::string_view> replayed;
+            const ConfigJournal::ReadResult result = ConfigJournal::Read(
+                std::string_view(journal.text).substr(0, length), HashConfigBytes(ini), ini.size(),
+                [&](const std::string_view body) { replayed.push_back(body); Apply(body, state); });
+
+            size_t complete = 0;
+            while (complete < journal.recordEnds.size() && journal.recordEnds[complete] <= length)
+                ++complete;
+            const bool headerComplete = length >= journal.headerEnd;
+            const size_t validSize = !headerComplete ? 0 : complete == 0 ? journal.headerEnd : journal.recordEnds[complete - 1];
+
+            bool ok = result.matched == headerComplete && result.records == (int)complete &&
+                      result.validSize == validSize && result.torn == (headerComplete && length > validSize) &&
+                      replayed.size() == complete && state == expectedStates[complete];
+            for (size_t index = 0; ok && index < replayed.size(); ++index)
+                ok = replayed[index] == bodies[index];
+
+            if (!ok && ++failures <= 5)
+                CHECK_MSG(ok, "truncated to %zu of %zu bytes: %d records, valid %zu, torn %d", length,
+                          journal.text.size(), result.records, result.validSize, (int)result.torn);
+        }
+        CHECK(failures == 0);
+    }
+
+    // A damaged byte anywhere in the last record (its "#size hash" line or its body) drops that
+    // record alone, as a torn tail; the ones before it still replay.
+    void TestDamagedLastRecord()
+    {
+        const std::string ini = MakeIni();
+        const std::vector<std::string> bodies = MakeBodies();
+        const Journal journal = MakeJournal(ini, bodies);
+        const size_t lastStart = journal.recordEnds[bodies.size() - 2];
+
+        int failures = 0;
+        for (size_t offset = lastStart; offset < journal.text.size(); ++offset)
+        {
+            std::string damaged = journal.text;
+            damaged[offset] ^= 0x01; // Not 0x20: that only changes the case of a hex digit.
+
+            State state;
+            const ConfigJournal::ReadResult result = ConfigJournal::Read(damaged, HashConfigBytes(ini), ini.size(),
+                [&](const std::string_view body) { Apply(body, state); });
+
+            State expected;
+            for (size_t index = 0; index + 1 < bodies.size(); ++index)
+                Apply(bodies[index], expected);
+
+            const bool ok = result.matched && result.records == (int)bodies.size() - 1 &&
+                            result.validSize == lastStart && result.torn && state == expected;
+            if (!ok && ++failures <= 5)
+                CHECK_MSG(ok, "byte %zu flipped: %d records, valid %zu", offset, result.records, result.validSize);
+        }
+        CHECK(failures == 0);
+    }
+
+    // The header binds the journal to one exact ini: any other content or size, and nothing replays.
+    void TestHeaderBinding()
+    {
+        const std::string ini = MakeIni();
+        const Journal journal = MakeJournal(ini, MakeBodies());
+        const uint64_t hash = HashConfigBytes(ini);
+
+        int records = 0;
+        const auto count = [&records](const std::string_view) { ++records; };
+
+        CHECK(ConfigJournal::Read(journal.text, hash, ini.size(), count).matched);
+        CHECK(records == 3);
+
+        records = 0;
+        CHECK(!ConfigJournal::Read(journal.text, hash, ini.size() + 1, count).matched);
+        CHECK(!ConfigJournal::Read(journal.text, hash ^ 1, ini.size(), count).matched);
+
+        // The ini was rewritten (compacted) but the journal survived a crash before it was deleted.
+        std::string edited = ini;
+        edited[edited.size() - 3] = '5';
+        const ConfigJournal::ReadResult stale = ConfigJournal::Read(journal.text, HashConfigBytes(edited), edited.size(), count);
+        CHECK(!stale.matched && stale.validSize == 0 && !stale.torn);
+        CHECK(records == 0);
+
+        // A header line that does not parse is as good as none.
+        std::string garbled = journal.text;
+        garbled[journal.headerEnd - 4] = 'x';
+        CHECK(!ConfigJournal::Read(garbled, hash, ini.size(), count).matched);
+        CHECK(!ConfigJournal::Read(std::string_view(), hash, ini.size(), count).matched);
+        CHECK(records == 0);
+    }
+
+    // The ini a full save writes for a state: each section once, its keys in order.
+    std::string WriteIni(const State& state)
+    {
+        std::string ini;
+        ConfigWriter out(ini);
+        Section current = Section::None;
+        for (const auto& [field, value] : state)
+        {
+            if (field.first != current)
+                out.Section(current = field.first);
+            ini += ConfigParser::GetKeyName(field.second);
+            ini += '=';
+            ini += value;
+            ini += ConfigWriter::NEWLINE;
+        }
+        return ini;
+    }
+
+    // Recovery from a torn tail as ConfigManager does it: the whole records replay, the tear marks
+    // the journal for compaction, and the next save rewrites the ini in full and starts a new journal
+    // bound to it. Nothing of the tail comes back, even if the old journal outlives the rewrite.
+    void TestRecoveryFromTornTail()
+    {
+        const std::string ini = MakeIni();
+        const std::vector<std::string> bodies = MakeBodies();
+        const Journal journal = MakeJournal(ini, bodies);
+        const std::string_view cut = std::string_view(journal.text).substr(0, journal.recordEnds[2] - 5);
+
+        // Load: the ini, then the whole records. ReplayJournal sets needsCompaction on !matched || torn.
+        State state;
+        Apply(ini, state);
+        const ConfigJournal::ReadResult torn = ConfigJournal::Read(cut, HashConfigBytes(ini), ini.size(),
+            [&](const std::string_view body) { Apply(body, state); });
+        CHECK(torn.matched && torn.torn && torn.records == 2 && torn.validSize == journal.recordEnds[1]);
+
+        State expected;
+        Apply(ini, expected);
+        Apply(bodies[0], expected);
+        Apply(bodies[1], expected);
+        CHECK(state == expected);
+
+        // The next save is a full rewrite of what was loaded.
+        const std::string compacted = WriteIni(state);
+        State reloaded;
+        Apply(compacted, reloaded);
+        CHECK(reloaded == state);
+
+        // A crash before the old journal is deleted: it no longer matches the ini, so nothing replays.
+        int records = 0;
+        const ConfigJournal::ReadResult stale = ConfigJournal::Read(cut, HashConfigBytes(compacted), compacted.size(),
+            [&records](const std::string_view) { ++records; });
+        CHECK(!stale.matched && records == 0);
+
+        // Saves after that are records in a new journal on top of the rewritten ini.
+        std::string next;
+        ConfigJournal::WriteHeader(next, HashConfigBytes(compacted), compacted.size());
+        ConfigJournal::WriteRecord(next, bodies[2]);
+        State replayed;
+        Apply(compacted, replayed);
+        const ConfigJournal::ReadResult result = ConfigJournal::Read(next, HashConfigBytes(compacted), compacted.size(),
+            [&](const std::string_view body) { Apply(body, replayed); });
+        Apply(bodies[2], expected);
+        CHECK(result.matched && result.records == 1 && !result.torn && replayed == expected);
+    }
+}
+
+int main()
+{
+    TestEveryTruncation();
+    TestDamagedLastRecord();
+    TestHeaderBinding();
+    TestRecoveryFromTornTail();
+    return Check::Result();
+}
@@ -0,0 +1,307 @@
+// Copyright (c) 2025 Max Godman
+
+// Load time of large configs: ConfigParser against the line-by-line parse it replaced.
+
+/**
+ * Both sides start from the file contents already in memory and end with the same profile list, so
+ * what is compared is the parse itself:
+ *   line-by-line  the former ConfigManager::Load loop: getline, widen every line, Trim and substr
+ *                 copies, std::stoi/stof, and a case-insensitive std::map of std::function for the
+ *                 global settings.
+ *   ConfigParser  one pass over the UTF-8 bytes with string_view, std::from_chars and the perfect-hash
+ *                 key table; only profile names are widened.
+ * The duplicate-name check is left out of both; see ProfileIndexBench for that.
+ *
+ *   configparse_bench [runs, default 10]
+ */
+
+#include "Bench.h"
+#include "ConfigParser.h"
+#include "ConfigWriter.h"
+#include "GammaHotkeyTypes.h"
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+    // A config as the app writes it: the global settings, the simple profile and count profiles.
+    std::string MakeConfig(const int count)
+    {
+        using ConfigParser::Key;
+        using ConfigParser::Section;
+
+        std::string text;
+        ConfigWriter out(text);
+        out.Section(Section::GlobalHotkeys);
+        for (const Key key : { Key::ToggleHotkey, Key::NextProfileHotkey, Key::PreviousProfileHotkey, Key::LoopProfiles,
+                               Key::StartMinimized, Key::MinimizeToTray, Key::SelectedDisplay, Key::SelectedProfileIndex,
+                               Key::AdvancedMode, Key::TransitionMs })
+        {
+            out.Int(key, 1);
+        }
+        out.BlankLine();
+        out.Section(Section::SimpleProfile);
+        out.Int(Key::Brightness, 5);
+        out.Float(Key::Contrast, 1.1f);
+        out.Float(Key::Gamma, 0.9f);
+
+        for (int index = 0; index < count; ++index)
+        {
+            out.BlankLine();
+            out.Section(Section::Profile);
+            out.String(Key::Name, L"Profile " + std::to_wstring(index));
+            out.Int(Key::Brightness, index % 101 - 50);
+            out.Float(Key::Contrast, 0.5f + (index % 100) * 0.01f);
+            out.Float(Key::Gamma, 0.1f + (index % 290) * 0.01f);
+            out.Int(Key::Hotkey, index % 2 == 0 ? 0 : HotkeyCode::Make(0x70 + index % 12, MOD_CONTROL));
+        }
+        return text;
+    }
+
+    // The generated names are ASCII; both sides widen them the same way.
+    std::wstring Widen(const std::string_view text)
+    {
+        return std::wstring(text.begin(), text.end());
+    }
+
+    void TrimWide(std::wstring& s)
+    {
+        const size_t first = s.find_first_not_of(L" \t\r\n");
+        if (first == std::wstring::npos)
+        {
+            s.clear();
+            return;
+        }
+        s = s.substr(first, s.find_last_not_of(L" \t\r\n") - first + 1);
+    }
+
+    bool EqualsNoCase(const std::wstring& a, const wchar_t* b)
+    {
+        size_t index = 0;
+        for (; index < a.size() && b[index]; ++index)
+        {
+            if (std::towlower(a[index]) != std::towlower(b[index]))
+                return false;
+        }
+        return index == a.size() && !b[index];
+    }
+
+    struct NoCaseLess
+    {
+        bool operator()(const std::wstring& a, const std::wstring& b) const
+        {
+            return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+                [](const wchar_t x, const wchar_t y) { return std::towlower(x) < std::towlower(y); });
+        }
+    };
+
+    int StoiOr(const std::wstring& text, const int fallback)
+    {
+        try { return std::stoi(text); } catch (...) { return fallback; }
+    }
+
+    float StofOr(const std::wstring& text, const float fallback)
+    {
+        try { return std::stof(text); } catch (...) { return fallback; }
+    }
+
+    struct Settings
+    {
+        int values[8] = {};
+        Profile simple;
+        std::vector<Profile> profiles;
+    };
+
+    void LoadLineByLine(const std::string& file, Settings& settings)
+    {
+        enum class Section { None, GlobalHotkeys, SimpleProfile, Profile };
+
+        static const std::map<std::wstring, std::function<void(Settings&, const std::wstring&)>, NoCaseLess> handlers = {
+            { L"ToggleHotkey", [](Settings& s, const std::wstring& v) { s.values[0] = StoiOr(v, 0); } },
+            { L"NextProfileHotkey", [](Settings& s, const std::wstring& v) { s.values[1] = StoiOr(v, 0); } },
+            { L"PreviousProfileHotkey", [](Settings& s, const std::wstring& v) { s.values[2] = StoiOr(v, 0); } },
+            { L"LoopProfiles", [](Settings& s, const std::wstring& v) { s.values[3] = StoiOr(v, 0); } },
+            { L"StartMinimized", [](Settings& s, const std::wstring& v) { s.values[4] = StoiOr(v, 0); } },
+            { L"MinimizeToTray", [](Settings& s, const std::wstring& v) { s.values[5] = StoiOr(v, 0); } },
+            { L"SelectedDisplay", [](Settings& s, const std::wstring& v) { s.values[6] = StoiOr(v, 0); } },
+            { L"SelectedProfileIndex", [](Settings& s, const std::wstring& v) { s.values[7] = StoiOr(v, 0); } },
+        };
+
+        std::istringstream in(file);
+        std::string rawLine;
+        Section section = Section::None;
+        Profile profile;
+        const auto finalize = [&]()
+        {
+            if (!profile.name.empty())
+                settings.profiles.push_back(profile);
+            profile = Profile();
+        };
+
+        while (std::getline(in, rawLine))
+        {
+            std::wstring line = Widen(rawLine);
+            TrimWide(line);
+            if (line.empty() || line[0] == L';' || line[0] == L'#')
+                continue;
+
+            if (line.front() == L'[' && line.back() == L']')
+            {
+                std::wstring name = line.substr(1, line.size() - 2);
+                TrimWide(name);
+                if (section == Section::Profile)
+                    finalize();
+                section = EqualsNoCase(name, L"Profile") ? Section::Profile :
+                          EqualsNoCase(name, L"SimpleProfile") ? Section::SimpleProfile :
+                          EqualsNoCase(name, L"GlobalHotkeys") ? Section::GlobalHotkeys : Section::None;
+                continue;
+            }
+
+            const size_t eq = line.find(L'=');
+            if (eq == std::wstring::npos || section == Section::None)
+                continue;
+            std::wstring key = line.substr(0, eq);
+            std::wstring value = line.substr(eq + 1);
+            TrimWide(key);
+            TrimWide(value);
+
+            if (section == Section::GlobalHotkeys)
+            {
+                const auto handler = handlers.find(key);
+                if (handler != handlers.end())
+                    handler->second(settings, value);
+                continue;
+            }
+
+            Profile& target = section == Section::SimpleProfile ? settings.simple : profile;
+            if (section == Section::Profile && EqualsNoCase(key, L"Name"))
+                target.name = value;
+            else if (EqualsNoCase(key, L"Brightness"))
+                target.brightness = StoiOr(value, 0);
+            else if (EqualsNoCase(key, L"Contrast"))
+                target.contrast = StofOr(value, 1.0f);
+            else if (EqualsNoCase(key, L"Gamma"))
+                target.gamma = StofOr(value, 1.0f);
+            else if (section == Section::Profile && EqualsNoCase(key, L"Hotkey"))
+                target.hotkey = (UINT)StoiOr(value, 0);
+        }
+        if (section == Section::Profile)
+            finalize();
+    }
+
+    // Where LoadParser keeps a global setting: the same slots as LoadLineByLine's handlers.
+    int GetSettingSlot(const ConfigParser::Key key)
+    {
+        using ConfigParser::Key;
+        switch (key)
+        {
+        case Key::ToggleHotkey: return 0;
+        case Key::NextProfileHotkey: return 1;
+        case Key::PreviousProfileHotkey: return 2;
+        case Key::LoopProfiles: return 3;
+        case Key::StartMinimized: return 4;
+        case Key::MinimizeToTray: return 5;
+        case Key::SelectedDisplay: return 6;
+        case Key::SelectedProfileIndex: return 7;
+        default: return -1;
+        }
+    }
+
+    void LoadParser(const std::string& file, Settings& settings)
+    {
+        using ConfigParser::Key;
+        using ConfigParser::Section;
+
+        Profile profile;
+        Section current = Section::None;
+        const auto finalize = [&]()
+        {
+            if (!profile.name.empty())
+                settings.profiles.push_back(profile);
+            profile = Profile();
+        };
+
+        ConfigParser::Parse(file, [&](const ConfigParser::Entry& entry)
+        {
+            if (entry.IsSectionHeader())
+            {
+                if (current == Section::Profile)
+                    finalize();
+                current = entry.section;
+                return;
+            }
+
+            int number = 0;
+            if (entry.section == Section::GlobalHotkeys)
+            {
+                const int slot = GetSettingSlot(entry.key);
+                if (slot >= 0)
+                    settings.values[slot] = ConfigParser::ParseInt(entry.value, number) ? number : 0;
+                return;
+            }
+
+            Profile& target = entry.section == Section::SimpleProfile ? settings.simple : profile;
+            switch (entry.key)
+            {
+            case Key::Name: if (entry.section == Section::Profile) target.name = Widen(entry.value); break;
+            case Key::Brightness: target.brightness = ConfigParser::ParseInt(entry.value, number) ? number : 0; break;
+            case Key::Contrast: if (!ConfigParser::ParseFloat(entry.value, target.contrast)) target.contrast = 1.0f; break;
+            case Key::Gamma: if (!ConfigParser::ParseFloat(entry.value, target.gamma)) target.gamma = 1.0f; break;
+            case Key::Hotkey: if (entry.section == Section::Profile) target.hotkey = ConfigParser::ParseInt(entry.value, number) ? (UINT)number : 0; break;
+            default: break;
+            }
+        });
+        if (current == Section::Profile)
+            finalize();
+    }
+
+    bool SameProfile(const Profile& x, const Profile& y)
+    {
+        return x.name == y.name && x.brightness == y.brightness && x.contrast == y.contrast && x.gamma == y.gamma &&
+               x.hotkey == y.hotkey;
+    }
+
+    bool SameSettings(const Settings& a, const Settings& b)
+    {
+        if (std::memcmp(a.values, b.values, sizeof(a.values)) != 0 || !SameProfile(a.simple, b.simple) ||
+            a.profiles.size() != b.profiles.size())
+        {
+            return false;
+        }
+        for (size_t index = 0; index < a.profiles.size(); ++index)
+        {
+            if (!SameProfile(a.profiles[index], b.profiles[index]))
+                return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int runs = argc > 1 ? std::max(1, atoi(argv[1])) : 10;
+
+    for (const int count : { 10000, 100000 })
+    {
+        const std::string file = MakeConfig(count);
+        printf("%d profiles, %.1f MB\n", count, file.size() / 1e6);
+
+        Settings lineByLine, parser;
+        LoadLineByLine(file, lineByLine);
+        LoadParser(file, parser);
+        if ((int)parser.profiles.size() != count || !SameSettings(lineByLine, parser))
+        {
+            fprintf(stderr, "The two loads disagree.\n");
+            return 1;
+        }
+
+        Bench::Measure("  line-by-line", runs, [&]() { Settings settings; LoadLineByLine(file, settings); });
+        Bench::Measure("  ConfigParser", runs, [&]() { Settings settings; LoadParser(file, settings); });
+    }
+    return 0;
+}
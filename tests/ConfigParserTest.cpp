@@ -0,0 +1,122 @@
+// Copyright (c) 2025 Max Godman
+
+// ConfigParser: the ini format the old line-by-line loader accepted, and numbers as std::stoi/stof read them.
+
+#include "Check.h"
+#include "ConfigParser.h"
+#include <string>
+#include <vector>
+
+using ConfigParser::Key;
+using ConfigParser::Section;
+
+namespace
+{
+    struct Line
+    {
+        Section section;
+        Key key;
+        std::string value;
+    };
+
+    std::vector<Line> ParseAll(const std::string_view text)
+    {
+        std::vector<Line> lines;
+        ConfigParser::Parse(text, [&](const ConfigParser::Entry& entry)
+        {
+            lines.push_back({ entry.section, entry.key, std::string(entry.value) });
+        });
+        return lines;
+    }
+
+    // Comments, blank lines, spacing, case, CRLF and a BOM, as the old loader took them.
+    void TestFormat()
+    {
+        const std::string text =
+            "\xEF\xBB\xBF; GammaHotkey configuration\r\n"
+            "orphan=1\r\n"
+            "\r\n"
+            "  [ globalhotkeys ]  \r\n"
+            "# a comment\r\n"
+            "\tToggleHotkey = 112 \r\n"
+            "NoSuchKey=5\r\n"
+            "no equals sign\r\n"
+            "[Unknown]\r\n"
+            "Brightness=7\r\n"
+            "[Profile]\n"
+            "name=Night\n"
+            "BRIGHTNESS=-20";
+
+        const std::vector<Line> lines = ParseAll(text);
+        CHECK(lines.size() == 6);
+        if (lines.size() != 6)
+            return;
+
+        CHECK(lines[0].section == Section::GlobalHotkeys && lines[0].key == Key::Unknown);
+        CHECK(lines[1].section == Section::GlobalHotkeys && lines[1].key == Key::ToggleHotkey && lines[1].value == "112");
+        CHECK(lines[2].section == Section::None && lines[2].key == Key::Unknown); // [Unknown] closes the section.
+        CHECK(lines[3].section == Section::Profile && lines[3].key == Key::Unknown);
+        CHECK(lines[4].section == Section::Profile && lines[4].key == Key::Name && lines[4].value == "Night");
+        CHECK(lines[5].key == Key::Brightness && lines[5].value == "-20"); // No final newline.
+    }
+
+    // Every name round-trips through its canonical spelling, in any case.
+    void TestNames()
+    {
+        for (int key = (int)Key::Name; key <= (int)Key::RemoveAt; ++key)
+        {
+            const std::string_view name = ConfigParser::GetKeyName((Key)key);
+            std::string upper(name);
+            for (char& c : upper)
+                c = (c >= 'a' && c <= 'z') ? (char)(c - 32) : c;
+            CHECK_MSG(ConfigParser::LookupKey(name) == (Key)key && ConfigParser::LookupKey(upper) == (Key)key,
+                      "key %.*s", (int)name.size(), name.data());
+        }
+        for (const Section section : { Section::GlobalHotkeys, Section::SimpleProfile, Section::Profile })
+            CHECK(ConfigParser::LookupSection(ConfigParser::GetSectionName(section)) == section);
+
+        CHECK(ConfigParser::LookupKey("") == Key::Unknown);
+        CHECK(ConfigParser::LookupKey("Gamma2") == Key::Unknown);
+        CHECK(ConfigParser::LookupKey("Gamm") == Key::Unknown);
+        CHECK(ConfigParser::LookupSection("Profiles") == Section::None);
+    }
+
+    // Leading numbers as std::stoi/stof: sign, trailing text ignored, nothing parsed or out of range fails.
+    void TestNumbers()
+    {
+        int number = 99;
+        CHECK(ConfigParser::ParseInt("-20", number) && number == -20);
+        CHECK(ConfigParser::ParseInt("+5", number) && number == 5);
+        CHECK(ConfigParser::ParseInt("12abc", number) && number == 12);
+        CHECK(ConfigParser::ParseInt("2147483647", number) && number == 2147483647);
+
+        number = 99;
+        CHECK(!ConfigParser::ParseInt("", number) && number == 99);
+        CHECK(!ConfigParser::ParseInt("abc", number) && number == 99);
+        CHECK(!ConfigParser::ParseInt("-", number) && number == 99);
+        CHECK(!ConfigParser::ParseInt("+-1", number) && number == 99);
+        CHECK(!ConfigParser::ParseInt("2147483648", number) && number == 99);
+        CHECK(!ConfigParser::ParseInt("99999999999999999999", number) && number == 99);
+
+        float value = 9.0f;
+        CHECK(ConfigParser::ParseFloat("1.05", value) && value == 1.05f);
+        CHECK(ConfigParser::ParseFloat("+0.8", value) && value == 0.8f);
+        CHECK(ConfigParser::ParseFloat("2.2x", value) && value == 2.2f);
+        CHECK(ConfigParser::ParseFloat("3", value) && value == 3.0f);
+        CHECK(ConfigParser::ParseFloat("1e-1", value) && value == 0.1f);
+
+        value = 9.0f;
+        CHECK(!ConfigParser::ParseFloat("", value) && value == 9.0f);
+        CHECK(!ConfigParser::ParseFloat("gamma", value) && value == 9.0f);
+        CHECK(!ConfigParser::ParseFloat(".", value) && value == 9.0f);
+        CHECK(!ConfigParser::ParseFloat("1e40", value) && value == 9.0f);
+    }
+}
+
+int main()
+{
+    TestFormat();
+    TestNames();
+    TestNumbers();
+    return Check::Result();
+}
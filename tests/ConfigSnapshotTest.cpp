@@ -0,0 +1,181 @@
+// Copyright (c) 2025 Max Godman
+
+// ConfigSnapshot: what Builder writes, View reads back, and only for the exact ini and bytes it was made for.
+
+#include "Check.h"
+#include "ConfigSnapshot.h"
+#include "ConfigWriter.h"
+#include <cstring>
+#include <string>
+
+using ConfigParser::Key;
+using ConfigSnapshot::IniStamp;
+
+namespace
+{
+    struct TestProfile
+    {
+        std::wstring name;
+        int32_t brightness;
+        float contrast;
+        float gamma;
+        uint32_t hotkey;
+    };
+
+    std::wstring Emoji()
+    {
+        // U+1F319: a surrogate pair in the pool, one wchar_t where wchar_t is 32-bit.
+        if (sizeof(wchar_t) == 2)
+            return std::wstring{ (wchar_t)0xD83C, (wchar_t)0xDF19 };
+        return std::wstring(1, (wchar_t)0x1F319);
+    }
+
+    const TestProfile PROFILES[] = {
+        { L"Day", 0, 1.0f, 1.0f, 0 },
+        { L"Lecture \u00e9t\u00e9", -35, 0.8f, 2.2f, 0x270 },
+        { L"", 50, 1.5f, 0.1f, 0 },
+        { L"Moon " + Emoji(), -50, 0.5f, 3.0f, 0x37B },
+    };
+
+    IniStamp MakeStamp()
+    {
+        IniStamp stamp;
+        stamp.size = 48213;
+        stamp.writeTime = 133512345678901234;
+        stamp.hash = 0x0123456789ABCDEFull;
+        return stamp;
+    }
+
+    std::string MakeSnapshot(const IniStamp& stamp)
+    {
+        ConfigSnapshot::Builder builder;
+        builder.AddGlobal(Key::ToggleHotkey, 0x170);
+        builder.AddGlobal(Key::TransitionMs, 300);
+        builder.AddGlobal(Key::SelectedDisplay, -1);
+        builder.SetSimpleProfile(ConfigSnapshot::SIMPLE_BRIGHTNESS | ConfigSnapshot::SIMPLE_GAMMA, -20, 1.0f, 0.9f);
+        for (const TestProfile& profile : PROFILES)
+            builder.AddProfile(profile.name, profile.brightness, profile.contrast, profile.gamma, profile.hotkey);
+
+        std::string file;
+        builder.Finish(stamp, file);
+        return file;
+    }
+
+    bool Opens(const std::string& file, const IniStamp& stamp)
+    {
+        ConfigSnapshot::View view;
+        return view.Open(file.data(), file.size(), stamp);
+    }
+
+    void TestRoundTrip()
+    {
+        const IniStamp stamp = MakeStamp();
+        const std::string file = MakeSnapshot(stamp);
+
+        ConfigSnapshot::View view;
+        CHECK(view.Open(file.data(), file.size(), stamp));
+        const ConfigSnapshot::Header& header = view.GetHeader();
+        CHECK(header.globalCount == 3 && header.profileCount == 4);
+
+        const ConfigSnapshot::GlobalRecord globals[] = { view.GetGlobal(0), view.GetGlobal(1), view.GetGlobal(2) };
+        CHECK(globals[0].key == (uint32_t)Key::ToggleHotkey && globals[0].value == 0x170);
+        CHECK(globals[1].key == (uint32_t)Key::TransitionMs && globals[1].value == 300);
+        CHECK(globals[2].key == (uint32_t)Key::SelectedDisplay && globals[2].value == -1);
+
+        CHECK(header.simpleFields == (ConfigSnapshot::SIMPLE_BRIGHTNESS | ConfigSnapshot::SIMPLE_GAMMA));
+        CHECK(header.simpleBrightness == -20 && header.simpleContrast == 1.0f && header.simpleGamma == 0.9f);
+
+        for (uint32_t index = 0; index < header.profileCount; ++index)
+        {
+            const TestProfile& expected = PROFILES[index];
+            const ConfigSnapshot::ProfileRecord profile = view.GetProfile(index);
+            std::wstring name = L"prefix:";
+            view.AppendName(profile, name);
+            CHECK_MSG(name == L"prefix:" + expected.name && profile.brightness == expected.brightness &&
+                      profile.contrast == expected.contrast && profile.gamma == expected.gamma &&
+                      profile.hotkey == expected.hotkey, "profile %u", index);
+        }
+
+        // An empty snapshot (no globals, no profiles) is valid too.
+        std::string empty;
+        ConfigSnapshot::Builder().Finish(stamp, empty);
+        CHECK(empty.size() == sizeof(ConfigSnapshot::Header) && Opens(empty, stamp));
+    }
+
+    // A snapshot of any other ini is never used, however close.
+    void TestStampMismatch()
+    {
+        const IniStamp stamp = MakeStamp();
+        const std::string file = MakeSnapshot(stamp);
+
+        IniStamp other = stamp;
+        other.size += 1;
+        CHECK(!Opens(file, other));
+        other = stamp;
+        other.writeTime += 1;
+        CHECK(!Opens(file, other));
+        other = stamp;
+        other.hash ^= 1;
+        CHECK(!Opens(file, other));
+        CHECK(Opens(file, stamp));
+    }
+
+    // A write cut short at any length, or a file with anything after it, is rejected.
+    void TestTruncation()
+    {
+        const IniStamp stamp = MakeStamp();
+        const std::string file = MakeSnapshot(stamp);
+
+        int accepted = 0;
+        for (size_t length = 0; length < file.size(); ++length)
+        {
+            if (Opens(file.substr(0, length), stamp) && ++accepted <= 5)
+                CHECK_MSG(false, "truncated to %zu of %zu bytes and accepted", length, file.size());
+        }
+        CHECK(accepted == 0);
+        CHECK(!Opens(file + '\0', stamp));
+
+        ConfigSnapshot::View view;
+        CHECK(!view.Open(nullptr, 0, stamp));
+    }
+
+    // A damaged byte anywhere, header included, is rejected.
+    void TestDamage()
+    {
+        const IniStamp stamp = MakeStamp();
+        const std::string file = MakeSnapshot(stamp);
+
+        int accepted = 0;
+        for (size_t offset = 0; offset < file.size(); ++offset)
+        {
+            for (const unsigned char flip : { 0x01, 0x80 })
+            {
+                std::string damaged = file;
+                damaged[offset] = (char)(damaged[offset] ^ flip);
+                if (Opens(damaged, stamp) && ++accepted <= 5)
+                    CHECK_MSG(false, "byte %zu ^ 0x%02X accepted", offset, flip);
+            }
+        }
+        CHECK(accepted == 0);
+
+        // Another version is not read, even with a hash that matches.
+        std::string older = file;
+        ConfigSnapshot::Header header;
+        std::memcpy(&header, older.data(), sizeof(header));
+        header.version = ConfigSnapshot::VERSION - 1;
+        header.fileHash = 0;
+        std::memcpy(older.data(), &header, sizeof(header));
+        header.fileHash = HashConfigBytes(older);
+        std::memcpy(older.data(), &header, sizeof(header));
+        CHECK(!Opens(older, stamp));
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestStampMismatch();
+    TestTruncation();
+    TestDamage();
+    return Check::Result();
+}
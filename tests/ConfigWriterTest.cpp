@@ -0,0 +1,196 @@
+// Copyright (c) 2025 Max Godman
+
+// ConfigWriter against ConfigParser: what is written reads back as the same values.
+
+/**
+ * The format has no escape syntax. A value runs from the first '=' to the end of the line, trimmed,
+ * so '=', ';', '#' and brackets inside a value survive, and line breaks and surrounding spaces do
+ * not; ConfigManager::SanitizeProfileName keeps names within what survives. Names are UTF-8 on disk.
+ */
+
+#include "Check.h"
+#include "ConfigParser.h"
+#include "ConfigWriter.h"
+#include "GammaHotkeyTypes.h"
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using ConfigParser::Key;
+using ConfigParser::Section;
+
+namespace
+{
+    // UTF-8 to wchar_t code units (UTF-16 where wchar_t is 16-bit, UTF-32 elsewhere). Input is
+    // trusted: it comes from ConfigWriter.
+    std::wstring Decode(const std::string_view text)
+    {
+        std::wstring out;
+        for (size_t i = 0; i < text.size();)
+        {
+            const uint8_t lead = (uint8_t)text[i];
+            const int length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+            uint32_t codePoint = length == 1 ? lead : lead & (0xFF >> (length + 1));
+            for (int k = 1; k < length; ++k)
+                codePoint = (codePoint << 6) | ((uint8_t)text[i + k] & 0x3F);
+            i += length;
+
+            if (sizeof(wchar_t) == 2 && codePoint >= 0x10000)
+            {
+                out += (wchar_t)(0xD800 + ((codePoint - 0x10000) >> 10));
+                out += (wchar_t)(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+            }
+            else
+            {
+                out += (wchar_t)codePoint;
+            }
+        }
+        return out;
+    }
+
+    // A name's UTF-8 spelling and the value it reads back as.
+    std::wstring RoundTripName(const std::wstring& name, std::string* written = nullptr)
+    {
+        std::string text;
+        ConfigWriter out(text);
+        out.Section(Section::Profile);
+        out.String(Key::Name, name);
+        if (written)
+            *written = text;
+
+        std::wstring read = L"<missing>";
+        ConfigParser::Parse(text, [&](const ConfigParser::Entry& entry)
+        {
+            if (entry.key == Key::Name)
+                read = Decode(entry.value);
+        });
+        return read;
+    }
+
+    std::wstring Emoji()
+    {
+        // U+1F319, a character outside the BMP: a surrogate pair in UTF-16.
+        if (sizeof(wchar_t) == 2)
+            return std::wstring{ (wchar_t)0xD83C, (wchar_t)0xDF19 };
+        return std::wstring(1, (wchar_t)0x1F319);
+    }
+
+    void TestNames()
+    {
+        const std::wstring names[] = {
+            L"Night",
+            L"Lecture \u00e9t\u00e9",           // Two-byte UTF-8.
+            L"\u591c\u9593\u30e2\u30fc\u30c9",  // Three-byte UTF-8.
+            L"Moon " + Emoji(),                 // Four-byte UTF-8.
+            L"a=b; c#d [e]",                    // Format characters inside a value.
+            L"x",
+        };
+        for (const std::wstring& name : names)
+            CHECK_MSG(RoundTripName(name) == name, "name of %zu units", name.size());
+
+        std::string written;
+        RoundTripName(L"\u00e9" + Emoji(), &written);
+        CHECK(written == "[Profile]\r\nName=\xC3\xA9\xF0\x9F\x8C\x99\r\n");
+
+        // Surrounding spaces are trimmed on read (which is why names are trimmed when sanitized).
+        CHECK(RoundTripName(L"  Padded \t") == L"Padded");
+
+        // An unpaired surrogate is written as U+FFFD, as WideCharToMultiByte does.
+        const std::wstring unpaired{ L'a', (wchar_t)0xD800, L'b' };
+        CHECK(RoundTripName(unpaired) == L"a\uFFFDb");
+    }
+
+    // Every contrast and gamma a slider or hotkey can reach. Six significant digits do not always
+    // pin the float down, so one may read back a unit in the last place away; but it writes the same
+    // text again, so a save of a loaded config does not drift.
+    void TestSliderFloats()
+    {
+        std::vector<float> values;
+        for (int k = 0; k <= 290; ++k)
+        {
+            values.push_back(ProfileRange::GAMMA_MIN + k * 0.01f);
+            if (k <= 100)
+                values.push_back(ProfileRange::CONTRAST_MIN + k * 0.01f);
+        }
+
+        int mismatches = 0;
+        for (const float value : values)
+        {
+            std::string text;
+            ConfigWriter(text).Float(Key::Gamma, value);
+
+            float read = 0.0f;
+            ConfigParser::Parse("[Profile]\n" + text, [&](const ConfigParser::Entry& entry)
+            {
+                if (entry.key == Key::Gamma)
+                    ConfigParser::ParseFloat(entry.value, read);
+            });
+
+            std::string again;
+            ConfigWriter(again).Float(Key::Gamma, read);
+            const bool nearest = read == value || read == std::nextafter(value, 0.0f) || read == std::nextafter(value, 4.0f);
+            if (!nearest || again != text)
+                ++mismatches;
+        }
+        CHECK_MSG(mismatches == 0, "%d of %zu slider values", mismatches, values.size());
+    }
+
+    // Other values: integers exactly, floats to the six significant digits written.
+    void TestValues()
+    {
+        const int ints[] = { 0, -50, 50, 1, -1, 2147483647, -2147483647 - 1, (int)HotkeyCode::Make(0x7B, MOD_CONTROL | MOD_WIN) };
+        const float floats[] = { 0.0f, 1.0f, 0.123456789f, 3.14159265f, 1e-7f, 12345678.0f, -2.5f };
+
+        std::string text;
+        ConfigWriter out(text);
+        out.Comment("GammaHotkey configuration");
+        out.Section(Section::GlobalHotkeys);
+        for (const int value : ints)
+            out.Int(Key::ToggleHotkey, value);
+        out.Bool(Key::LoopProfiles, true);
+        out.Bool(Key::LoopProfiles, false);
+        out.BlankLine();
+        out.Section(Section::SimpleProfile);
+        for (const float value : floats)
+            out.Float(Key::Contrast, value);
+
+        std::vector<int> readInts;
+        std::vector<float> readFloats;
+        ConfigParser::Parse(text, [&](const ConfigParser::Entry& entry)
+        {
+            int number = 0;
+            float value = 0.0f;
+            if ((entry.key == Key::ToggleHotkey || entry.key == Key::LoopProfiles) && ConfigParser::ParseInt(entry.value, number))
+                readInts.push_back(number);
+            else if (entry.key == Key::Contrast && ConfigParser::ParseFloat(entry.value, value))
+                readFloats.push_back(value);
+        });
+
+        const size_t intCount = sizeof(ints) / sizeof(ints[0]);
+        CHECK(readInts.size() == intCount + 2);
+        for (size_t index = 0; index < intCount && index < readInts.size(); ++index)
+            CHECK_MSG(readInts[index] == ints[index], "int %d", ints[index]);
+        CHECK(readInts.size() == intCount + 2 && readInts[intCount] == 1 && readInts[intCount + 1] == 0);
+
+        CHECK(readFloats.size() == sizeof(floats) / sizeof(floats[0]));
+        for (size_t index = 0; index < readFloats.size(); ++index)
+        {
+            const float expected = floats[index];
+            CHECK_MSG(std::fabs(readFloats[index] - expected) <= std::fabs(expected) * 5e-6f, "float %g read as %g",
+                      expected, readFloats[index]);
+        }
+
+        // Lines end in CRLF, so the buffer is byte for byte the file.
+        CHECK(text.compare(0, 30, "; GammaHotkey configuration\r\n[") == 0);
+        CHECK(text.find('\n') == text.find("\r\n") + 1);
+    }
+}
+
+int main()
+{
+    TestNames();
+    TestSliderFloats();
+    TestValues();
+    return Check::Result();
+}
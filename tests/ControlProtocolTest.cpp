@@ -0,0 +1,155 @@
+// Copyright (c) 2025 Max Godman
+
+// The control pipe's line protocol: framing of what a client sends, and parsing of each request.
+
+#include "Check.h"
+#include "ControlProtocol.h"
+#include <cstring>
+
+using ControlProtocol::Op;
+using ControlProtocol::Request;
+
+namespace
+{
+    bool IsInvalid(const std::string_view line)
+    {
+        const Request request = ControlProtocol::ParseRequest(line);
+        return request.op == Op::Invalid && request.error != nullptr && std::strlen(request.error) > 0;
+    }
+
+    // Lines split across reads come out whole, once their end arrives, whatever the split.
+    void TestPartialLines()
+    {
+        const std::string stream = "apply Night\nget\nset b=-10 c=1.05\n";
+        for (size_t split = 0; split <= stream.size(); ++split)
+        {
+            std::string buffer;
+            std::vector<std::string> lines;
+            buffer += stream.substr(0, split);
+            CHECK(ControlProtocol::TakeLines(buffer, lines));
+            buffer += stream.substr(split);
+            CHECK(ControlProtocol::TakeLines(buffer, lines));
+
+            CHECK_MSG(lines.size() == 3 && lines[0] == "apply Night" && lines[1] == "get" &&
+                      lines[2] == "set b=-10 c=1.05" && buffer.empty(), "split at %zu", split);
+        }
+
+        // An unfinished line waits in the buffer.
+        std::string buffer = "get\nli";
+        std::vector<std::string> lines;
+        CHECK(ControlProtocol::TakeLines(buffer, lines));
+        CHECK(lines.size() == 1 && buffer == "li");
+    }
+
+    // CRLF ends a line as LF does, and an empty line is still a line (an invalid request).
+    void TestLineEndings()
+    {
+        std::string buffer = "get\r\n\r\nlist\n";
+        std::vector<std::string> lines;
+        CHECK(ControlProtocol::TakeLines(buffer, lines));
+        CHECK(lines.size() == 3 && lines[0] == "get" && lines[1].empty() && lines[2] == "list");
+        CHECK(IsInvalid(lines[1]));
+
+        // A CR split from its LF by a read is still dropped.
+        buffer = "sync\r";
+        lines.clear();
+        CHECK(ControlProtocol::TakeLines(buffer, lines));
+        CHECK(lines.empty());
+        buffer += "\n";
+        CHECK(ControlProtocol::TakeLines(buffer, lines));
+        CHECK(lines.size() == 1 && lines[0] == "sync");
+    }
+
+    // A line longer than MAX_LINE closes the connection before it ends, and is refused if it does end.
+    void TestOverLongLine()
+    {
+        std::string buffer(ControlProtocol::MAX_LINE, 'a');
+        std::vector<std::string> lines;
+        CHECK(ControlProtocol::TakeLines(buffer, lines));
+        buffer += 'a';
+        CHECK(!ControlProtocol::TakeLines(buffer, lines));
+        CHECK(lines.empty());
+
+        const std::string longLine = "apply " + std::string(ControlProtocol::MAX_LINE, 'x');
+        CHECK(IsInvalid(longLine));
+        CHECK(ControlProtocol::ParseRequest("apply " + std::string(ControlProtocol::MAX_LINE - 6, 'x')).op == Op::Apply);
+    }
+
+    void TestVerbs()
+    {
+        const struct { const char* line; Op op; } VERBS[] = {
+            { "on", Op::On }, { "OFF", Op::Off }, { "Toggle", Op::Toggle }, { "get", Op::Get },
+            { "list", Op::List }, { "sync", Op::Sync }, { "trace", Op::Trace }, { "stats", Op::Stats },
+            { "  get  ", Op::Get }, { "\tsync", Op::Sync },
+        };
+        for (const auto& verb : VERBS)
+            CHECK_MSG(ControlProtocol::ParseRequest(verb.line).op == verb.op, "\"%s\"", verb.line);
+
+        CHECK(IsInvalid(""));
+        CHECK(IsInvalid("   "));
+        CHECK(IsInvalid("frobnicate"));
+        CHECK(IsInvalid("getx"));
+        CHECK(IsInvalid("get now"));
+        CHECK(IsInvalid("on 1"));
+    }
+
+    void TestApply()
+    {
+        Request request = ControlProtocol::ParseRequest("apply  Movie Night ");
+        CHECK(request.op == Op::Apply && request.name == "Movie Night");
+
+        request = ControlProtocol::ParseRequest("apply-id 12");
+        CHECK(request.op == Op::ApplyId && request.value == 12);
+
+        CHECK(IsInvalid("apply"));
+        CHECK(IsInvalid("apply   "));
+        CHECK(IsInvalid("apply-id"));
+        CHECK(IsInvalid("apply-id 0"));
+        CHECK(IsInvalid("apply-id -3"));
+        CHECK(IsInvalid("apply-id 3x"));
+        CHECK(IsInvalid("apply-id 99999999999"));
+    }
+
+    void TestTransition()
+    {
+        const Request request = ControlProtocol::ParseRequest("transition 300");
+        CHECK(request.op == Op::Transition && request.value == 300);
+
+        // Range is checked by the caller, not the parser.
+        CHECK(ControlProtocol::ParseRequest("transition -1").op == Op::Transition);
+
+        CHECK(IsInvalid("transition"));
+        CHECK(IsInvalid("transition fast"));
+        CHECK(IsInvalid("transition 300ms"));
+        CHECK(IsInvalid("transition 1.5"));
+    }
+
+    void TestSet()
+    {
+        Request request = ControlProtocol::ParseRequest("set b=-10 C=1.05 gamma=2.2");
+        CHECK(request.op == Op::Set && request.hasBrightness && request.hasContrast && request.hasGamma);
+        CHECK(request.brightness == -10 && request.contrast == 1.05f && request.gamma == 2.2f);
+
+        request = ControlProtocol::ParseRequest("set g=0.8");
+        CHECK(request.op == Op::Set && !request.hasBrightness && !request.hasContrast && request.hasGamma);
+
+        CHECK(IsInvalid("set"));
+        CHECK(IsInvalid("set b"));
+        CHECK(IsInvalid("set b="));
+        CHECK(IsInvalid("set b=1.5"));
+        CHECK(IsInvalid("set c=abc"));
+        CHECK(IsInvalid("set x=1"));
+    }
+}
+
+int main()
+{
+    TestPartialLines();
+    TestLineEndings();
+    TestOverLongLine();
+    TestVerbs();
+    TestApply();
+    TestTransition();
+    TestSet();
+    return Check::Result();
+}
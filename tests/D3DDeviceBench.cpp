@@ -0,0 +1,141 @@
+// Copyright (c) 2025 Max Godman
+
+// Windows only: the D3D11 device and swap chain, created and destroyed as often as the renderer is.
+
+/**
+ * The renderer is released once the window has been hidden for a while and created again when it
+ * is shown (see main.cpp), so over a session the device is built and torn down many times. This
+ * does what ImGuiRenderer::CreateDeviceD3D and CleanupDeviceD3D do, on a hidden window, times each
+ * cycle, and fails if a device is still referenced after cleanup. It prints the process's private
+ * bytes after warm-up, halfway and at the end, which should stay flat.
+ *
+ *   d3ddevice_bench [cycles, default 200]
+ */
+
+#include "framework.h"
+#include "Bench.h"
+#include <d3d11.h>
+#include <psapi.h>
+#include <cstdlib>
+
+namespace
+{
+    struct Device
+    {
+        IDXGISwapChain* swapChain = nullptr;
+        ID3D11Device* device = nullptr;
+        ID3D11DeviceContext* context = nullptr;
+        ID3D11RenderTargetView* renderTarget = nullptr;
+    };
+
+    // ImGuiRenderer::CleanupDeviceD3D. @return The device's references left after its release.
+    ULONG Destroy(Device& device)
+    {
+        if (device.renderTarget)
+            device.renderTarget->Release();
+        device.swapChain->Release();
+        device.context->ClearState();
+        device.context->Flush();
+        device.context->Release();
+        const ULONG references = device.device->Release();
+        device = Device();
+        return references;
+    }
+
+    // ImGuiRenderer::CreateDeviceD3D and CreateRenderTarget.
+    bool Create(const HWND window, Device& out)
+    {
+        DXGI_SWAP_CHAIN_DESC desc = {};
+        desc.BufferCount = 2;
+        desc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.BufferDesc.RefreshRate.Numerator = 60;
+        desc.BufferDesc.RefreshRate.Denominator = 1;
+        desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        desc.OutputWindow = window;
+        desc.SampleDesc.Count = 1;
+        desc.Windowed = TRUE;
+        desc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+
+        D3D_FEATURE_LEVEL featureLevel;
+        const D3D_FEATURE_LEVEL featureLevels[2] = { D3D_FEATURE_LEVEL_11_0, D3D_FEATURE_LEVEL_10_0 };
+        if (D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, featureLevels, 2,
+                D3D11_SDK_VERSION, &desc, &out.swapChain, &out.device, &featureLevel, &out.context) != S_OK)
+            return false;
+
+        ID3D11Texture2D* backBuffer = nullptr;
+        if (out.swapChain->GetBuffer(0, IID_PPV_ARGS(&backBuffer)) == S_OK)
+        {
+            out.device->CreateRenderTargetView(backBuffer, nullptr, &out.renderTarget);
+            backBuffer->Release();
+        }
+        if (!out.renderTarget)
+        {
+            Destroy(out);
+            return false;
+        }
+
+        // A frame's worth of use, so the context has state bound when it is torn down.
+        const float clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+        out.context->OMSetRenderTargets(1, &out.renderTarget, nullptr);
+        out.context->ClearRenderTargetView(out.renderTarget, clearColor);
+        out.swapChain->Present(0, 0);
+        return true;
+    }
+
+    size_t PrivateBytes()
+    {
+        PROCESS_MEMORY_COUNTERS_EX memory = {};
+        memory.cb = sizeof(memory);
+        GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&memory, sizeof(memory));
+        return memory.PrivateUsage;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int cycles = argc > 1 ? std::max(1, atoi(argv[1])) : 200;
+
+    WNDCLASSEXW windowClass = { sizeof(windowClass), 0, DefWindowProcW, 0, 0, GetModuleHandleW(nullptr) };
+    windowClass.lpszClassName = L"D3DDeviceBench";
+    RegisterClassExW(&windowClass);
+    const HWND window = CreateWindowW(windowClass.lpszClassName, L"D3DDeviceBench", WS_OVERLAPPEDWINDOW, 0, 0,
+                                      640, 480, nullptr, nullptr, windowClass.hInstance, nullptr);
+    if (!window)
+    {
+        fprintf(stderr, "Could not create a window.\n");
+        return 1;
+    }
+
+    // The first cycles load the driver and grow its caches; measure growth after them.
+    Device device;
+    for (int warmup = 0; warmup < 10 && Create(window, device); ++warmup)
+        Destroy(device);
+    const size_t startBytes = PrivateBytes();
+
+    int failed = 0;
+    int leaked = 0;
+    size_t halfwayBytes = startBytes;
+    int cycle = 0;
+    Bench::Measure("create + destroy", cycles, [&]()
+    {
+        if (!Create(window, device))
+        {
+            ++failed;
+            return;
+        }
+        leaked += Destroy(device) != 0;
+        if (++cycle == cycles / 2)
+            halfwayBytes = PrivateBytes();
+    });
+    const size_t endBytes = PrivateBytes();
+
+    printf("private bytes: %.1f MB after warm-up, %.1f MB halfway, %.1f MB at the end\n",
+           startBytes / (1024.0 * 1024.0), halfwayBytes / (1024.0 * 1024.0), endBytes / (1024.0 * 1024.0));
+    if (failed)
+        fprintf(stderr, "%d of %d devices could not be created.\n", failed, cycles);
+    if (leaked)
+        fprintf(stderr, "%d of %d devices were still referenced after cleanup.\n", leaked, cycles);
+
+    DestroyWindow(window);
+    return failed == 0 && leaked == 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2025 Max Godman
+
+// Windows only: the cost of one ramp write with a device context per call versus a kept one.
+
+/**
+ * Before Win32GammaBackend kept one context per display, every apply did CreateDC,
+ * SetDeviceGammaRamp and DeleteDC. This times that sequence against Win32GammaBackend::WriteRamp on
+ * the same display, writing the ramp the display already has so the screen does not change.
+ *
+ *   devicecontext_bench [display index, default 0] [writes, default 500]
+ */
+
+#include "framework.h"
+#include "Bench.h"
+#include "Win32GammaBackend.h"
+#include <cstdlib>
+
+int main(int argc, char** argv)
+{
+    const int displayIndex = argc > 1 ? atoi(argv[1]) : 0;
+    const int writes = argc > 2 ? std::max(1, atoi(argv[2])) : 500;
+
+    Win32GammaBackend backend;
+    const std::vector<GammaDisplayInfo> displays = backend.Enumerate();
+    if (displayIndex < 0 || displayIndex >= (int)displays.size())
+    {
+        fprintf(stderr, "No display %d (%zu found).\n", displayIndex, displays.size());
+        return 1;
+    }
+    wprintf(L"%ls (%ls), %d writes each\n", displays[displayIndex].friendlyName.c_str(),
+            displays[displayIndex].deviceName.c_str(), writes);
+
+    WORD ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE];
+    if (!backend.ReadRamp(displayIndex, ramp))
+    {
+        fprintf(stderr, "Could not read the display's ramp.\n");
+        return 1;
+    }
+
+    const wchar_t* deviceName = displays[displayIndex].deviceName.c_str();
+    bool ok = true;
+
+    Bench::Measure("CreateDC per write", writes, [&]()
+    {
+        const HDC hdc = CreateDC(NULL, deviceName, NULL, NULL);
+        ok = hdc && SetDeviceGammaRamp(hdc, ramp) && ok;
+        if (hdc)
+            DeleteDC(hdc);
+    });
+
+    Bench::Measure("kept context (WriteRamp)", writes, [&]()
+    {
+        ok = backend.WriteRamp(displayIndex, ramp) && ok;
+    });
+
+    if (!ok)
+        fprintf(stderr, "Some writes failed; the driver may refuse gamma ramps on this display.\n");
+    return ok ? 0 : 1;
+}
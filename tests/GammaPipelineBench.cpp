@@ -0,0 +1,128 @@
+// Copyright (c) 2025 Max Godman
+
+// Throughput and latency of the apply pipeline against FakeGammaBackend, with simulated driver latency.
+
+/**
+ * First, building a ramp (BuildCurve then CurveToRamp) with each RampEngine::PowMode, and how far
+ * Fast lands from Exact; the builds are timed in batches, as one takes a few microseconds.
+ * Then, for each simulated driver write latency:
+ *   post      one GammaWorker::Post, i.e. what the UI thread pays per apply.
+ *   applied   Post to one display, then Flush: until the ramp is on the display.
+ *   fan-out   Post to every display, then Flush: "all displays", written in parallel.
+ * and how many of a burst of posts actually reached the driver.
+ *
+ *   gammapipeline_bench [displays, default 4] [runs, default 200]
+ */
+
+#include "Bench.h"
+#include "FakeGammaBackend.h"
+#include "GammaWorker.h"
+#include <cstdlib>
+
+using Ramp = uint16_t[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE];
+
+static FakeGammaBackend* s_backend = nullptr;
+
+static bool Write(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const bool)
+{
+    return s_backend->WriteRamp(displayIndex, ramp);
+}
+
+// Each run builds a ramp per gamma slider step, so every build computes a different curve.
+static void MeasureBuilds(const int runs)
+{
+    constexpr int BATCH = 100;
+    printf("ramp build, %s kernel, %d builds per run\n", RampEngine::GetKernelName(RampEngine::GetActiveKernel()), BATCH);
+
+    Ramp built[2][BATCH];
+    for (const RampEngine::PowMode mode : { RampEngine::PowMode::Exact, RampEngine::PowMode::Fast })
+    {
+        RampEngine::SetPowMode(mode);
+        Ramp* out = built[mode == RampEngine::PowMode::Fast];
+
+        char label[32];
+        snprintf(label, sizeof(label), "  build (%s)", RampEngine::GetPowModeName(mode));
+        Bench::Measure(label, runs, [&]()
+        {
+            for (int index = 0; index < BATCH; ++index)
+            {
+                RampEngine::Params params;
+                params.gamma = 0.5f + index * 0.02f;
+                float curve[RampEngine::RAMP_SIZE];
+                RampEngine::BuildCurve(params, curve);
+                RampEngine::CurveToRamp(curve, out[index]);
+            }
+        });
+    }
+    RampEngine::SetPowMode(RampEngine::PowMode::Exact);
+
+    int differing = 0;
+    int largest = 0;
+    for (int index = 0; index < BATCH; ++index)
+    {
+        for (int entry = 0; entry < RampEngine::RAMP_SIZE; ++entry)
+        {
+            const int step = std::abs((int)built[0][index][0][entry] - (int)built[1][index][0][entry]);
+            differing += step != 0;
+            largest = std::max(largest, step);
+        }
+    }
+    printf("  Fast vs Exact: %d of %d entries differ, by at most %d\n", differing, BATCH * RampEngine::RAMP_SIZE, largest);
+}
+
+int main(int argc, char** argv)
+{
+    const int displayCount = argc > 1 ? std::max(1, atoi(argv[1])) : 4;
+    const int runs = argc > 2 ? std::max(1, atoi(argv[2])) : 200;
+
+    MeasureBuilds(runs);
+
+    Ramp ramps[2];
+    for (int index = 0; index < 2; ++index)
+    {
+        RampEngine::Params params;
+        params.brightness = index == 0 ? -20 : 20;
+        float curve[RampEngine::RAMP_SIZE];
+        RampEngine::BuildCurve(params, curve);
+        RampEngine::CurveToRamp(curve, ramps[index]);
+    }
+
+    for (const int latencyUs : { 0, 100, 1000 })
+    {
+        printf("%d displays, write latency %d us\n", displayCount, latencyUs);
+
+        FakeGammaBackend backend(displayCount);
+        backend.SetLatency(std::chrono::microseconds(0), std::chrono::microseconds(latencyUs));
+        s_backend = &backend;
+        backend.Enumerate();
+        GammaWorker::Start(std::vector<int>(displayCount, 60), Write, nullptr);
+
+        int next = 0;
+        Bench::Measure("  post", runs, [&]() { GammaWorker::Post(0, ramps[next++ & 1], false); });
+        GammaWorker::Flush();
+
+        Bench::Measure("  applied", runs, [&]()
+        {
+            GammaWorker::Post(0, ramps[next++ & 1], false);
+            GammaWorker::Flush();
+        });
+
+        Bench::Measure("  fan-out", runs, [&]()
+        {
+            for (int index = 0; index < displayCount; ++index)
+                GammaWorker::Post(index, ramps[next & 1], false);
+            ++next;
+            GammaWorker::Flush();
+        });
+
+        backend.ClearCalls();
+        const int burst = 1000;
+        for (int post = 0; post < burst; ++post)
+            GammaWorker::Post(0, ramps[post & 1], false);
+        GammaWorker::Flush();
+        printf("  burst of %d posts: %zu written\n", burst, backend.GetWriteCount(0));
+
+        GammaWorker::Stop();
+    }
+    return 0;
+}
@@ -0,0 +1,353 @@
+// Copyright (c) 2025 Max Godman
+
+// The apply pipeline headless: GammaWorker writing through FakeGammaBackend.
+
+#include "ApplyOutcome.h"
+#include "Check.h"
+#include "FakeGammaBackend.h"
+#include "GammaWorker.h"
+#include "RedrawPolicy.h"
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <mutex>
+
+using Ramp = uint16_t[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE];
+
+namespace
+{
+    // GammaWorker takes a plain function, as GammaManager passes it; this is the backend it writes to.
+    FakeGammaBackend* s_backend = nullptr;
+
+    bool Write(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE], const bool)
+    {
+        return s_backend->WriteRamp(displayIndex, ramp);
+    }
+
+    bool Read(const int displayIndex, uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE])
+    {
+        return s_backend->ReadRamp(displayIndex, ramp);
+    }
+
+    // GammaManager's WriteFunc: the outcome updated under its lock, and a count of the
+    // WM_APPLY_RESULT messages it would post to the window.
+    ApplyOutcome s_outcome;
+    std::mutex s_outcomeMutex;
+    std::atomic<int> s_resultMessages = 0;
+
+    bool ReportingWrite(const int displayIndex, const uint16_t ramp[RampEngine::RAMP_CHANNELS][RampEngine::RAMP_SIZE],
+                        const bool report)
+    {
+        const bool success = s_backend->WriteRamp(displayIndex, ramp);
+        if (!report)
+            return success;
+
+        std::lock_guard<std::mutex> lock(s_outcomeMutex);
+        if (s_outcome.Report(displayIndex, success))
+            ++s_resultMessages;
+        return success;
+    }
+
+    void BuildRamp(const int brightness, Ramp ramp)
+    {
+        RampEngine::Params params;
+        params.brightness = brightness;
+        float curve[RampEngine::RAMP_SIZE];
+        RampEngine::BuildCurve(params, curve);
+        RampEngine::CurveToRamp(curve, ramp);
+    }
+
+    bool DisplayShows(FakeGammaBackend& backend, const int displayIndex, const Ramp expected)
+    {
+        Ramp ramp;
+        return backend.ReadRamp(displayIndex, ramp) && std::memcmp(ramp, expected, sizeof(ramp)) == 0;
+    }
+
+    std::vector<int> RefreshRates(FakeGammaBackend& backend, const size_t displayCount)
+    {
+        std::vector<int> rates;
+        for (int index = 0; index < (int)displayCount; ++index)
+            rates.push_back(backend.GetRefreshRate(index));
+        return rates;
+    }
+
+    // Each display's worker writes the ramp posted to it, and only that.
+    void TestWritesReachTheirDisplay()
+    {
+        FakeGammaBackend backend(3);
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        Ramp ramps[3];
+        for (int index = 0; index < 3; ++index)
+        {
+            BuildRamp(-10 * (index + 1), ramps[index]);
+            CHECK(GammaWorker::Post(index, ramps[index], false));
+        }
+        CHECK(!GammaWorker::Post(3, ramps[0], false));
+        GammaWorker::Flush();
+
+        for (int index = 0; index < 3; ++index)
+        {
+            CHECK(DisplayShows(backend, index, ramps[index]));
+            CHECK(backend.GetWriteCount(index) == 1);
+        }
+        GammaWorker::Stop();
+    }
+
+    // A burst posted while the driver is slow collapses to far fewer writes, ending on the last ramp.
+    void TestBurstCoalesces()
+    {
+        FakeGammaBackend backend(1);
+        backend.SetLatency(std::chrono::microseconds(0), std::chrono::milliseconds(5));
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        const uint64_t coalescedBefore = GammaWorker::GetStats().coalesced;
+        Ramp ramp;
+        const int posts = 50;
+        for (int brightness = 0; brightness < posts; ++brightness)
+        {
+            BuildRamp(-brightness, ramp);
+            GammaWorker::Post(0, ramp, false);
+        }
+        GammaWorker::Flush();
+
+        CHECK(DisplayShows(backend, 0, ramp));
+        CHECK(backend.GetWriteCount(0) < (size_t)posts);
+        CHECK(GammaWorker::GetStats().coalesced - coalescedBefore + backend.GetWriteCount(0) == (size_t)posts);
+        GammaWorker::Stop();
+    }
+
+    // A rejected write is recorded as failed and leaves the display as it was.
+    void TestRejectedWrite()
+    {
+        FakeGammaBackend backend(1);
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        Ramp identity, ramp;
+        RampEngine::BuildIdentityRamp(identity);
+        BuildRamp(-20, ramp);
+
+        backend.SetWritesFail(0, true);
+        GammaWorker::Post(0, ramp, false);
+        GammaWorker::Flush();
+
+        const std::vector<FakeGammaBackend::Call> calls = backend.GetCalls();
+        CHECK(!calls.empty() && calls.back().type == FakeGammaBackend::CallType::WriteRamp && !calls.back().success);
+        CHECK(DisplayShows(backend, 0, identity));
+        GammaWorker::Stop();
+    }
+
+    // A fade writes one step per frame and lands exactly on the target.
+    void TestTransition()
+    {
+        FakeGammaBackend backend(1);
+        backend.SetRefreshRate(60);
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        Ramp from, to;
+        BuildRamp(-30, from);
+        BuildRamp(20, to);
+        GammaWorker::Post(0, from, false);
+        GammaWorker::Flush();
+        backend.ClearCalls();
+
+        const int transitionMs = 100; // 6 frames at 60 Hz.
+        GammaWorker::Post(0, to, false, transitionMs);
+        GammaWorker::Flush();
+
+        CHECK(DisplayShows(backend, 0, to));
+        CHECK(backend.GetWriteCount(0) == 6);
+        CHECK(GammaWorker::GetStats().lastTransitionWrites == 6);
+
+        // Every step lies between the two ends.
+        Ramp midway;
+        RampEngine::LerpRamp(from, to, 3, 6, midway);
+        const std::vector<FakeGammaBackend::Call> calls = backend.GetCalls();
+        CHECK(calls.size() >= 3 && calls[2].rampHash == RampEngine::HashRamp(midway));
+        GammaWorker::Stop();
+    }
+
+    // A fade right after the workers start runs from what the display showed, read at start.
+    void TestFirstTransitionFadesFromDisplay()
+    {
+        FakeGammaBackend backend(1);
+        backend.SetRefreshRate(60);
+        s_backend = &backend;
+        backend.Enumerate();
+
+        Ramp shown, to;
+        BuildRamp(-30, shown);
+        BuildRamp(20, to);
+        backend.WriteRamp(0, shown); // Left by an earlier run, before these workers existed.
+        backend.ClearCalls();
+
+        GammaWorker::Start(RefreshRates(backend, 1), Write, Read);
+        GammaWorker::Post(0, to, false, 100);
+        GammaWorker::Flush();
+
+        Ramp midway;
+        RampEngine::LerpRamp(shown, to, 3, 6, midway);
+        const std::vector<FakeGammaBackend::Call> calls = backend.GetCalls();
+        CHECK(calls.size() == 7 && calls[0].type == FakeGammaBackend::CallType::ReadRamp);
+        CHECK(calls.size() >= 4 && calls[3].rampHash == RampEngine::HashRamp(midway));
+        CHECK(DisplayShows(backend, 0, to));
+        GammaWorker::Stop();
+    }
+
+    // After a failed write the display's ramp is unknown, so the next post is not faded from it.
+    void TestNoTransitionAfterFailedWrite()
+    {
+        FakeGammaBackend backend(1);
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        Ramp refused, next;
+        BuildRamp(-30, refused);
+        BuildRamp(20, next);
+
+        backend.SetWritesFail(0, true);
+        GammaWorker::Post(0, refused, false);
+        GammaWorker::Flush();
+        backend.SetWritesFail(0, false);
+        backend.ClearCalls();
+
+        GammaWorker::Post(0, next, false, 100);
+        GammaWorker::Flush();
+
+        CHECK(backend.GetWriteCount(0) == 1);
+        CHECK(DisplayShows(backend, 0, next));
+        GammaWorker::Stop();
+    }
+
+    // A display that refuses its ramp on the worker, after the apply drew its frames, still gets the
+    // idle window to redraw with the warning, and again once a later ramp clears it.
+    void TestFailureRedraws()
+    {
+        FakeGammaBackend backend(2);
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), ReportingWrite, Read);
+        s_outcome.Reset(2);
+        s_resultMessages = 0;
+
+        // What main.cpp's loop does with a message, and until it has nothing left to draw.
+        const auto handleMessages = [](const int before)
+        {
+            if (s_resultMessages != before)
+                RedrawPolicy::RequestFrames();
+            return RedrawPolicy::ShouldRender(0);
+        };
+        const auto drawUntilIdle = []()
+        {
+            while (RedrawPolicy::ShouldRender(0))
+                RedrawPolicy::OnFrameRendered(0);
+        };
+
+        Ramp refused, accepted;
+        BuildRamp(-30, refused);
+        BuildRamp(20, accepted);
+
+        // The apply: targets set and frames requested on the UI thread, then drawn before the driver answers.
+        s_outcome.SetTargets(0, 1);
+        RedrawPolicy::RequestFrames();
+        drawUntilIdle();
+
+        backend.SetWritesFail(1, true);
+        GammaWorker::Post(0, refused, true);
+        GammaWorker::Post(1, refused, true);
+        GammaWorker::Flush();
+        CHECK(s_outcome.Failed() && s_resultMessages == 1);
+        CHECK(handleMessages(0));
+        drawUntilIdle();
+
+        backend.SetWritesFail(1, false);
+        GammaWorker::Post(1, accepted, true);
+        GammaWorker::Flush();
+        CHECK(!s_outcome.Failed() && s_resultMessages == 2);
+        CHECK(handleMessages(1));
+        drawUntilIdle();
+
+        // A result that leaves the answer as it was posts nothing, so nothing is drawn.
+        GammaWorker::Post(0, accepted, true);
+        GammaWorker::Flush();
+        CHECK(s_resultMessages == 2 && !handleMessages(2));
+
+        // Nor does a failure on a display the latest apply did not target.
+        s_outcome.SetTargets(0, 0);
+        backend.SetWritesFail(1, true);
+        GammaWorker::Post(1, refused, true);
+        GammaWorker::Flush();
+        CHECK(!s_outcome.Failed() && s_resultMessages == 2);
+        GammaWorker::Stop();
+    }
+
+    // NotifyWhenWritten calls back, without anyone blocking on the workers, once what was posted
+    // before it is on the displays: slow writes and a fade included, and at once when nothing is.
+    void TestNotifyWhenWritten()
+    {
+        FakeGammaBackend backend(2);
+        backend.SetLatency(std::chrono::microseconds(0), std::chrono::milliseconds(5));
+        backend.SetRefreshRate(60);
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        bool called = false;
+        GammaWorker::NotifyWhenWritten([&called]() { called = true; });
+        CHECK(called);
+
+        Ramp first, second;
+        BuildRamp(-25, first);
+        BuildRamp(25, second);
+        GammaWorker::Post(0, first, false);
+        GammaWorker::Post(1, first, false, 100);
+
+        std::promise<void> written;
+        std::atomic<int> calls = 0;
+        GammaWorker::NotifyWhenWritten([&]() { if (++calls == 1) written.set_value(); });
+        const bool done = written.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+        CHECK(done && calls == 1);
+        CHECK(DisplayShows(backend, 0, first) && DisplayShows(backend, 1, first));
+
+        // Stop writes what is pending, so a notification still waiting is not dropped.
+        GammaWorker::Post(0, second, false);
+        GammaWorker::NotifyWhenWritten([&calls]() { ++calls; });
+        GammaWorker::Stop();
+        CHECK(calls == 2 && DisplayShows(backend, 0, second));
+    }
+
+    // Stop writes a ramp still waiting in the mailbox (e.g. the reset on exit) before returning.
+    void TestStopWritesPending()
+    {
+        FakeGammaBackend backend(2);
+        backend.SetLatency(std::chrono::microseconds(0), std::chrono::milliseconds(2));
+        s_backend = &backend;
+        GammaWorker::Start(RefreshRates(backend, backend.Enumerate().size()), Write, Read);
+
+        Ramp ramp;
+        BuildRamp(15, ramp);
+        GammaWorker::Post(0, ramp, false);
+        GammaWorker::Post(1, ramp, false, 5000);
+        GammaWorker::Stop();
+
+        CHECK(!GammaWorker::IsRunning());
+        CHECK(DisplayShows(backend, 0, ramp));
+        CHECK(DisplayShows(backend, 1, ramp));
+    }
+}
+
+int main()
+{
+    TestWritesReachTheirDisplay();
+    TestBurstCoalesces();
+    TestRejectedWrite();
+    TestTransition();
+    TestFirstTransitionFadesFromDisplay();
+    TestNoTransitionAfterFailedWrite();
+    TestFailureRedraws();
+    TestNotifyWhenWritten();
+    TestStopWritesPending();
+    return Check::Result();
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Max Godman
+
+// The UI's ImGui context, created and destroyed as often as the renderer is, leaves nothing behind.
+
+/**
+ * The renderer is created when the window is shown and released once it has been hidden for a
+ * while (see main.cpp), so over a session the ImGui context and its font atlas are built and torn
+ * down many times. Each cycle here does what ImGuiRenderer::Initialize and Shutdown do with ImGui
+ * itself (context, the embedded font, a frame drawn with it) without the Win32 and D3D11 backends,
+ * and counts ImGui's allocations: every one must be freed by DestroyContext, on every cycle.
+ *
+ * Built only when the external/imgui submodule is checked out (see tests/CMakeLists.txt).
+ */
+
+#include "Check.h"
+#include "Font_CascadiaMono.h"
+#include "imgui.h"
+#include <cstdint>
+#include <cstdlib>
+
+namespace
+{
+    constexpr int CYCLES = 200;
+
+    struct Allocations
+    {
+        int64_t live = 0;
+        int64_t total = 0;
+    };
+
+    Allocations s_allocations;
+
+    void* Allocate(const size_t size, void*)
+    {
+        ++s_allocations.live;
+        ++s_allocations.total;
+        return malloc(size);
+    }
+
+    void Free(void* pointer, void*)
+    {
+        if (pointer)
+            --s_allocations.live;
+        free(pointer);
+    }
+
+    // One ImGuiRenderer lifetime. @return The vertices the frame drew, 0 if it drew nothing.
+    int RunCycle()
+    {
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2(800.0f, 600.0f);
+        io.DeltaTime = 1.0f / 60.0f;
+
+        // As the DX11 backend advertises: glyphs are baked on demand, into textures it would upload.
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+        const ImFont* font = io.Fonts->AddFontFromMemoryCompressedTTF(CascadiaMono_compressed_data,
+                                                                      CascadiaMono_compressed_size);
+        CHECK(font != nullptr);
+
+        ImGui::NewFrame();
+        ImGui::Begin("GammaHotkey");
+        ImGui::Text("Brightness %d, contrast %.2f, gamma %.2f", -20, 1.0f, 2.2f);
+        ImGui::TextUnformatted("\xC3\xA9t\xC3\xA9"); // Latin-1 glyphs, in the subset the font embeds.
+        ImGui::End();
+        ImGui::Render();
+        const int vertices = ImGui::GetDrawData()->TotalVtxCount;
+
+        ImGui::DestroyContext();
+        return vertices;
+    }
+}
+
+int main()
+{
+    ImGui::SetAllocatorFunctions(Allocate, Free, nullptr);
+
+    int failures = 0;
+    for (int cycle = 0; cycle < CYCLES; ++cycle)
+    {
+        const int64_t before = s_allocations.total;
+        const int vertices = RunCycle();
+
+        const bool ok = vertices > 0 && s_allocations.live == 0;
+        if (!ok && ++failures <= 5)
+            CHECK_MSG(ok, "cycle %d: %d vertices drawn, %lld of %lld allocations left", cycle, vertices,
+                      (long long)s_allocations.live, (long long)(s_allocations.total - before));
+        s_allocations.live = 0;
+    }
+    CHECK(failures == 0);
+    return Check::Result();
+}
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Max Godman
+
+// Finding profiles by name in large lists: ProfileNameIndex against the linear scan it replaced.
+
+/**
+ * Measures, at 10k and 100k profiles:
+ *   load     the duplicate-name check Load makes as it adds each profile (FinalizeProfile): a scan of
+ *            everything added so far, or a Find and an Add on the index. The scan is quadratic, so it
+ *            is only timed at 10k.
+ *   lookup   one name, in a different case than it was saved with, as the UI and hotkeys look it up.
+ *   rebuild  indexing the whole list again, as after a reload or a delete.
+ * The scan compares case-insensitively code unit by code unit, as _wcsicmp does.
+ *
+ *   profileindex_bench [runs, default 5]
+ */
+
+#include "Bench.h"
+#include "ProfileNameIndex.h"
+#include <cstdlib>
+#include <cwctype>
+#include <string>
+
+namespace
+{
+    std::vector<Profile> MakeProfiles(const int count)
+    {
+        std::vector<Profile> profiles(count);
+        for (int index = 0; index < count; ++index)
+            profiles[index].name = L"Profile " + std::to_wstring(index);
+        return profiles;
+    }
+
+    bool EqualsNoCase(const std::wstring& a, const std::wstring& b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t index = 0; index < a.size(); ++index)
+        {
+            if (std::towlower(a[index]) != std::towlower(b[index]))
+                return false;
+        }
+        return true;
+    }
+
+    // The former ConfigManager::ProfileExists.
+    int FindLinear(const std::vector<Profile>& profiles, const std::wstring& name)
+    {
+        for (size_t slot = 0; slot < profiles.size(); ++slot)
+        {
+            if (EqualsNoCase(profiles[slot].name, name))
+                return (int)slot;
+        }
+        return -1;
+    }
+
+    void LoadLinear(const std::vector<Profile>& source, std::vector<Profile>& profiles)
+    {
+        for (const Profile& profile : source)
+        {
+            if (FindLinear(profiles, profile.name) < 0)
+                profiles.push_back(profile);
+        }
+    }
+
+    void LoadIndexed(const std::vector<Profile>& source, std::vector<Profile>& profiles)
+    {
+        ProfileNameIndex names(profiles);
+        for (const Profile& profile : source)
+        {
+            if (names.Find(profile.name) < 0)
+            {
+                profiles.push_back(profile);
+                names.Add((int)profiles.size() - 1);
+            }
+        }
+    }
+
+    // Names of existing profiles spread over the list, upper-cased.
+    std::vector<std::wstring> MakeQueries(const int count, const int queries)
+    {
+        std::vector<std::wstring> names;
+        uint32_t state = 12345;
+        for (int query = 0; query < queries; ++query)
+        {
+            state = state * 1664525u + 1013904223u;
+            names.push_back(L"PROFILE " + std::to_wstring(state % (uint32_t)count));
+        }
+        return names;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int runs = argc > 1 ? std::max(1, atoi(argv[1])) : 5;
+
+    for (const int count : { 10000, 100000 })
+    {
+        printf("%d profiles\n", count);
+        const std::vector<Profile> source = MakeProfiles(count);
+
+        // Every name twice, the second time in another case: half of them are dropped as duplicates.
+        std::vector<Profile> withDuplicates = source;
+        for (const Profile& profile : source)
+        {
+            withDuplicates.push_back(profile);
+            for (wchar_t& c : withDuplicates.back().name)
+                c = (wchar_t)std::towupper(c);
+        }
+
+        std::vector<Profile> indexed;
+        LoadIndexed(withDuplicates, indexed);
+        if ((int)indexed.size() != count)
+        {
+            fprintf(stderr, "The indexed load kept %zu profiles.\n", indexed.size());
+            return 1;
+        }
+        if (count <= 10000)
+        {
+            std::vector<Profile> linear;
+            LoadLinear(withDuplicates, linear);
+            if (linear.size() != indexed.size())
+            {
+                fprintf(stderr, "The two loads disagree.\n");
+                return 1;
+            }
+            Bench::Measure("  load, linear scan", 1, [&]() { std::vector<Profile> profiles; LoadLinear(withDuplicates, profiles); });
+        }
+        Bench::Measure("  load, index", runs, [&]() { std::vector<Profile> profiles; LoadIndexed(withDuplicates, profiles); });
+
+        ProfileNameIndex names(source);
+        names.Rebuild();
+        const std::vector<std::wstring> queries = MakeQueries(count, 1000);
+        for (const std::wstring& query : queries)
+        {
+            if (names.Find(query) != FindLinear(source, query))
+            {
+                fprintf(stderr, "The index and the scan disagree on a lookup.\n");
+                return 1;
+            }
+        }
+
+        // The results go to a volatile so the lookups are not optimized away.
+        volatile int found = 0;
+        size_t next = 0;
+        Bench::Measure("  lookup, linear scan", 200, [&]() { found = FindLinear(source, queries[next++ % queries.size()]); });
+        Bench::Measure("  lookup, index", 10000, [&]() { found = names.Find(queries[next++ % queries.size()]); });
+        Bench::Measure("  rebuild", runs, [&]() { names.Rebuild(); });
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2025 Max Godman
+
+// Every slider combination: the fast power path against powf, and RampPreflight against its rule.
+
+/**
+ * The grid is every brightness (-50 to 50) with contrast (0.50 to 1.50) and gamma (0.10 to 3.00) in
+ * steps of 0.01, about 3M ramps. For each:
+ *   - PowMode::Fast stays within half a 16-bit ramp step of powf on every entry of the curve, so no
+ *     finished entry moves by more than one step;
+ *   - RampPreflight::Check agrees with the rule it models, entry by entry, at Windows' default range
+ *     and a stricter one, Clamp moves exactly the rejected entries to the nearest accepted value,
+ *     and an unlimited range accepts everything.
+ *
+ * It takes most of a minute per kernel, so ctest labels it "exhaustive" (ctest -LE exhaustive
+ * leaves it out).
+ */
+
+#include "Check.h"
+#include "GammaHotkeyTypes.h"
+#include "RampEngine.h"
+#include "RampPreflight.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using RampEngine::RAMP_CHANNELS;
+using RampEngine::RAMP_MAX;
+using RampEngine::RAMP_SIZE;
+using Ramp = uint16_t[RAMP_CHANNELS][RAMP_SIZE];
+
+namespace
+{
+    // Positions 0.01 apart from min to max inclusive, computed as the step hotkeys compute them
+    // (HotkeyManager's STEP_GRIDS), so the grid holds exactly the floats those reach.
+    int Positions(const float min, const float max)
+    {
+        return (int)std::lround((max - min) * 100.0f) + 1;
+    }
+
+    float Position(const float min, const int k)
+    {
+        return min + k * 0.01f;
+    }
+
+    template <typename F>
+    void ForEachParams(F&& f)
+    {
+        const int contrasts = Positions(ProfileRange::CONTRAST_MIN, ProfileRange::CONTRAST_MAX);
+        const int gammas = Positions(ProfileRange::GAMMA_MIN, ProfileRange::GAMMA_MAX);
+        for (int b = ProfileRange::BRIGHTNESS_MIN; b <= ProfileRange::BRIGHTNESS_MAX; ++b)
+            for (int c = 0; c < contrasts; ++c)
+                for (int g = 0; g < gammas; ++g)
+                {
+                    RampEngine::Params params;
+                    params.brightness = b;
+                    params.contrast = Position(ProfileRange::CONTRAST_MIN, c);
+                    params.gamma = Position(ProfileRange::GAMMA_MIN, g);
+                    f(params);
+                }
+    }
+
+    // The rule RampPreflight models, written out independently: an entry is rejected when its
+    // high byte lies more than maxDeviation from its index.
+    bool Rejected(const int index, const int value, const int maxDeviation)
+    {
+        return maxDeviation < RampPreflight::UNLIMITED_DEVIATION && std::abs((value >> 8) - index) > maxDeviation;
+    }
+
+    // The nearest value the rule accepts: the closest high byte in range, keeping as much of the
+    // entry as that allows.
+    int Nearest(const int index, const int value, const int maxDeviation)
+    {
+        if (!Rejected(index, value, maxDeviation))
+            return value;
+        if ((value >> 8) < index)
+            return (index - maxDeviation) << 8;
+        return ((index + maxDeviation) << 8) | 0xFF;
+    }
+
+    struct PreflightTally
+    {
+        long long mismatches = 0;
+        long long rejectedRamps = 0;
+    };
+
+    void CheckPreflight(const Ramp ramp, const int maxDeviation, PreflightTally& tally)
+    {
+        RampPreflight::Limits limits;
+        limits.maxDeviation = maxDeviation;
+
+        int rejectedEntries = 0;
+        int firstRejectedIndex = RAMP_SIZE;
+        for (int channel = 0; channel < RAMP_CHANNELS; ++channel)
+            for (int index = 0; index < RAMP_SIZE; ++index)
+            {
+                if (Rejected(index, ramp[channel][index], maxDeviation))
+                {
+                    ++rejectedEntries;
+                    firstRejectedIndex = std::min(firstRejectedIndex, index);
+                }
+            }
+
+        const RampPreflight::Report report = RampPreflight::Check(ramp, limits);
+        bool ok = report.accepted == (rejectedEntries == 0) && report.rejectedEntries == rejectedEntries &&
+            report.firstRejectedIndex == (rejectedEntries == 0 ? -1 : firstRejectedIndex);
+
+        Ramp clamped;
+        std::memcpy(clamped, ramp, sizeof(clamped));
+        const bool changed = RampPreflight::Clamp(clamped, limits);
+        ok = ok && changed == (rejectedEntries != 0);
+
+        // Only a rejected ramp has anything to compare: an accepted one must come back untouched.
+        if (rejectedEntries == 0)
+        {
+            ok = ok && std::memcmp(clamped, ramp, sizeof(clamped)) == 0;
+        }
+        else
+        {
+            ++tally.rejectedRamps;
+            for (int channel = 0; channel < RAMP_CHANNELS; ++channel)
+                for (int index = 0; index < RAMP_SIZE; ++index)
+                    ok = ok && clamped[channel][index] == Nearest(index, ramp[channel][index], maxDeviation);
+            ok = ok && RampPreflight::Check(clamped, limits).accepted;
+        }
+
+        if (!ok)
+            ++tally.mismatches;
+    }
+}
+
+int main()
+{
+    printf("Kernel: %s\n", RampEngine::GetKernelName(RampEngine::GetActiveKernel()));
+
+#ifdef RAMPTEST_REQUIRE_AVX2
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        printf("CPU has no AVX2, skipping.\n");
+        return Check::SKIPPED;
+    }
+#endif
+
+    // BuildCurveScalar is the powf reference whatever the mode, so one mode switch serves the run.
+    RampEngine::SetPowMode(RampEngine::PowMode::Fast);
+
+    // Windows' default range, and a stricter one that rejects about two thirds of the grid.
+    const int limits[] = { RampPreflight::DEFAULT_MAX_DEVIATION, 64 };
+    PreflightTally tallies[sizeof(limits) / sizeof(limits[0])];
+    RampPreflight::Limits unlimited;
+    unlimited.maxDeviation = RampPreflight::UNLIMITED_DEVIATION;
+    long long unlimitedRejected = 0;
+
+    long long ramps = 0;
+    long long overHalfStep = 0;
+    long long overOneStep = 0;
+    double maxError = 0.0;
+    RampEngine::Params worst;
+
+    ForEachParams([&](const RampEngine::Params& params)
+    {
+        float exact[RAMP_SIZE], fast[RAMP_SIZE];
+        Ramp exactRamp, fastRamp;
+        RampEngine::BuildCurveScalar(params, exact);
+        RampEngine::BuildCurve(params, fast);
+        RampEngine::CurveToRampScalar(exact, exactRamp);
+        RampEngine::CurveToRampScalar(fast, fastRamp);
+        ++ramps;
+
+        bool halfStep = false;
+        bool oneStep = false;
+        for (int index = 0; index < RAMP_SIZE; ++index)
+        {
+            const double error = std::fabs((double)fast[index] - (double)exact[index]) * RAMP_MAX;
+            if (error > maxError)
+            {
+                maxError = error;
+                worst = params;
+            }
+            halfStep = halfStep || error >= 0.5;
+            oneStep = oneStep || std::abs(fastRamp[0][index] - exactRamp[0][index]) > 1;
+        }
+        overHalfStep += halfStep;
+        overOneStep += oneStep;
+
+        for (size_t limit = 0; limit < sizeof(limits) / sizeof(limits[0]); ++limit)
+            CheckPreflight(exactRamp, limits[limit], tallies[limit]);
+        if (!RampPreflight::Check(exactRamp, unlimited).accepted || RampPreflight::Clamp(exactRamp, unlimited))
+            ++unlimitedRejected;
+    });
+
+    printf("%lld ramps. Fast power: largest error %.4f of a ramp step (b=%d c=%.2f g=%.2f).\n",
+           ramps, maxError, worst.brightness, worst.contrast, worst.gamma);
+    CHECK(ramps == 101LL * 101 * 291);
+    CHECK(overHalfStep == 0);
+    CHECK(overOneStep == 0);
+
+    for (size_t limit = 0; limit < sizeof(limits) / sizeof(limits[0]); ++limit)
+    {
+        printf("Preflight, range %3d: %lld ramps rejected and clamped.\n", limits[limit], tallies[limit].rejectedRamps);
+        CHECK_MSG(tallies[limit].mismatches == 0, "range %d: %lld ramps judged or clamped wrongly",
+                  limits[limit], tallies[limit].mismatches);
+    }
+    CHECK(unlimitedRejected == 0);
+
+    return Check::Result();
+}
@@ -0,0 +1,176 @@
+// Copyright (c) 2025 Max Godman
+
+// RampEngine: the batch kernels against the scalar reference, and both against the original ramp.
+
+#include "Check.h"
+#include "GammaHotkeyTypes.h"
+#include "RampEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+
+using RampEngine::RAMP_CHANNELS;
+using RampEngine::RAMP_SIZE;
+
+namespace
+{
+    // The ramp GammaManager built before RampEngine existed, verbatim: the output every build
+    // must keep producing.
+    void BuildOriginalRamp(const RampEngine::Params& params, float curve[RAMP_SIZE], uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        const float brightnessOffset = params.brightness / 200.0f;
+        for (int i = 0; i < RAMP_SIZE; ++i)
+        {
+            float v = i / 255.0f;
+            v += brightnessOffset;
+            v = (v - 0.5f) * params.contrast + 0.5f;
+            v = std::max(0.0f, std::min(1.0f, v));
+            v = powf(v, 1.0f / params.gamma);
+            curve[i] = v;
+        }
+
+        for (int index = 0; index < RAMP_SIZE; ++index)
+        {
+            const uint16_t val = (uint16_t)(curve[index] * GammaConstants::RAMP_MAX + 0.5f);
+            ramp[0][index] = val;
+            ramp[1][index] = val;
+            ramp[2][index] = val;
+        }
+    }
+
+    // Value k of steps + 1 evenly spaced over [min, max], hitting both ends exactly.
+    float Step(const float min, const float max, const int k, const int steps)
+    {
+        return k == steps ? max : min + (max - min) * k / steps;
+    }
+
+    // Every brightness, and contrast and gamma every 0.05 of their range plus both ends.
+    template <typename F>
+    void ForEachParams(F&& f)
+    {
+        const int contrastSteps = 20;
+        const int gammaSteps = 58;
+        for (int b = ProfileRange::BRIGHTNESS_MIN; b <= ProfileRange::BRIGHTNESS_MAX; ++b)
+            for (int c = 0; c <= contrastSteps; ++c)
+                for (int g = 0; g <= gammaSteps; ++g)
+                {
+                    RampEngine::Params params;
+                    params.brightness = b;
+                    params.contrast = Step(ProfileRange::CONTRAST_MIN, ProfileRange::CONTRAST_MAX, c, contrastSteps);
+                    params.gamma = Step(ProfileRange::GAMMA_MIN, ProfileRange::GAMMA_MAX, g, gammaSteps);
+                    f(params);
+                }
+    }
+
+    bool SameBits(const float a[RAMP_SIZE], const float b[RAMP_SIZE])
+    {
+        return memcmp(a, b, sizeof(float) * RAMP_SIZE) == 0;
+    }
+
+    bool SameRamp(const uint16_t a[RAMP_CHANNELS][RAMP_SIZE], const uint16_t b[RAMP_CHANNELS][RAMP_SIZE])
+    {
+        return memcmp(a, b, sizeof(uint16_t) * RAMP_CHANNELS * RAMP_SIZE) == 0;
+    }
+
+    // Every profile on the grid: reference, batch and original agree on every bit.
+    void TestGridMatchesReference()
+    {
+        RampEngine::SetPowMode(RampEngine::PowMode::Exact);
+
+        int mismatches = 0;
+        ForEachParams([&](const RampEngine::Params& params)
+        {
+            float original[RAMP_SIZE], scalar[RAMP_SIZE], batch[RAMP_SIZE];
+            uint16_t originalRamp[RAMP_CHANNELS][RAMP_SIZE], scalarRamp[RAMP_CHANNELS][RAMP_SIZE], batchRamp[RAMP_CHANNELS][RAMP_SIZE];
+
+            BuildOriginalRamp(params, original, originalRamp);
+            RampEngine::BuildCurveScalar(params, scalar);
+            RampEngine::BuildCurve(params, batch);
+            RampEngine::CurveToRampScalar(scalar, scalarRamp);
+            RampEngine::CurveToRamp(batch, batchRamp);
+
+            const bool ok = SameBits(original, scalar) && SameBits(scalar, batch) &&
+                SameRamp(originalRamp, scalarRamp) && SameRamp(scalarRamp, batchRamp);
+            if (!ok && ++mismatches <= 5)
+                CHECK_MSG(ok, "b=%d c=%.9g g=%.9g", params.brightness, params.contrast, params.gamma);
+        });
+        CHECK(mismatches == 0);
+    }
+
+    // CurveToRamp on its own, over curve values the grid never produces: every float in [0, 1]
+    // near a rounding boundary of a ramp step, and a sweep of the whole range.
+    void TestConversionMatchesReference()
+    {
+        float curve[RAMP_SIZE];
+        uint16_t scalar[RAMP_CHANNELS][RAMP_SIZE], batch[RAMP_CHANNELS][RAMP_SIZE];
+
+        int mismatches = 0;
+        int filled = 0;
+        const auto flush = [&]()
+        {
+            RampEngine::CurveToRampScalar(curve, scalar);
+            RampEngine::CurveToRamp(curve, batch);
+            if (!SameRamp(scalar, batch))
+                ++mismatches;
+            filled = 0;
+        };
+        const auto add = [&](const float v)
+        {
+            curve[filled++] = v;
+            if (filled == RAMP_SIZE)
+                flush();
+        };
+
+        for (int step = 0; step < RampEngine::RAMP_MAX; ++step)
+        {
+            const float boundary = (step + 0.5f) / RampEngine::RAMP_MAX;
+            float v = boundary;
+            for (int k = 0; k < 4; ++k)
+                v = nextafterf(v, 0.0f);
+            for (int k = 0; k < 8 && v <= 1.0f; ++k, v = nextafterf(v, 2.0f))
+                add(v);
+        }
+        for (uint32_t k = 0; k <= (1u << 20); ++k)
+            add(k / float(1u << 20));
+        while (filled != 0)
+            add(1.0f);
+
+        CHECK(mismatches == 0);
+    }
+
+    void TestIdentity()
+    {
+        RampEngine::Params params; // Defaults: no adjustment.
+        float curve[RAMP_SIZE];
+        uint16_t ramp[RAMP_CHANNELS][RAMP_SIZE], identity[RAMP_CHANNELS][RAMP_SIZE];
+
+        RampEngine::BuildCurve(params, curve);
+        RampEngine::CurveToRamp(curve, ramp);
+        RampEngine::BuildIdentityRamp(identity);
+        CHECK(SameRamp(ramp, identity));
+        CHECK(identity[0][255] == RampEngine::RAMP_MAX);
+    }
+}
+
+int main()
+{
+    const RampEngine::Kernel kernel = RampEngine::GetActiveKernel();
+    printf("Kernel: %s\n", RampEngine::GetKernelName(kernel));
+
+#ifdef RAMPTEST_REQUIRE_AVX2
+    // Built with -mavx2 to cover that kernel; only meaningful on a CPU that has it.
+    if (!__builtin_cpu_supports("avx2"))
+    {
+        printf("CPU has no AVX2, skipping.\n");
+        return Check::SKIPPED;
+    }
+    CHECK(kernel == RampEngine::Kernel::AVX2);
+#endif
+
+    TestGridMatchesReference();
+    TestConversionMatchesReference();
+    TestIdentity();
+    return Check::Result();
+}
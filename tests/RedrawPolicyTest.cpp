@@ -0,0 +1,167 @@
+// Copyright (c) 2025 Max Godman
+
+// RedrawPolicy on a simulated clock: how many frames a minute of idle window costs.
+
+/**
+ * Loop below is main.cpp's message loop with the clock and the messages simulated: render while
+ * ShouldRender, otherwise sleep for GetWaitTimeout or until the next input. Each test runs a minute
+ * or more and reads the idle counter back through GetStats, as the control pipe's stats does.
+ * RedrawPolicy is global, so the tests share one clock and compare counters before and after.
+ */
+
+#include "Check.h"
+#include "RedrawPolicy.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    constexpr uint64_t MINUTE_MS = 60000;
+    constexpr uint64_t VSYNC_MS = 16; // Present blocks for a frame at about 60 Hz.
+
+    uint64_t s_now = 1000;
+
+    struct Window
+    {
+        bool visible = true;
+        int animationDelayMs = -1;          // What the renderer asks for after a frame, as GetAnimationDelayMs.
+        std::vector<uint64_t> inputs;       // Times input arrives, ascending.
+    };
+
+    // Run the loop until endMs. Returns the frames rendered.
+    int Run(Window& window, const uint64_t endMs)
+    {
+        int frames = 0;
+        size_t nextInput = 0;
+        while (s_now < endMs)
+        {
+            if (nextInput < window.inputs.size() && window.inputs[nextInput] <= s_now)
+            {
+                RedrawPolicy::OnInput(s_now);
+                ++nextInput;
+                continue;
+            }
+
+            RedrawPolicy::SetVisible(window.visible, s_now);
+            if (window.visible && RedrawPolicy::ShouldRender(s_now))
+            {
+                s_now += VSYNC_MS;
+                RedrawPolicy::OnFrameRendered(s_now);
+                if (window.animationDelayMs >= 0)
+                    RedrawPolicy::RequestFrameIn(s_now, (uint32_t)window.animationDelayMs);
+                ++frames;
+                continue;
+            }
+
+            const uint32_t timeout = window.visible ? RedrawPolicy::GetWaitTimeout(s_now) : RedrawPolicy::NO_TIMEOUT;
+            uint64_t wake = timeout == RedrawPolicy::NO_TIMEOUT ? endMs : s_now + timeout;
+            if (nextInput < window.inputs.size())
+                wake = std::min(wake, window.inputs[nextInput]);
+            s_now = std::max(s_now + 1, std::min(wake, endMs));
+        }
+        return frames;
+    }
+
+    // Idle frames per minute between two readings of the counters.
+    double IdleFramesPerMinute(const RedrawPolicy::Stats& before, const RedrawPolicy::Stats& after)
+    {
+        const uint64_t idleMs = after.idleMs - before.idleMs;
+        return idleMs == 0 ? 0.0 : (after.idleFrames - before.idleFrames) * (double)MINUTE_MS / idleMs;
+    }
+
+    // Input, then a minute untouched: the settle frames after the input, then nothing.
+    void TestIdleMinute()
+    {
+        Window window;
+        window.inputs = { s_now };
+        const RedrawPolicy::Stats before = RedrawPolicy::GetStats(s_now);
+        const int frames = Run(window, s_now + RedrawPolicy::IDLE_AFTER_MS + MINUTE_MS);
+        const RedrawPolicy::Stats after = RedrawPolicy::GetStats(s_now);
+
+        CHECK_MSG(frames <= RedrawPolicy::SETTLE_FRAMES, "%d frames", frames);
+        CHECK(after.frames - before.frames == (uint64_t)frames);
+        CHECK(after.idleMs - before.idleMs == MINUTE_MS);
+        CHECK(after.idleFrames == before.idleFrames);
+        CHECK(RedrawPolicy::GetWaitTimeout(s_now) == RedrawPolicy::NO_TIMEOUT);
+    }
+
+    // A focused text field keeps one frame per caret period, and nothing else.
+    void TestIdleMinuteWithCaret()
+    {
+        Window window;
+        window.animationDelayMs = 200;
+        window.inputs = { s_now };
+        Run(window, s_now + RedrawPolicy::IDLE_AFTER_MS);
+
+        const RedrawPolicy::Stats before = RedrawPolicy::GetStats(s_now);
+        Run(window, s_now + MINUTE_MS);
+        const double perMinute = IdleFramesPerMinute(before, RedrawPolicy::GetStats(s_now));
+
+        const double expected = MINUTE_MS / (double)(window.animationDelayMs + VSYNC_MS);
+        CHECK_MSG(perMinute > expected - 2 && perMinute < expected + 2, "%.1f idle frames a minute", perMinute);
+    }
+
+    // The counter itself: a window drawn every vsync, as before RedrawPolicy, reads about 60 a second.
+    void TestCounterSeesEveryVsync()
+    {
+        Window window;
+        window.animationDelayMs = 0;
+        window.inputs = { s_now };
+        Run(window, s_now + RedrawPolicy::IDLE_AFTER_MS);
+
+        const RedrawPolicy::Stats before = RedrawPolicy::GetStats(s_now);
+        Run(window, s_now + MINUTE_MS);
+        const double perMinute = IdleFramesPerMinute(before, RedrawPolicy::GetStats(s_now));
+
+        const double expected = MINUTE_MS / (double)VSYNC_MS;
+        CHECK_MSG(perMinute > expected - 2 && perMinute < expected + 2, "%.1f idle frames a minute", perMinute);
+    }
+
+    // Frames within IDLE_AFTER_MS of input are not idle, and typing keeps the window from idling.
+    void TestInputIsNotIdle()
+    {
+        Window window;
+        window.animationDelayMs = 200;
+        for (uint64_t at = s_now; at < s_now + MINUTE_MS; at += RedrawPolicy::IDLE_AFTER_MS / 2)
+            window.inputs.push_back(at);
+
+        const RedrawPolicy::Stats before = RedrawPolicy::GetStats(s_now);
+        const int frames = Run(window, s_now + MINUTE_MS);
+        const RedrawPolicy::Stats after = RedrawPolicy::GetStats(s_now);
+
+        CHECK(frames > 0);
+        CHECK(after.idleFrames == before.idleFrames);
+        CHECK(after.idleMs == before.idleMs);
+    }
+
+    // Hidden (minimized, in the tray) is neither rendered nor counted as idle, and showing the
+    // window again draws it.
+    void TestHiddenMinute()
+    {
+        Window window;
+        window.visible = false;
+        window.animationDelayMs = 200;
+
+        const RedrawPolicy::Stats before = RedrawPolicy::GetStats(s_now);
+        const int frames = Run(window, s_now + MINUTE_MS);
+        const RedrawPolicy::Stats after = RedrawPolicy::GetStats(s_now);
+
+        CHECK(frames == 0);
+        CHECK(after.idleMs == before.idleMs);
+
+        window.visible = true;
+        window.animationDelayMs = -1;
+        CHECK(Run(window, s_now + 100) > 0);
+        CHECK(RedrawPolicy::GetStats(s_now).idleMs == after.idleMs);
+    }
+}
+
+int main()
+{
+    TestIdleMinute();
+    TestIdleMinuteWithCaret();
+    TestCounterSeesEveryVsync();
+    TestInputIsNotIdle();
+    TestHiddenMinute();
+    return Check::Result();
+}